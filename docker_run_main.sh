@@ -4,8 +4,8 @@
 
 set -e
 
-if [[ $# -ne 6 ]] ; then
-    echo "Usage: docker_run_main.sh <inputDir> <obsId> <startTime> <invPolyphaseFilterFile> <outputDir> <ignoreErrors>"
+if [[ $# -lt 6 ]] ; then
+    echo "Usage: docker_run_main.sh <inputDir> <obsId> <startTime> <invPolyphaseFilterFile> <outputDir> <ignoreErrors> [options...]"
     exit 1
 fi
 
@@ -15,6 +15,8 @@ startTime=$3
 hostInvPolyphaseFilterFile=$(realpath -m $4)
 hostOutputDir=$(realpath -m $5)
 ignoreErrors=$6
+# Any further arguments are optional arguments, passed through as they are
+shift 6
 
 containerInputDir="/mnt/input_data"
 containerInvPolyphaseFilterFile="/mnt/inverse_polyphase_filter"
@@ -25,4 +27,4 @@ exec docker run \
     -v "$hostInvPolyphaseFilterFile:$containerInvPolyphaseFilterFile:ro" \
     -v "$hostOutputDir:$containerOutputDir:rw" \
     -t "mwatdr/main" \
-    "$containerInputDir" "$obsId" "$startTime" "$containerInvPolyphaseFilterFile" "$containerOutputDir" "$ignoreErrors"
+    "$containerInputDir" "$obsId" "$startTime" "$containerInvPolyphaseFilterFile" "$containerOutputDir" "$ignoreErrors" "$@"
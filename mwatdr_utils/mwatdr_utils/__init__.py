@@ -2,4 +2,5 @@
 
 
 from .inv_polyphase_filter import *
+from .output_container import *
 from .output_signal import *
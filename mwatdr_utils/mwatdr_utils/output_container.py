@@ -0,0 +1,129 @@
+"""Utilities for reading output container files, which hold the time domain signals of every antenna input of an
+    observation in one file (written with `--output-format=container`)."""
+
+
+from os import fspath, PathLike
+import struct
+from typing import Dict, List, NamedTuple, Tuple
+
+import numpy
+
+
+__all__ = [
+    'make_output_container_filename',
+    'OUTPUT_CONTAINER_FILENAME_REGEX',
+    'OutputContainer',
+    'OutputContainerFileParseError',
+    'OutputContainerInput',
+    'read_output_container'
+]
+
+
+OUTPUT_CONTAINER_FILENAME_REGEX = r'([0-9]+)_([0-9]+)\.tdr'
+"""Regex matching an output container filename."""
+
+_MAGIC = b'MWATDRC\0'
+_VERSION = 1
+# Magic, version, sampling frequency, observation ID, start time, number of samples, number of antenna inputs,
+# reserved, offset of first signal, reserved.
+_HEADER_FORMAT = '<8sIIQQQIIQQ'
+_HEADER_SIZE = struct.calcsize(_HEADER_FORMAT)
+# Tile ID, signal chain, flagged, written, reserved, offset of signal.
+_ENTRY_FORMAT = '<IcBBBQ'
+_ENTRY_SIZE = struct.calcsize(_ENTRY_FORMAT)
+
+
+class OutputContainerInput(NamedTuple):
+    """Entry of an output container's antenna input table."""
+
+    tile_id: int
+    """Physical ID of the tile."""
+    signal_chain: str
+    """Character representing the RF input (typically 'X' or 'Y')."""
+    flagged: bool
+    """Whether the antenna input is flagged (and so has no signal)."""
+    written: bool
+    """Whether the antenna input's signal was processed and written successfully."""
+    offset: int
+    """Offset of the signal from the start of the file, 0 if flagged."""
+
+
+class OutputContainer(NamedTuple):
+    """Contents of an output container file."""
+
+    sampling_freq: int
+    """Sampling frequency of the signals, as a multiple of the channel bandwidth."""
+    observation_id: int
+    """ID (GPS time) of the observation."""
+    start_time: int
+    """GPS time of the start of the signals."""
+    num_samples: int
+    """Number of samples in each signal."""
+    antenna_inputs: List[OutputContainerInput]
+    """The antenna input table, in the order of the metadata file."""
+    signals: Dict[Tuple[int, str], numpy.ndarray]
+    """The signal of each written antenna input, keyed by (tile ID, signal chain). Each is a 1D array of 16-bit signed
+        integer real numbers, memory mapped from the file."""
+
+
+def make_output_container_filename(observation_id: int, start_time: int) -> str:
+    """Forms an output container filename.
+
+        :param observation_id: ID (GPS time) of the observation.
+        :param start_time: GPS time of the start of the signals.
+        :return: The name of the corresponding output container file.
+    """
+
+    return f'{observation_id}_{start_time}.tdr'
+
+
+def read_output_container(path: PathLike) -> OutputContainer:
+    """Reads an output container from file.
+
+        :param path: Path of the file to read.
+        :return: The output container's header, antenna input table and signals. The signals are memory mapped rather
+            than read into memory.
+        :except OSError: If the file could not be opened/read.
+        :except OutputContainerFileParseError: If the file has invalid format.
+    """
+
+    with open(path, 'rb') as file:
+        header = file.read(_HEADER_SIZE)
+        if len(header) != _HEADER_SIZE:
+            raise OutputContainerFileParseError('File is too short for the header')
+        magic, version, sampling_freq, observation_id, start_time, num_samples, num_inputs, _, data_offset, _ = \
+            struct.unpack(_HEADER_FORMAT, header)
+        if magic != _MAGIC:
+            raise OutputContainerFileParseError('File is not an output container')
+        if version != _VERSION:
+            raise OutputContainerFileParseError(f'Unsupported output container version {version}')
+
+        table = file.read(num_inputs * _ENTRY_SIZE)
+        if len(table) != num_inputs * _ENTRY_SIZE:
+            raise OutputContainerFileParseError('File is too short for the antenna input table')
+        file.seek(0, 2)
+        file_size = file.tell()
+
+    antenna_inputs = []
+    for tile_id, signal_chain, flagged, written, _, offset in struct.iter_unpack(_ENTRY_FORMAT, table):
+        antenna_input = OutputContainerInput(tile_id, signal_chain.decode('ascii'), flagged != 0, written != 0, offset)
+        if not antenna_input.flagged and (offset < data_offset or offset + num_samples * 2 > file_size):
+            raise OutputContainerFileParseError('Antenna input signal is outside the file')
+        antenna_inputs.append(antenna_input)
+
+    signals = {}
+    for antenna_input in antenna_inputs:
+        if antenna_input.written:
+            key = (antenna_input.tile_id, antenna_input.signal_chain)
+            # An empty file region can't be memory mapped
+            if num_samples == 0:
+                signals[key] = numpy.zeros((0,), dtype='<i2')
+            else:
+                signals[key] = numpy.memmap(fspath(path), dtype='<i2', mode='r', offset=antenna_input.offset,
+                                            shape=(num_samples,))
+
+    return OutputContainer(sampling_freq, observation_id, start_time, num_samples, antenna_inputs, signals)
+
+
+class OutputContainerFileParseError(Exception):
+    """Raised when an output container file cannot be parsed due to invalid format."""
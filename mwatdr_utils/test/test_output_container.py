@@ -0,0 +1,144 @@
+"""Unit tests for mwatdr_utils.output_container module."""
+
+
+import re
+import struct
+
+import numpy
+import pytest
+
+from helpers import compute_file_key
+from mwatdr_utils.output_container import make_output_container_filename, OUTPUT_CONTAINER_FILENAME_REGEX, \
+    OutputContainerFileParseError, OutputContainerInput, read_output_container
+
+
+def write_test_container(path, num_samples: int, entries, signals) -> None:
+    """Writes an output container laid out as the application does, with signals in 4096 byte aligned slots.
+
+        :param entries: (tile ID, signal chain, flagged, written) of each antenna input.
+        :param signals: Signal of each unflagged antenna input, in order.
+    """
+
+    data_offset = 4096
+    slot_size = -(-num_samples * 2 // 4096) * 4096
+    offsets = []
+    offset = data_offset
+    for _, _, flagged, _ in entries:
+        offsets.append(0 if flagged else offset)
+        if not flagged:
+            offset += slot_size
+
+    with open(path, 'wb') as file:
+        file.write(struct.pack('<8sIIQQQIIQQ', b'MWATDRC\0', 1, 230, 1234567890, 1234567898, num_samples, len(entries),
+                               0, data_offset, 0))
+        for (tile_id, signal_chain, flagged, written), entry_offset in zip(entries, offsets):
+            file.write(struct.pack('<IcBBBQ', tile_id, signal_chain.encode('ascii'), flagged, written, 0, entry_offset))
+        signal_offsets = [entry_offset for entry_offset in offsets if entry_offset != 0]
+        for signal, signal_offset in zip(signals, signal_offsets):
+            file.seek(signal_offset)
+            file.write(numpy.asarray(signal, dtype='<i2').tobytes())
+        file.truncate(offset)
+
+
+
+def test_filename_regex() -> None:
+    match = re.fullmatch(OUTPUT_CONTAINER_FILENAME_REGEX, '76452354_5463092.tdr')
+    assert match is not None
+    assert match.groups() == ('76452354', '5463092')
+
+    match = re.fullmatch(OUTPUT_CONTAINER_FILENAME_REGEX, '76452354_5463092_12_Y.bin')
+    assert match is None
+
+
+
+def test_make_filename() -> None:
+    actual = make_output_container_filename(356723454, 356723568)
+    expected = '356723454_356723568.tdr'
+    assert actual == expected
+
+
+
+
+class TestReadOutputContainer:
+    """Tests for read_output_container()"""
+
+    @staticmethod
+    def test_valid(tmpdir) -> None:
+        path = tmpdir / 'output_container_valid.tdr'
+
+        entries = [(11, 'X', False, True), (11, 'Y', False, False), (12, 'X', True, False), (12, 'Y', False, True)]
+        signal_11x = [((7 * i) % 3000) - 1500 for i in range(5000)]
+        signal_12y = [((3 * i) % 1000) - 20000 for i in range(5000)]
+        write_test_container(path, 5000, entries, [signal_11x, [0] * 5000, signal_12y])
+
+        file_key_before = compute_file_key(path)
+        container = read_output_container(path)
+
+        assert container.sampling_freq == 230
+        assert container.observation_id == 1234567890
+        assert container.start_time == 1234567898
+        assert container.num_samples == 5000
+        assert container.antenna_inputs == [
+            OutputContainerInput(11, 'X', False, True, 4096),
+            OutputContainerInput(11, 'Y', False, False, 4096 + 12288),
+            OutputContainerInput(12, 'X', True, False, 0),
+            OutputContainerInput(12, 'Y', False, True, 4096 + 2 * 12288)
+        ]
+        # Only written antenna inputs have signals
+        assert set(container.signals.keys()) == {(11, 'X'), (12, 'Y')}
+        assert container.signals[(11, 'X')].shape == (5000,)
+        assert container.signals[(11, 'X')].dtype == numpy.int16
+        assert list(container.signals[(11, 'X')]) == signal_11x
+        assert list(container.signals[(12, 'Y')]) == signal_12y
+
+        del container
+        file_key_after = compute_file_key(path)
+        assert file_key_before == file_key_after
+
+
+    @staticmethod
+    def test_no_samples(tmpdir) -> None:
+        path = tmpdir / 'output_container_empty.tdr'
+
+        write_test_container(path, 0, [(11, 'X', False, True)], [[]])
+
+        container = read_output_container(path)
+        assert container.num_samples == 0
+        assert container.signals[(11, 'X')].shape == (0,)
+
+
+    @staticmethod
+    def test_invalid_magic(tmpdir) -> None:
+        path = tmpdir / 'output_container_invalid.tdr'
+
+        with open(path, 'wb') as file:
+            file.write(b'\x3141' * 1234)
+
+        with pytest.raises(OutputContainerFileParseError):
+            read_output_container(path)
+
+
+    @staticmethod
+    def test_truncated(tmpdir) -> None:
+        path = tmpdir / 'output_container_truncated.tdr'
+
+        write_test_container(path, 5000, [(11, 'X', False, True), (11, 'Y', False, True)], [[1] * 5000, [2] * 5000])
+        with open(path, 'r+b') as file:
+            file.truncate(4096 + 12288)
+
+        with pytest.raises(OutputContainerFileParseError):
+            read_output_container(path)
+
+        with open(path, 'r+b') as file:
+            file.truncate(100)
+
+        with pytest.raises(OutputContainerFileParseError):
+            read_output_container(path)
+
+
+    @staticmethod
+    def test_nonexistent_file(tmpdir) -> None:
+        path = tmpdir / 'output_container_nonexistent.tdr'
+
+        with pytest.raises(OSError):
+            read_output_container(path)
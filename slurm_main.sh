@@ -11,8 +11,8 @@
 
 module load singularity-openmpi
 
-if [[ $# -ne 6 ]] ; then
-    echo "Usage: sbatch slurm_main.sh <inputDir> <obsId> <startTime> <invPolyphaseFilterFile> <outputDir> <ignoreErrors>"
+if [[ $# -lt 6 ]] ; then
+    echo "Usage: sbatch slurm_main.sh <inputDir> <obsId> <startTime> <invPolyphaseFilterFile> <outputDir> <ignoreErrors> [options...]"
     exit 1
 fi
 
@@ -25,6 +25,8 @@ export startTime=$3
 export hostInvPolyphaseFilterFile=$(realpath -m $4)
 export hostOutputDir=$(realpath -m $5)
 export ignoreErrors=$6
+# Any further arguments are optional arguments, passed through as they are
+shift 6
 
 export containerInputDir=/mnt/input_data
 export containerInvPolyphaseFilterFile=/mnt/inverse_polyphase_filter
@@ -32,4 +34,4 @@ export containerOutputDir=/mnt/output_data
 
 srun --export=all -n $SLURM_NTASKS  singularity exec --pwd=/app \
      --bind $hostInputDir:$containerInputDir:ro,$hostOutputDir:$containerOutputDir:rw,$hostInvPolyphaseFilterFile:$containerInvPolyphaseFilterFile:ro \
-    $containerImage $ROOT/app/entrypoint.sh $containerInputDir $obsId $startTime $containerInvPolyphaseFilterFile $containerOutputDir $ignoreErrors
+    $containerImage $ROOT/app/entrypoint.sh $containerInputDir $obsId $startTime $containerInvPolyphaseFilterFile $containerOutputDir $ignoreErrors "$@"
@@ -0,0 +1,272 @@
+#include "AntennaInputReader.hpp"
+
+#include "ReadInputFile.hpp"
+#include "StageTiming.hpp"
+#include "SubfileIndex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <tbb/task_group.h>
+
+
+std::filesystem::path getSignalFilePath(AppConfig const& appConfig, unsigned channel) {
+    std::filesystem::path const directory{appConfig.inputDirectoryPath};
+    std::filesystem::path const fileName = std::to_string(appConfig.observationID) + "_" +
+                                           std::to_string(appConfig.signalStartTime) + "_" +
+                                           std::to_string(channel) + ".sub";
+    return directory / fileName;
+}
+
+AntennaInputBatch readAntennaInputBatch(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                        AntennaInputRange const& batch) {
+    StageTimer const timer;
+    AntennaInputBatch result{batch, std::vector<AntennaInputSamples>(batch.end - batch.begin + 1), {}};
+
+    // Only read the antenna inputs between the first and last unflagged ones
+    AntennaInputRange readRange = batch;
+    while (readRange.begin < readRange.end && antennaConfig.antennaInputs.at(readRange.begin).flagged) {
+        readRange.begin++;
+    }
+    while (readRange.end > readRange.begin && antennaConfig.antennaInputs.at(readRange.end).flagged) {
+        readRange.end--;
+    }
+    if (antennaConfig.antennaInputs.at(readRange.begin).flagged) {
+        // Nothing to read
+        return result;
+    }
+
+    // Channels are read concurrently, each task opening its own view of its signal file. The results are put into
+    // pre-sized slots so channels are added in order regardless of which read finishes first.
+    std::vector<unsigned> const channels(antennaConfig.frequencyChannels.begin(), antennaConfig.frequencyChannels.end());
+    std::vector<std::optional<std::vector<std::vector<std::int8_t>>>> channelSignals(channels.size());
+    tbb::task_group readTasks;
+    for (std::size_t c = 0; c < channels.size(); c++) {
+        readTasks.run([&appConfig, &antennaConfig, &readRange, &channels, &channelSignals, c]() {
+            try {
+                // Kept as raw 8 bit samples until processing, a quarter of the size of complex floats
+                channelSignals[c] = readRawInputDataFile(getSignalFilePath(appConfig, channels[c]), readRange,
+                                                         antennaConfig.antennaInputs.size());
+            }
+            catch (ReadInputDataException const&) {
+                // Slot is left empty, handled below
+            }
+        });
+    }
+    readTasks.wait();
+
+    for (std::size_t c = 0; c < channels.size(); c++) {
+        if (!channelSignals[c].has_value()) {
+            if (!appConfig.ignoreErrors) {
+                auto const signalFile = getSignalFilePath(appConfig, channels[c]);
+                throw ReadInputDataException("Error occurred reading: " + signalFile.string());
+            }
+            continue;
+        }
+        auto& signals = channelSignals[c].value();
+        for (std::size_t i = 0; i < signals.size(); i++) {
+            result.signals.at(readRange.begin - batch.begin + i).addChannel(std::move(signals.at(i)));
+        }
+        // Free this channel's (now empty) buffers straight away
+        channelSignals[c].reset();
+        result.usedChannels.insert(channels[c]);
+    }
+    result.readSeconds = timer.getElapsedSeconds();
+    return result;
+}
+
+std::size_t getAntennaInputRawSize(AppConfig const& appConfig, AntennaConfig const& antennaConfig) {
+    for (auto const channel : antennaConfig.frequencyChannels) {
+        try {
+            auto const index = getSubfileIndex(getSignalFilePath(appConfig, channel));
+            // Interleaved 8 bit real and imaginary values, for every data block of every channel
+            return antennaConfig.frequencyChannels.size() * index->getNumBlocks() * index->getNumSamples() * 2;
+        }
+        catch (ReadInputDataException const&) {
+            // Try the next channel, reading errors are reported when the antenna inputs are read
+        }
+    }
+    return 0;
+}
+
+ReadAheadPlan planReadAhead(std::size_t memoryBudget, std::size_t antennaInputSize, unsigned maxPrefetchDepth,
+                            unsigned maxBatchSize, unsigned minBatchSize) {
+    maxBatchSize = std::max(maxBatchSize, 1u);
+    minBatchSize = std::clamp(minBatchSize, 1u, maxBatchSize);
+    if (antennaInputSize == 0) {
+        return {maxBatchSize, maxPrefetchDepth};
+    }
+
+    auto const budgetInputs = std::max<std::size_t>(memoryBudget / antennaInputSize, 1);
+    // The batch being processed and each batch read ahead need at least minBatchSize antenna inputs
+    unsigned prefetchDepth = maxPrefetchDepth;
+    while (prefetchDepth > 0 && budgetInputs < static_cast<std::size_t>(prefetchDepth + 1) * minBatchSize) {
+        prefetchDepth--;
+    }
+    auto const batchSize = std::clamp<std::size_t>(budgetInputs / (prefetchDepth + 1), minBatchSize, maxBatchSize);
+    return {static_cast<unsigned>(batchSize), prefetchDepth};
+}
+
+ReadAheadPlan planReadAhead(AppConfig const& appConfig, AntennaConfig const& antennaConfig, unsigned maxBatchSize) {
+    std::size_t const memoryBudget = static_cast<std::size_t>(appConfig.memoryBudget) * 1024 * 1024;
+    return planReadAhead(memoryBudget, getAntennaInputRawSize(appConfig, antennaConfig), appConfig.prefetchDepth,
+                         maxBatchSize, appConfig.inputBatchSize);
+}
+
+std::vector<AntennaInputRange> splitAntennaInputRange(AntennaInputRange const& range, unsigned maxBatchSize) {
+    std::vector<AntennaInputRange> batches;
+    for (unsigned begin = range.begin; begin <= range.end; begin += maxBatchSize) {
+        batches.push_back({begin, std::min(begin + maxBatchSize - 1, range.end)});
+    }
+    return batches;
+}
+
+AntennaInputBatch takeAntennaInputBatch(AntennaInputBatch& batch, AntennaInputRange const& range) {
+    if (range.begin > range.end || range.begin < batch.antennaInputs.begin || range.end > batch.antennaInputs.end) {
+        throw std::out_of_range{"Antenna input range is outside of the batch"};
+    }
+
+    auto const numRead = std::count_if(batch.signals.begin(), batch.signals.end(),
+                                       [](AntennaInputSamples const& signals) { return !signals.empty(); });
+    AntennaInputBatch result{range, std::vector<AntennaInputSamples>(range.end - range.begin + 1), batch.usedChannels};
+    std::size_t numTaken = 0;
+    for (unsigned i = range.begin; i <= range.end; i++) {
+        auto& signals = batch.signals.at(i - batch.antennaInputs.begin);
+        if (!signals.empty()) {
+            numTaken++;
+        }
+        result.signals.at(i - range.begin) = std::exchange(signals, AntennaInputSamples{});
+    }
+    result.readSeconds = numRead > 0 ? batch.readSeconds * numTaken / numRead : 0.0;
+    return result;
+}
+
+
+AntennaInputPrefetcher::AntennaInputPrefetcher(BatchSource nextBatch, BatchReader readBatch, unsigned prefetchDepth) :
+    _nextBatch{std::move(nextBatch)},
+    _readBatch{std::move(readBatch)},
+    _prefetchDepth{prefetchDepth},
+    _mutex{},
+    _condition{},
+    _readyBatches{},
+    _numRequested{0},
+    _numRead{0},
+    _finished{false},
+    _stopping{false},
+    _ioThread{&AntennaInputPrefetcher::_readBatches, this}
+{}
+
+AntennaInputPrefetcher::AntennaInputPrefetcher(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                               BatchSource nextBatch, unsigned prefetchDepth) :
+    AntennaInputPrefetcher{std::move(nextBatch),
+        [&appConfig, &antennaConfig](AntennaInputRange const& batch) {
+            return readAntennaInputBatch(appConfig, antennaConfig, batch);
+        },
+        prefetchDepth}
+{}
+
+AntennaInputPrefetcher::AntennaInputPrefetcher(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                               std::vector<AntennaInputRange> batches, unsigned prefetchDepth) :
+    AntennaInputPrefetcher{appConfig, antennaConfig,
+        [batches = std::move(batches), nextIndex = std::size_t{0}]() mutable -> std::optional<AntennaInputRange> {
+            if (nextIndex < batches.size()) {
+                return batches[nextIndex++];
+            }
+            return std::nullopt;
+        },
+        prefetchDepth}
+{}
+
+AntennaInputPrefetcher::~AntennaInputPrefetcher() {
+    {
+        std::lock_guard<std::mutex> const lock{_mutex};
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _ioThread.join();
+}
+
+std::optional<AntennaInputBatch> AntennaInputPrefetcher::next() {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _numRequested++;
+    _condition.notify_all();
+    _condition.wait(lock, [this]() { return !_readyBatches.empty() || _finished; });
+    if (_readyBatches.empty()) {
+        return std::nullopt;
+    }
+
+    auto result = std::move(_readyBatches.front());
+    _readyBatches.pop_front();
+    lock.unlock();
+    // Let the I/O thread know it can read another batch
+    _condition.notify_all();
+
+    if (auto const exception = std::get_if<std::exception_ptr>(&result)) {
+        std::rethrow_exception(*exception);
+    }
+    return std::get<AntennaInputBatch>(std::move(result));
+}
+
+void AntennaInputPrefetcher::_readBatches() {
+    while (true) {
+        {
+            // Wait until the batch is needed, either by next() or to stay prefetchDepth batches ahead of it
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [this]() { return _stopping || _numRead < _numRequested + _prefetchDepth; });
+            if (_stopping) {
+                return;
+            }
+        }
+
+        // Read without holding the lock so next() can return the batches already read
+        std::optional<std::variant<AntennaInputBatch, std::exception_ptr>> result;
+        try {
+            auto const batch = _nextBatch();
+            if (batch.has_value()) {
+                result = _readBatch(batch.value());
+            }
+        }
+        catch (...) {
+            result = std::current_exception();
+        }
+
+        bool const finished = !result.has_value() || std::holds_alternative<std::exception_ptr>(result.value());
+        {
+            std::lock_guard<std::mutex> const lock{_mutex};
+            if (result.has_value()) {
+                _readyBatches.push_back(std::move(result.value()));
+                _numRead++;
+            }
+            _finished = finished;
+        }
+        _condition.notify_all();
+        if (finished) {
+            return;
+        }
+    }
+}
+
+
+AntennaInputPrefetcher::BatchSource splitAntennaInputChunks(AntennaInputPrefetcher::BatchSource nextChunk,
+                                                            unsigned maxBatchSize) {
+    return [nextChunk = std::move(nextChunk), maxBatchSize,
+            batches = std::deque<AntennaInputRange>{}]() mutable -> std::optional<AntennaInputRange> {
+        // Only ask for the next chunk once the batches of the last one have all been read
+        if (batches.empty()) {
+            if (auto const chunk = nextChunk()) {
+                auto const chunkBatches = splitAntennaInputRange(chunk.value(), maxBatchSize);
+                batches.assign(chunkBatches.begin(), chunkBatches.end());
+            }
+            else {
+                return std::nullopt;
+            }
+        }
+        auto const batch = batches.front();
+        batches.pop_front();
+        return batch;
+    };
+}
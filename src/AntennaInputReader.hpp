@@ -0,0 +1,145 @@
+#pragma once
+
+#include "AntennaInputSamples.hpp"
+#include "Common.hpp"
+#include "NodeAntennaInputAssigner.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <variant>
+#include <vector>
+
+
+// Raw signals of a batch of consecutive antenna inputs, read from the signal files of all channels.
+struct AntennaInputBatch {
+    // The antenna inputs in the batch.
+    AntennaInputRange antennaInputs;
+    // Raw signals of each antenna input in the batch, first element is antennaInputs.begin.
+    // Antenna inputs which weren't read (flagged, or no channels could be read) have no channels.
+    std::vector<AntennaInputSamples> signals;
+    // Channels which were successfully read.
+    std::set<unsigned> usedChannels;
+    // Wall time spent reading the batch, in seconds.
+    double readSeconds = 0.0;
+};
+
+
+// How antenna inputs are read ahead of signal processing.
+struct ReadAheadPlan {
+    // Number of antenna inputs read together in each batch.
+    unsigned batchSize;
+    // Number of batches which may be read ahead of the batch being processed.
+    unsigned prefetchDepth;
+};
+
+
+// Gets the path of the signal file of a frequency channel.
+std::filesystem::path getSignalFilePath(AppConfig const& appConfig, unsigned channel);
+
+// Reads the raw signals of every antenna input in the batch, from all channels.
+// Each channel's signal file is read once for the whole batch, and the channels are read concurrently.
+// Flagged antenna inputs at either end of the batch aren't read, since they are never processed.
+// Throws ReadInputDataException if a signal file can't be read, unless appConfig.ignoreErrors is set (in which case
+// the channel is left out of usedChannels).
+AntennaInputBatch readAntennaInputBatch(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                        AntennaInputRange const& batch);
+
+// Gets the number of bytes of raw signal data for one antenna input over all channels, based on the first signal file
+// which can be indexed. Returns 0 if no signal file can be indexed.
+std::size_t getAntennaInputRawSize(AppConfig const& appConfig, AntennaConfig const& antennaConfig);
+
+// Works out the largest batches (up to maxBatchSize) and prefetch depth (up to maxPrefetchDepth) for which the batch
+// being processed and the batches read ahead all fit in memoryBudget bytes. Each signal file is read once per batch, so
+// maxBatchSize is usually all of a node's antenna inputs. A deeper prefetch is preferred over larger batches, but
+// batches are never smaller than minBatchSize (or maxBatchSize if that's smaller), even if they don't fit.
+// If antennaInputSize is 0 (unknown), the budget isn't applied.
+ReadAheadPlan planReadAhead(std::size_t memoryBudget, std::size_t antennaInputSize, unsigned maxPrefetchDepth,
+                            unsigned maxBatchSize, unsigned minBatchSize = 1);
+
+// As above, using the memory budget, prefetch depth and input batch size (as the smallest batch) from the app
+// configuration.
+ReadAheadPlan planReadAhead(AppConfig const& appConfig, AntennaConfig const& antennaConfig, unsigned maxBatchSize);
+
+// Splits a node's antenna input range into consecutive batches of at most maxBatchSize antenna inputs.
+std::vector<AntennaInputRange> splitAntennaInputRange(AntennaInputRange const& range, unsigned maxBatchSize);
+
+// Moves the raw signals of a range of antenna inputs out of a larger batch (e.g. all of a node's antenna inputs, read
+// at once) into a batch of their own, leaving them empty in the larger batch. The read time of the larger batch is
+// shared between the antenna inputs which were read.
+// Throws std::out_of_range if the range isn't within the larger batch.
+AntennaInputBatch takeAntennaInputBatch(AntennaInputBatch& batch, AntennaInputRange const& range);
+
+
+// Reads batches of antenna inputs on a background I/O thread, so the next batches are read while the current one is
+// processed. Batches are read one at a time, in order, and at most prefetchDepth batches are held in memory besides
+// the one most recently returned by next().
+class AntennaInputPrefetcher {
+public:
+    // Gets the next batch of antenna inputs to read, or an empty optional once there are none left.
+    // Only ever called from the I/O thread.
+    using BatchSource = std::function<std::optional<AntennaInputRange>()>;
+    // Gets the raw signals of a batch of antenna inputs, e.g. by reading them with readAntennaInputBatch().
+    // Only ever called from the I/O thread.
+    using BatchReader = std::function<AntennaInputBatch(AntennaInputRange const&)>;
+
+    // Starts the I/O thread, getting the batches given by nextBatch with readBatch.
+    AntennaInputPrefetcher(BatchSource nextBatch, BatchReader readBatch, unsigned prefetchDepth);
+    // Starts the I/O thread, reading the batches given by nextBatch with readAntennaInputBatch().
+    // The app and antenna configurations must outlive this object.
+    AntennaInputPrefetcher(AppConfig const& appConfig, AntennaConfig const& antennaConfig, BatchSource nextBatch,
+                           unsigned prefetchDepth);
+    // As above, reading a fixed list of batches.
+    AntennaInputPrefetcher(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                           std::vector<AntennaInputRange> batches, unsigned prefetchDepth);
+    AntennaInputPrefetcher(AntennaInputPrefetcher const&) = delete;
+    AntennaInputPrefetcher(AntennaInputPrefetcher&&) = delete;
+
+    // Stops the I/O thread, waiting for the batch being read (if any) to finish.
+    ~AntennaInputPrefetcher();
+
+    // Gets the next batch, waiting for it to be read if it hasn't been already.
+    // Returns an empty optional once all batches have been returned.
+    // Throws whatever exception reading the batch threw (usually ReadInputDataException). No more batches are read
+    // after an exception.
+    std::optional<AntennaInputBatch> next();
+
+    AntennaInputPrefetcher& operator=(AntennaInputPrefetcher const&) = delete;
+    AntennaInputPrefetcher& operator=(AntennaInputPrefetcher&&) = delete;
+
+private:
+    // Run by the I/O thread.
+    void _readBatches();
+
+    BatchSource _nextBatch;
+    BatchReader _readBatch;
+    unsigned const _prefetchDepth;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    // Batches read but not yet returned by next(), or the exception thrown reading a batch.
+    std::deque<std::variant<AntennaInputBatch, std::exception_ptr>> _readyBatches;
+    // Number of calls to next() so far.
+    std::size_t _numRequested;
+    // Number of batches read (or failed) by the I/O thread so far.
+    std::size_t _numRead;
+    // Set once the I/O thread has no more batches to read.
+    bool _finished;
+    // Set to stop the I/O thread early.
+    bool _stopping;
+    // Declared last so the thread is started after everything it uses is initialised.
+    std::thread _ioThread;
+};
+
+
+// Gets the chunks of antenna inputs given by nextChunk (e.g. handed out by an AntennaInputScheduler) one after another,
+// each split into consecutive batches of at most maxBatchSize antenna inputs.
+AntennaInputPrefetcher::BatchSource splitAntennaInputChunks(AntennaInputPrefetcher::BatchSource nextChunk,
+                                                            unsigned maxBatchSize);
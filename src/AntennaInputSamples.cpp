@@ -0,0 +1,54 @@
+#include "AntennaInputSamples.hpp"
+
+#include "SampleConversion.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+void AntennaInputSamples::addChannel(std::vector<std::int8_t> rawSamples) {
+    if (rawSamples.size() % 2 != 0) {
+        throw std::invalid_argument{"Raw samples must be pairs of real and imaginary values"};
+    }
+    if (!_channels.empty() && rawSamples.size() != _numSamples * 2) {
+        throw std::invalid_argument{"Channels must all have the same number of samples"};
+    }
+    _numSamples = rawSamples.size() / 2;
+    _channels.push_back(std::move(rawSamples));
+}
+
+std::size_t AntennaInputSamples::getNumChannels() const {
+    return _channels.size();
+}
+
+std::size_t AntennaInputSamples::getNumSamples() const {
+    return _numSamples;
+}
+
+bool AntennaInputSamples::empty() const {
+    return _channels.empty();
+}
+
+RawSampleSpan AntennaInputSamples::getChannel(std::size_t channel) const {
+    auto const& rawSamples = _channels.at(channel);
+    return {rawSamples.data(), rawSamples.size()};
+}
+
+void AntennaInputSamples::convert(std::size_t channel, std::size_t begin, std::size_t count,
+                                  std::complex<float>* output, std::size_t outputStride) const {
+    convert(channel, begin, count, output, outputStride, 1.0f, false);
+}
+
+void AntennaInputSamples::convert(std::size_t channel, std::size_t begin, std::size_t count,
+                                  std::complex<float>* output, std::size_t outputStride, float scale,
+                                  bool conjugate) const {
+    auto const& rawSamples = _channels.at(channel);
+    if (begin > _numSamples || count > _numSamples - begin) {
+        throw std::out_of_range{"Samples outside of the channel"};
+    }
+    convertSamples(rawSamples.data() + begin * 2, count, output, outputStride, scale, conjugate);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "SubfileView.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// The raw signal samples of one antenna input, for each frequency channel read.
+// Samples are kept as read from the signal files (interleaved pairs of 8-bit signed integers), which is a quarter of
+// the memory of std::complex<float>. They are converted to floating point only as signal processing consumes them.
+class AntennaInputSamples {
+public:
+    // Creates an instance with no channels.
+    AntennaInputSamples() = default;
+
+    // Adds the raw samples of the next channel. All channels must have the same number of samples.
+    // Throws std::invalid_argument if the size is odd or differs from the previous channels.
+    void addChannel(std::vector<std::int8_t> rawSamples);
+
+    // Number of channels added.
+    std::size_t getNumChannels() const;
+    // Number of complex samples in each channel.
+    std::size_t getNumSamples() const;
+    // Checks if no channels have been added.
+    bool empty() const;
+
+    // Gets the raw samples of a channel. Throws std::out_of_range if the channel doesn't exist.
+    RawSampleSpan getChannel(std::size_t channel) const;
+
+    // Converts count samples of a channel, starting from sample begin, to complex floats.
+    // Sample i is written to output[i * outputStride], as with convertSamples().
+    // Throws std::out_of_range if the channel doesn't exist or the samples are outside of it.
+    void convert(std::size_t channel, std::size_t begin, std::size_t count, std::complex<float>* output,
+                 std::size_t outputStride = 1) const;
+    // As above, also scaling and optionally conjugating each sample as it's converted (see convertSamples()).
+    void convert(std::size_t channel, std::size_t begin, std::size_t count, std::complex<float>* output,
+                 std::size_t outputStride, float scale, bool conjugate) const;
+
+private:
+    std::vector<std::vector<std::int8_t>> _channels;
+    std::size_t _numSamples = 0;
+};
@@ -0,0 +1,317 @@
+#include "ChannelDecomposition.hpp"
+
+#include "InternodeCommunication.hpp"
+#include "ReadInputFile.hpp"
+#include "StageTiming.hpp"
+#include "SubfileIndex.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+
+std::vector<std::set<unsigned>> assignNodeChannels(unsigned numNodes, std::set<unsigned> const& channels) {
+    if (numNodes == 0) {
+        throw std::invalid_argument{"numNodes must be > 0"};
+    }
+
+    std::vector<std::set<unsigned>> nodeChannels(numNodes);
+    if (channels.empty()) {
+        return nodeChannels;
+    }
+    // Channels are split the same way as antenna inputs, by their position in ascending order
+    std::vector<unsigned> const sortedChannels(channels.begin(), channels.end());
+    auto const ranges = assignNodeAntennaInputs(numNodes, sortedChannels.size());
+    for (unsigned node = 0; node < numNodes; node++) {
+        if (ranges.at(node).has_value()) {
+            auto const range = ranges.at(node).value();
+            nodeChannels.at(node).insert(sortedChannels.begin() + range.begin, sortedChannels.begin() + range.end + 1);
+        }
+    }
+    return nodeChannels;
+}
+
+ChannelExchangeChunk packChannelChunk(std::vector<SubfileView const*> const& views, unsigned beginBlock,
+                                      unsigned endBlock,
+                                      std::vector<std::optional<AntennaInputRange>> const& nodeAntennaInputs) {
+    ChannelExchangeChunk chunk{{}, std::vector<std::size_t>(nodeAntennaInputs.size(), 0)};
+    if (views.empty() || beginBlock >= endBlock) {
+        return chunk;
+    }
+
+    auto const numBlocks = endBlock - beginBlock;
+    // Each raw sample is 2 bytes
+    std::size_t const blockSampleBytes = views.front()->getNumSamples() * 2;
+    std::vector<std::size_t> nodeOffsets;
+    std::size_t totalSize = 0;
+    for (std::size_t node = 0; node < nodeAntennaInputs.size(); node++) {
+        nodeOffsets.push_back(totalSize);
+        if (nodeAntennaInputs[node].has_value()) {
+            auto const& range = nodeAntennaInputs[node].value();
+            chunk.nodeSizes[node] = views.size() * numBlocks * (range.end - range.begin + 1) * blockSampleBytes;
+            totalSize += chunk.nodeSizes[node];
+        }
+    }
+    chunk.data.resize(totalSize);
+
+    // Each file is read from start to end, a block at a time, with each node's antenna inputs copied to its own part
+    // of the buffer. The next block is read in by the OS while the current one is copied. Only the nodes' antenna
+    // inputs are read in, since the rest of each block may be read for another group of antenna inputs.
+    auto const advise = [&nodeAntennaInputs](SubfileView const& view, unsigned block, bool willNeed) {
+        for (auto const& range : nodeAntennaInputs) {
+            if (range.has_value()) {
+                if (willNeed) {
+                    view.adviseWillNeed(block, range.value());
+                }
+                else {
+                    view.adviseDontNeed(block, range.value());
+                }
+            }
+        }
+    };
+    for (std::size_t c = 0; c < views.size(); c++) {
+        auto const& view = *views[c];
+        advise(view, beginBlock, true);
+        for (unsigned block = beginBlock; block < endBlock; block++) {
+            if (block + 1 < endBlock) {
+                advise(view, block + 1, true);
+            }
+            for (std::size_t node = 0; node < nodeAntennaInputs.size(); node++) {
+                if (!nodeAntennaInputs[node].has_value()) {
+                    continue;
+                }
+                auto const& range = nodeAntennaInputs[node].value();
+                auto const samples = view.getSamples(block, range);
+                std::size_t const numAntennaInputs = range.end - range.begin + 1;
+                auto const offset = nodeOffsets[node] +
+                                    (c * numBlocks + (block - beginBlock)) * numAntennaInputs * blockSampleBytes;
+                std::copy(samples.begin(), samples.end(), chunk.data.begin() + offset);
+            }
+            // Each part of the file is only read once, so don't keep it in the page cache
+            advise(view, block, false);
+        }
+    }
+    return chunk;
+}
+
+void unpackChannelChunk(std::vector<std::int8_t> const& data, unsigned beginBlock, unsigned endBlock,
+                        std::size_t blockSampleBytes, unsigned numChannels,
+                        std::vector<std::vector<std::vector<std::int8_t>>>& signals) {
+    std::size_t const numBlocks = endBlock > beginBlock ? endBlock - beginBlock : 0;
+    if (data.size() != numChannels * numBlocks * signals.size() * blockSampleBytes) {
+        throw std::invalid_argument{"Received data doesn't match the size of the blocks"};
+    }
+
+    auto source = data.begin();
+    for (unsigned c = 0; c < numChannels; c++) {
+        for (unsigned block = beginBlock; block < endBlock; block++) {
+            for (auto& antennaInputSignals : signals) {
+                if (!antennaInputSignals.empty()) {
+                    auto& channel = antennaInputSignals.at(c);
+                    if (channel.size() < (block + 1) * blockSampleBytes) {
+                        throw std::invalid_argument{"Signal buffer is too small for the blocks"};
+                    }
+                    std::copy(source, source + blockSampleBytes, channel.begin() + block * blockSampleBytes);
+                }
+                source += blockSampleBytes;
+            }
+        }
+    }
+}
+
+// Gets the index of the first signal file which can be read and is valid, which gives the layout of all the files.
+// Returns nullptr if there is no such file.
+static std::shared_ptr<SubfileIndex const> getLayoutIndex(AppConfig const& appConfig,
+                                                          AntennaConfig const& antennaConfig) {
+    for (auto const channel : antennaConfig.frequencyChannels) {
+        try {
+            auto index = getSubfileIndex(getSignalFilePath(appConfig, channel));
+            if (index->isValid(antennaConfig.antennaInputs.size())) {
+                return index;
+            }
+        }
+        catch (ReadInputDataException const&) {
+            // Try the next channel
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::vector<std::optional<AntennaInputRange>>> splitChannelExchangeGroups(
+        std::vector<std::optional<AntennaInputRange>> const& nodeAntennaInputs, unsigned groupSize) {
+    if (groupSize == 0) {
+        throw std::invalid_argument{"groupSize must be > 0"};
+    }
+
+    std::vector<std::vector<AntennaInputRange>> nodeGroups;
+    std::size_t numGroups = 1;
+    for (auto const& range : nodeAntennaInputs) {
+        if (range.has_value()) {
+            // No larger than the range, so the groups can't run past the end of the antenna input numbers
+            auto const numAntennaInputs = range->end - range->begin + 1;
+            nodeGroups.push_back(splitAntennaInputRange(range.value(), std::min(groupSize, numAntennaInputs)));
+        }
+        else {
+            nodeGroups.emplace_back();
+        }
+        numGroups = std::max(numGroups, nodeGroups.back().size());
+    }
+
+    std::vector<std::vector<std::optional<AntennaInputRange>>> groups(
+        numGroups, std::vector<std::optional<AntennaInputRange>>(nodeAntennaInputs.size()));
+    for (std::size_t node = 0; node < nodeGroups.size(); node++) {
+        for (std::size_t group = 0; group < nodeGroups[node].size(); group++) {
+            groups[group][node] = nodeGroups[node][group];
+        }
+    }
+    return groups;
+}
+
+
+ChannelExchange::ChannelExchange(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                 InternodeCommunicator const& communicator,
+                                 std::vector<std::optional<AntennaInputRange>> nodeAntennaInputs) :
+    _communicator{communicator},
+    _antennaConfig{antennaConfig},
+    _nodeAntennaInputs{std::move(nodeAntennaInputs)},
+    _groups(1, _nodeAntennaInputs),
+    _nodeChannels{assignNodeChannels(communicator.getNodeCount(), antennaConfig.frequencyChannels)},
+    _usedChannels{},
+    _views{},
+    _numSamples{0},
+    _numBlocks{0}
+{
+    // Only the primary node reads a file header for the layout, which it sends to the other nodes
+    std::vector<unsigned long long> layout{false, 0, 0};
+    if (communicator.getNodeID() == 0) {
+        if (auto const index = getLayoutIndex(appConfig, antennaConfig)) {
+            layout = {true, index->getNumSamples(), index->getNumBlocks()};
+        }
+    }
+    layout = communicator.broadcastValues(layout);
+    _numSamples = static_cast<unsigned>(layout.at(1));
+    _numBlocks = static_cast<unsigned>(layout.at(2));
+
+    // Map this node's signal files which match the layout
+    std::set<unsigned> readableChannels;
+    if (layout.at(0)) {
+        for (auto const channel : _nodeChannels.at(communicator.getNodeID())) {
+            try {
+                SubfileView view{getSignalFilePath(appConfig, channel).string(),
+                                 static_cast<unsigned>(antennaConfig.antennaInputs.size())};
+                if (view.getNumSamples() == _numSamples && view.getNumBlocks() == _numBlocks) {
+                    _views.push_back(std::move(view));
+                    readableChannels.insert(channel);
+                }
+            }
+            catch (ReadInputDataException const&) {
+                // Left out of the used channels, handled below
+            }
+        }
+    }
+
+    // All nodes agree on the channels which can be read, so they all fail (or carry on) together
+    _usedChannels = communicator.uniteChannels(readableChannels);
+    if (!appConfig.ignoreErrors) {
+        for (auto const channel : antennaConfig.frequencyChannels) {
+            if (_usedChannels.count(channel) == 0) {
+                auto const signalFile = getSignalFilePath(appConfig, channel);
+                throw ReadInputDataException("Error occurred reading: " + signalFile.string());
+            }
+        }
+    }
+}
+
+std::set<unsigned> const& ChannelExchange::getUsedChannels() const {
+    return _usedChannels;
+}
+
+std::size_t ChannelExchange::getAntennaInputSize() const {
+    // Each raw sample is 2 bytes
+    return _usedChannels.size() * _numBlocks * static_cast<std::size_t>(_numSamples) * 2;
+}
+
+void ChannelExchange::setGroupSize(unsigned groupSize) {
+    _groups = splitChannelExchangeGroups(_nodeAntennaInputs, groupSize);
+}
+
+unsigned ChannelExchange::getNumGroups() const {
+    return _groups.size();
+}
+
+std::optional<AntennaInputRange> ChannelExchange::getNodeGroup(unsigned group) const {
+    return _groups.at(group).at(_communicator.getNodeID());
+}
+
+std::optional<AntennaInputBatch> ChannelExchange::exchangeGroup(unsigned group) const {
+    StageTimer const timer;
+    auto const& groupAntennaInputs = _groups.at(group);
+    auto const antennaInputs = getNodeGroup(group);
+
+    // Whole signals of each of this node's unflagged antenna inputs in the group, for every used channel
+    std::vector<std::vector<std::vector<std::int8_t>>> signals;
+    if (!_usedChannels.empty()) {
+        // Each raw sample is 2 bytes
+        std::size_t const blockSampleBytes = _numSamples * 2;
+        if (antennaInputs.has_value()) {
+            for (unsigned i = antennaInputs->begin; i <= antennaInputs->end; i++) {
+                signals.emplace_back();
+                if (!_antennaConfig.antennaInputs.at(i).flagged) {
+                    signals.back().assign(_usedChannels.size(),
+                                          std::vector<std::int8_t>(_numBlocks * blockSampleBytes));
+                }
+            }
+        }
+
+        // Number of channels received from each node, in node order (and so in ascending channel order)
+        std::vector<std::size_t> nodeNumChannels;
+        std::size_t maxNodeChannels = 1;
+        for (auto const& channels : _nodeChannels) {
+            nodeNumChannels.push_back(std::count_if(channels.begin(), channels.end(), [this](unsigned channel) {
+                return _usedChannels.count(channel) > 0;
+            }));
+            maxNodeChannels = std::max(maxNodeChannels, nodeNumChannels.back());
+        }
+        std::size_t groupNumAntennaInputs = 0;
+        for (auto const& range : groupAntennaInputs) {
+            if (range.has_value()) {
+                groupNumAntennaInputs += range->end - range->begin + 1;
+            }
+        }
+
+        // Exchange as many blocks at once as keep the largest send buffer within the chunk size
+        std::size_t const blockBytes = maxNodeChannels * groupNumAntennaInputs * blockSampleBytes;
+        auto const blocksPerChunk = static_cast<unsigned>(std::clamp<std::size_t>(
+            CHANNEL_EXCHANGE_CHUNK_BYTES / std::max<std::size_t>(blockBytes, 1), 1, std::max(_numBlocks, 1u)));
+        std::vector<SubfileView const*> viewPointers;
+        for (auto const& view : _views) {
+            viewPointers.push_back(&view);
+        }
+        for (unsigned beginBlock = 0; beginBlock < _numBlocks; beginBlock += blocksPerChunk) {
+            auto const endBlock = std::min(beginBlock + blocksPerChunk, _numBlocks);
+            auto const chunk = packChannelChunk(viewPointers, beginBlock, endBlock, groupAntennaInputs);
+            std::vector<std::size_t> receiveSizes;
+            for (auto const numChannels : nodeNumChannels) {
+                receiveSizes.push_back(numChannels * (endBlock - beginBlock) * signals.size() * blockSampleBytes);
+            }
+            auto const received = _communicator.exchangeData(chunk.data, chunk.nodeSizes, receiveSizes);
+            unpackChannelChunk(received, beginBlock, endBlock, blockSampleBytes, _usedChannels.size(), signals);
+        }
+    }
+
+    if (!antennaInputs.has_value()) {
+        return std::nullopt;
+    }
+    AntennaInputBatch batch{antennaInputs.value(),
+                            std::vector<AntennaInputSamples>(antennaInputs->end - antennaInputs->begin + 1),
+                            _usedChannels};
+    for (std::size_t i = 0; i < signals.size(); i++) {
+        for (auto& channel : signals[i]) {
+            batch.signals[i].addChannel(std::move(channel));
+        }
+        signals[i].clear();
+    }
+    batch.readSeconds = timer.getElapsedSeconds();
+    return batch;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "AntennaInputReader.hpp"
+#include "Common.hpp"
+#include "NodeAntennaInputAssigner.hpp"
+#include "SubfileView.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <vector>
+
+
+class InternodeCommunicator;
+
+
+// Approximate size of the raw signal data each node packs for sending in one exchange. The signal files are exchanged
+// a chunk of data blocks at a time, so only this much (plus what is received) is held in the exchange buffers at once.
+constexpr std::size_t CHANNEL_EXCHANGE_CHUNK_BYTES = 256 * 1024 * 1024;
+
+
+// Raw signal data packed for sending to every node, as one contiguous buffer.
+struct ChannelExchangeChunk {
+    // The data for node 0, then node 1, etc.
+    std::vector<std::int8_t> data;
+    // Number of bytes for each node.
+    std::vector<std::size_t> nodeSizes;
+};
+
+
+// Splits the frequency channels into contiguous (in ascending order) groups for each node, with near equal numbers of
+// channels. Nodes left without any channels get empty sets.
+// Throws std::invalid_argument if numNodes is 0.
+std::vector<std::set<unsigned>> assignNodeChannels(unsigned numNodes, std::set<unsigned> const& channels);
+
+// Packs data blocks beginBlock to endBlock (exclusive) of a node's signal files for sending to the nodes which process
+// each range of antenna inputs (nodes with no antenna inputs are sent nothing).
+// The data for each node is ordered by channel (in the order of views), then block, then antenna input, then sample.
+// The files are read in order, a block at a time. All files must have the same layout.
+// Throws std::out_of_range if the blocks or antenna inputs aren't in the files.
+ChannelExchangeChunk packChannelChunk(std::vector<SubfileView const*> const& views, unsigned beginBlock,
+                                      unsigned endBlock,
+                                      std::vector<std::optional<AntennaInputRange>> const& nodeAntennaInputs);
+
+// Copies data blocks beginBlock to endBlock (exclusive) of a node's antenna inputs, as received from packChannelChunk()
+// on every node (in node order), into signals. signals[i][c] is the whole raw signal of the node's ith antenna input
+// for its cth channel, sized for every data block; antenna inputs with no channels in signals are skipped.
+// blockSampleBytes is the size of the samples of one antenna input in one data block.
+// Throws std::invalid_argument if the data doesn't match the size of the blocks.
+void unpackChannelChunk(std::vector<std::int8_t> const& data, unsigned beginBlock, unsigned endBlock,
+                        std::size_t blockSampleBytes, unsigned numChannels,
+                        std::vector<std::vector<std::vector<std::int8_t>>>& signals);
+
+// Splits every node's antenna inputs into consecutive groups of at most groupSize antenna inputs, so they can be
+// exchanged a group at a time. Element [g][n] is node n's antenna inputs in group g (empty if it has none left). There
+// are as many groups as the node with the most antenna inputs needs, and at least one.
+// Throws std::invalid_argument if groupSize is 0.
+std::vector<std::vector<std::optional<AntennaInputRange>>> splitChannelExchangeGroups(
+    std::vector<std::optional<AntennaInputRange>> const& nodeAntennaInputs, unsigned groupSize);
+
+
+// Reads the raw signals of the nodes' antenna inputs by channel: each node reads the whole signal files of the channels
+// given to it by assignNodeChannels(), so each file is read by exactly one node, and the data is exchanged between all
+// nodes so each ends up with every channel of its own antenna inputs.
+// The antenna inputs are exchanged a group at a time (see splitChannelExchangeGroups()), so only one group's signals
+// need to be held in memory at once. Each group reads a different part of every file, so the files are still read
+// once overall.
+// Must be constructed and used by every node at the same point, even those with no antenna inputs.
+class ChannelExchange {
+public:
+    // Maps this node's signal files, with the layout of the files found by the primary node, and agrees with the other
+    // nodes on the channels which can be read. nodeAntennaInputs must be the same on every node.
+    // Until setGroupSize() is called, each node's antenna inputs are all in one group.
+    // Throws ReadInputDataException on every node if a signal file can't be read, unless appConfig.ignoreErrors is set
+    // (in which case the channel is left out of the used channels).
+    ChannelExchange(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                    InternodeCommunicator const& communicator,
+                    std::vector<std::optional<AntennaInputRange>> nodeAntennaInputs);
+
+    // Channels which every node could read, and so are exchanged.
+    std::set<unsigned> const& getUsedChannels() const;
+    // Number of bytes of raw signal data for one antenna input over all the used channels.
+    std::size_t getAntennaInputSize() const;
+
+    // Splits the antenna inputs into groups of at most groupSize antenna inputs. Must be the same on every node.
+    // Throws std::invalid_argument if groupSize is 0.
+    void setGroupSize(unsigned groupSize);
+    unsigned getNumGroups() const;
+    // Gets this node's antenna inputs in a group, if it has any.
+    std::optional<AntennaInputRange> getNodeGroup(unsigned group) const;
+
+    // Reads and exchanges the antenna inputs of a group, returning this node's (an empty optional if it has none).
+    // Flagged antenna inputs aren't kept.
+    // Every node must call this for the same group at the same time.
+    std::optional<AntennaInputBatch> exchangeGroup(unsigned group) const;
+
+private:
+    InternodeCommunicator const& _communicator;
+    AntennaConfig const& _antennaConfig;
+    std::vector<std::optional<AntennaInputRange>> _nodeAntennaInputs;
+    std::vector<std::vector<std::optional<AntennaInputRange>>> _groups;
+    // Channels read by each node.
+    std::vector<std::set<unsigned>> _nodeChannels;
+    std::set<unsigned> _usedChannels;
+    // This node's signal files, for its used channels.
+    std::vector<SubfileView> _views;
+    // Layout of all the signal files (0 if there are none which can be read).
+    unsigned _numSamples;
+    unsigned _numBlocks;
+};
@@ -0,0 +1,125 @@
+#include "ChannelFIRFilter.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
+
+// Number of blocks filtered by each task. Large enough that the halo copied for each chunk is small in comparison.
+constexpr std::size_t FIR_CHUNK_BLOCKS = 4096;
+
+
+// Adds one tap's contribution to a block of output: output[i] += taps[i] * input[i].
+// Kept as a plain loop over floats so the compiler vectorises it.
+static inline void multiplyAccumulate(float* output, float const* taps, float const* input, std::size_t numValues) {
+    for (std::size_t i = 0; i < numValues; ++i) {
+        output[i] += taps[i] * input[i];
+    }
+}
+
+
+ChannelFIRFilter::ChannelFIRFilter(std::vector<float> const& taps, unsigned numChannels) :
+    _numChannels{numChannels},
+    _numTaps{},
+    _interleavedTaps{}
+{
+    if (numChannels == 0 || taps.empty() || taps.size() % numChannels != 0) {
+        throw std::invalid_argument{"FIR filter taps must be a non-empty multiple of the number of channels"};
+    }
+    _numTaps = taps.size() / numChannels;
+    _interleavedTaps.reserve(taps.size() * 2);
+    for (auto const tap : taps) {
+        _interleavedTaps.push_back(tap);
+        _interleavedTaps.push_back(tap);
+    }
+}
+
+unsigned ChannelFIRFilter::getNumChannels() const {
+    return _numChannels;
+}
+
+unsigned ChannelFIRFilter::getNumTaps() const {
+    return _numTaps;
+}
+
+void ChannelFIRFilter::apply(std::complex<float>* signal, std::size_t numBlocks) const {
+    if (numBlocks == 0) {
+        return;
+    }
+
+    // std::complex<float> is guaranteed to have the same layout as float[2]
+    auto const data = reinterpret_cast<float*>(signal);
+    std::size_t const rowSize = std::size_t{_numChannels} * 2;
+    // Output block b uses input blocks b - pastBlocks to b + futureBlocks
+    std::size_t const futureBlocks = _numTaps / 2;
+    std::size_t const pastBlocks = _numTaps - 1 - futureBlocks;
+    std::size_t const numChunks = (numBlocks + FIR_CHUNK_BLOCKS - 1) / FIR_CHUNK_BLOCKS;
+
+    // Each chunk is overwritten by its own task, so the input blocks either side of it which it needs (its halo) are
+    // saved before any chunk is filtered. Laid out [chunk][pastBlocks + futureBlocks][row].
+    std::size_t const haloBlocks = pastBlocks + futureBlocks;
+    std::vector<float> halos(numChunks * haloBlocks * rowSize, 0.0f);
+    for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+        std::size_t const begin = chunk * FIR_CHUNK_BLOCKS;
+        std::size_t const end = std::min(begin + FIR_CHUNK_BLOCKS, numBlocks);
+        auto const halo = halos.data() + chunk * haloBlocks * rowSize;
+        for (std::size_t i = 0; i < pastBlocks; ++i) {
+            if (begin + i >= pastBlocks) {
+                auto const block = begin + i - pastBlocks;
+                std::copy_n(data + block * rowSize, rowSize, halo + i * rowSize);
+            }
+        }
+        for (std::size_t i = 0; i < futureBlocks && end + i < numBlocks; ++i) {
+            std::copy_n(data + (end + i) * rowSize, rowSize, halo + (pastBlocks + i) * rowSize);
+        }
+    }
+
+    tbb::parallel_for(std::size_t{0}, numChunks, [this, data, numBlocks, rowSize, futureBlocks, pastBlocks, haloBlocks,
+                                                  &halos](std::size_t chunk) {
+        std::size_t const begin = chunk * FIR_CHUNK_BLOCKS;
+        std::size_t const end = std::min(begin + FIR_CHUNK_BLOCKS, numBlocks);
+        auto const halo = halos.data() + chunk * haloBlocks * rowSize;
+
+        // The original input of the last pastBlocks blocks, indexed by block % pastBlocks, since they have been
+        // overwritten with their output by the time later blocks need them
+        std::vector<float> history(pastBlocks * rowSize);
+        for (std::size_t i = 0; i < pastBlocks; ++i) {
+            if (begin + i >= pastBlocks) {
+                auto const block = begin + i - pastBlocks;
+                std::copy_n(halo + i * rowSize, rowSize, history.data() + (block % pastBlocks) * rowSize);
+            }
+        }
+        std::vector<float> output(rowSize);
+
+        for (std::size_t block = begin; block < end; ++block) {
+            std::fill(output.begin(), output.end(), 0.0f);
+            for (std::size_t tap = 0; tap < _numTaps; ++tap) {
+                // Input block block + futureBlocks - tap, skipping those outside the signal
+                if (block + futureBlocks < tap || block + futureBlocks - tap >= numBlocks) {
+                    continue;
+                }
+                auto const inputBlock = block + futureBlocks - tap;
+                float const* input;
+                if (inputBlock < block) {
+                    input = history.data() + (inputBlock % pastBlocks) * rowSize;
+                }
+                else if (inputBlock < end) {
+                    input = data + inputBlock * rowSize;
+                }
+                else {
+                    input = halo + (pastBlocks + inputBlock - end) * rowSize;
+                }
+                multiplyAccumulate(output.data(), _interleavedTaps.data() + tap * rowSize, input, rowSize);
+            }
+
+            if (pastBlocks > 0) {
+                std::copy_n(data + block * rowSize, rowSize, history.data() + (block % pastBlocks) * rowSize);
+            }
+            std::copy(output.begin(), output.end(), data + block * rowSize);
+        }
+    });
+}
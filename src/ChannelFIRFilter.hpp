@@ -0,0 +1,32 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+
+// Real valued FIR filters for every channel of a complex signal laid out [block][channel], as used for the inverse PFB.
+// All channels are filtered together a block at a time, so the signal is streamed through contiguously and the
+// multiply-adds vectorise across channels. Since the taps are real, each tap needs 2 real multiplies per sample rather
+// than the 4 of a complex multiply.
+class ChannelFIRFilter {
+public:
+    // taps holds numTaps taps for each of numChannels channels, laid out [tap][channel].
+    // Throws std::invalid_argument if taps is empty or not a multiple of numChannels.
+    ChannelFIRFilter(std::vector<float> const& taps, unsigned numChannels);
+
+    unsigned getNumChannels() const;
+    unsigned getNumTaps() const;
+
+    // Filters numBlocks blocks of signal in place. Each channel's output is the middle numBlocks samples of the full
+    // convolution of the channel with its taps, i.e. output block b is sum(taps[k] * signal[b + numTaps/2 - k]), with
+    // the signal taken as zero outside its blocks.
+    // The blocks are split into chunks filtered concurrently.
+    void apply(std::complex<float>* signal, std::size_t numBlocks) const;
+
+private:
+    unsigned _numChannels;
+    unsigned _numTaps;
+    // Taps repeated for the real and imaginary parts of each sample, laid out [tap][channel][2]
+    std::vector<float> _interleavedTaps;
+};
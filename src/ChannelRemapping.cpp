@@ -1,12 +1,23 @@
 #include "ChannelRemapping.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <map>
+#include <optional>
 #include <set>
 #include <stdexcept>
 #include <utility>
 
 
+// Largest prime factor of a DFT length which is cheap to transform (specialised butterflies).
+static constexpr unsigned MAX_FAST_DFT_FACTOR = 7;
+// Largest prime factor of a DFT length which is transformed directly, with a generic O(p^2) butterfly. Lengths with
+// larger prime factors use Bluestein's algorithm, padding to a power of 2 at least twice as long.
+static constexpr unsigned MAX_DIRECT_DFT_FACTOR = 31;
+// Cost of storing one output sample, relative to one unit of DFT work (n*log2(n) for a power of 2 length n).
+static constexpr double STORAGE_COST_PER_SAMPLE = 4.0;
+
+
 // Aliases a channel using a given Nyquist frequency.
 static ChannelRemapping::RemappedChannel aliasChannel(unsigned channel, unsigned nyquistFreq) {
     auto const samplingFreq = 2 * nyquistFreq;
@@ -20,7 +31,60 @@ static ChannelRemapping::RemappedChannel aliasChannel(unsigned channel, unsigned
 }
 
 
-ChannelRemapping computeChannelRemapping(unsigned samplingFreq, std::set<unsigned> const& channels) {
+// Aliases all channels using a given Nyquist frequency, if no two channels alias to the same new channel.
+static std::optional<std::map<unsigned, ChannelRemapping::RemappedChannel>> tryAliasChannels(
+        std::set<unsigned> const& channels, unsigned nyquistFreq) {
+    std::map<unsigned, ChannelRemapping::RemappedChannel> remapping;
+    std::set<unsigned> newChannels;
+    for (auto const channel : channels) {
+        auto const alias = aliasChannel(channel, nyquistFreq);
+        if (!newChannels.insert(alias.newChannel).second) {
+            // Alias is already filled by another channel.
+            return std::nullopt;
+        }
+        remapping[channel] = alias;
+    }
+    return remapping;
+}
+
+double estimateRemappingCost(unsigned newSamplingFreq) {
+    if (newSamplingFreq == 0) {
+        throw std::invalid_argument{"newSamplingFreq must be > 0"};
+    }
+
+    // Work per sample of each radix stage
+    double costPerSample = 0.0;
+    unsigned remainder = newSamplingFreq;
+    for (unsigned factor = 2; factor <= MAX_DIRECT_DFT_FACTOR && remainder > 1; ++factor) {
+        while (remainder % factor == 0) {
+            if (factor <= MAX_FAST_DFT_FACTOR) {
+                costPerSample += std::log2(factor);
+            }
+            else {
+                costPerSample += factor / 2.0;
+            }
+            remainder /= factor;
+        }
+    }
+
+    double dftCost;
+    if (remainder == 1) {
+        dftCost = newSamplingFreq * costPerSample;
+    }
+    else {
+        // Bluestein's algorithm: 3 transforms of a power of 2 length >= 2n-1
+        unsigned paddedLength = 1;
+        while (paddedLength < 2 * newSamplingFreq - 1) {
+            paddedLength *= 2;
+        }
+        dftCost = 3.0 * paddedLength * std::log2(paddedLength);
+    }
+    return dftCost + STORAGE_COST_PER_SAMPLE * newSamplingFreq;
+}
+
+
+ChannelRemapping computeChannelRemapping(unsigned samplingFreq, std::set<unsigned> const& channels,
+                                         RemappingMode mode) {
     if (samplingFreq <= 0) {
         throw std::invalid_argument{"samplingFreq must be > 0"};
     }
@@ -45,35 +109,38 @@ ChannelRemapping computeChannelRemapping(unsigned samplingFreq, std::set<unsigne
         // If we have N channels, then we need at very least we need N new channels <= the new Nyquist frequency.
         unsigned const minNyquistFreq = channels.size() - 1;
 
-        unsigned newNyquistFreq;
-        std::map<unsigned, ChannelRemapping::RemappedChannel> remapping;
-        std::set<unsigned> newChannels;
-        for (newNyquistFreq = minNyquistFreq; ; newNyquistFreq += 1) {
-            bool valid = true;
-            for (auto const channel : channels) {
-                auto const alias = aliasChannel(channel, newNyquistFreq);
-                if (newChannels.count(alias.newChannel) > 0) {
-                    // Alias is already filled by another channel.
-                    valid = false;
+        unsigned newNyquistFreq = minNyquistFreq;
+        auto remapping = tryAliasChannels(channels, newNyquistFreq);
+        // Since we are exploring new sampling frequencies from low to high, the first valid remapping is optimal.
+        // There always is one, with the original Nyquist frequency nothing gets aliased.
+        while (!remapping.has_value()) {
+            newNyquistFreq += 1;
+            remapping = tryAliasChannels(channels, newNyquistFreq);
+        }
+
+        if (mode == RemappingMode::fftFriendly) {
+            // Search the larger valid Nyquist frequencies for a cheaper one, up to the original Nyquist frequency.
+            // Every length costs at least n*log2(n) + storage, so the search stops once that can't beat the best.
+            auto bestCost = estimateRemappingCost(2 * newNyquistFreq);
+            for (unsigned nyquistFreq = newNyquistFreq + 1; nyquistFreq <= samplingFreq / 2; ++nyquistFreq) {
+                auto const length = 2 * nyquistFreq;
+                if (length * (std::log2(length) + STORAGE_COST_PER_SAMPLE) >= bestCost) {
                     break;
                 }
-                else {
-                    newChannels.insert(alias.newChannel);
-                    remapping[channel] = alias;
+                auto const cost = estimateRemappingCost(length);
+                if (cost < bestCost) {
+                    auto candidate = tryAliasChannels(channels, nyquistFreq);
+                    if (candidate.has_value()) {
+                        bestCost = cost;
+                        newNyquistFreq = nyquistFreq;
+                        remapping = std::move(candidate);
+                    }
                 }
             }
-
-            // Since we are exploring new sampling frequencies from low to high, the first valid remapping is optimal.
-            if (valid) {
-                break;
-            }
-
-            remapping.clear();
-            newChannels.clear();
         }
 
         auto const newSamplingFreq = 2 * newNyquistFreq;
-        return {newSamplingFreq, std::move(remapping)};
+        return {newSamplingFreq, std::move(remapping.value())};
     }
 }
 
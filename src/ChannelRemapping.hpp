@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Common.hpp"
+
 #include <map>
 #include <set>
 
@@ -27,7 +29,16 @@ struct ChannelRemapping {
 //  - samplingFreq: the original sampling frequency, as a multiple of the channel bandwidth. Must be > 0.
 //  - channels: the original set of frequency channels. Each channel is represented as a multiple of the channel
 //      bandwidth. Each channel must be <= samplingFreq/2.
-ChannelRemapping computeChannelRemapping(unsigned samplingFreq, std::set<unsigned> const& channels);
+//  - mode: how the new sampling frequency is chosen. RemappingMode::minimal gives the smallest valid new sampling
+//      frequency. RemappingMode::fftFriendly gives the valid new sampling frequency (up to samplingFreq) with the
+//      lowest estimateRemappingCost(), which may be larger than the smallest if that has large prime factors.
+ChannelRemapping computeChannelRemapping(unsigned samplingFreq, std::set<unsigned> const& channels,
+                                         RemappingMode mode = RemappingMode::minimal);
+
+// Estimates the relative cost of using a new sampling frequency, i.e. of an inverse real DFT of that length plus storing
+// its output, per data block. Lengths with only small prime factors are cheapest, while lengths with a prime factor
+// > 31 are much more expensive as they are transformed by convolution with a larger power of 2 length transform.
+double estimateRemappingCost(unsigned newSamplingFreq);
 
 
 // ChannelRemapping comparison mainly for testing purposes.
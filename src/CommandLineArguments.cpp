@@ -2,11 +2,36 @@
 
 #include <filesystem>
 #include <stdexcept>
+#include <string>
+
+
+// Largest accepted prefetch depth, each batch read ahead is held in memory
+constexpr unsigned MAX_PREFETCH_DEPTH = 8;
+// Largest accepted number of antenna inputs processed at once, each needs its own processing buffers
+constexpr unsigned MAX_CONCURRENT_INPUTS = 64;
+// Largest accepted number of antenna inputs processed in one batch, each needs its own processing buffers
+constexpr unsigned MAX_INPUT_BATCH_SIZE = 8;
+// Largest accepted write-behind depth, each signal waiting to be written is held in memory
+constexpr unsigned MAX_WRITE_BEHIND_DEPTH = 8;
+
+
+// Parses a whole string as a non-negative integer, throws std::invalid_argument with the given message otherwise
+static unsigned long long parseUnsigned(std::string const value, std::string const errorMessage) {
+	if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+		throw std::invalid_argument {errorMessage};
+	}
+	try {
+		return std::stoull(value);
+	}
+	catch (std::out_of_range const&) {
+		throw std::invalid_argument {errorMessage};
+	}
+}
 
 
 AppConfig createAppConfig(int argc, char* argv[]) {
     // Validate command line arguments
-	if (argc != 7) {
+	if (argc < 7) {
 		throw std::invalid_argument{"Invalid number of command line arguments"};
 	}
 
@@ -18,10 +43,82 @@ AppConfig createAppConfig(int argc, char* argv[]) {
 	appConfig.invPolyphaseFilterPath = validateInvPolyphaseFilterPath(argv[4]);
 	appConfig.outputDirectoryPath = validateOutputDirectoryPath(argv[5]);
 	appConfig.ignoreErrors = validateIgnoreErrors(argv[6]);
+
+	// Anything after the positional arguments must be an optional argument
+	for (int i = 7; i < argc; i++) {
+		applyOptionalArgument(appConfig, argv[i]);
+	}
+
+	// With the channel decomposition, every node needs to know up front which antenna inputs every other node processes
+	if (appConfig.decompositionMode == DecompositionMode::channel
+	        && appConfig.schedulingMode == SchedulingMode::dynamic) {
+		throw std::invalid_argument {"Channel decomposition can't be used with dynamic scheduling"};
+	}
+	// Only the output container is written by every node together
+	if (appConfig.collectiveWrites && appConfig.outputFormat != OutputFormat::container) {
+		throw std::invalid_argument {"Collective writes can only be used with the container output format"};
+	}
+	// Every node waits for the others at each round of collective writes, which would undo the dynamic scheduling
+	if (appConfig.collectiveWrites && appConfig.schedulingMode == SchedulingMode::dynamic) {
+		throw std::invalid_argument {"Collective writes can't be used with dynamic scheduling"};
+	}
 	return appConfig;
 }
 
 
+void applyOptionalArgument(AppConfig& appConfig, std::string const argument) {
+	auto const separator = argument.find('=');
+	if (argument.rfind("--", 0) != 0 || separator == std::string::npos) {
+		throw std::invalid_argument {"Invalid command line argument '" + argument + "', expecting --name=value"};
+	}
+
+	auto const name = argument.substr(2, separator - 2);
+	auto const value = argument.substr(separator + 1);
+	if (name == "memory-budget") {
+		appConfig.memoryBudget = validateMemoryBudget(value);
+	}
+	else if (name == "prefetch-depth") {
+		appConfig.prefetchDepth = validatePrefetchDepth(value);
+	}
+	else if (name == "remapping-mode") {
+		appConfig.remappingMode = validateRemappingMode(value);
+	}
+	else if (name == "concurrent-inputs") {
+		appConfig.concurrentInputs = validateConcurrentInputs(value);
+	}
+	else if (name == "input-batch-size") {
+		appConfig.inputBatchSize = validateInputBatchSize(value);
+	}
+	else if (name == "scheduling") {
+		appConfig.schedulingMode = validateSchedulingMode(value);
+	}
+	else if (name == "decomposition") {
+		appConfig.decompositionMode = validateDecompositionMode(value);
+	}
+	else if (name == "shared-memory") {
+		appConfig.sharedMemory = validateSharedMemory(value);
+	}
+	else if (name == "output-format") {
+		appConfig.outputFormat = validateOutputFormat(value);
+	}
+	else if (name == "collective-writes") {
+		appConfig.collectiveWrites = validateCollectiveWrites(value);
+	}
+	else if (name == "write-behind-depth") {
+		appConfig.writeBehindDepth = validateWriteBehindDepth(value);
+	}
+	else if (name == "output-backend") {
+		appConfig.outputBackend = validateOutputBackend(value);
+	}
+	else if (name == "overlap-save") {
+		appConfig.overlapSave = validateOverlapSave(value);
+	}
+	else {
+		throw std::invalid_argument {"Unknown command line argument '--" + name + "'"};
+	}
+}
+
+
 std::string validateInputDirectoryPath(std::string const inputDirectoryPath) {
 	std::filesystem::path directory (inputDirectoryPath);
 
@@ -118,4 +215,149 @@ bool validateIgnoreErrors(std::string const ignoreErrors) {
 		throw std::invalid_argument {"Ignore errors argument must be 'true' or 'false'"};
 	}
 	return ignore;
-}
\ No newline at end of file
+}
+
+
+unsigned validateMemoryBudget(std::string const memoryBudget) {
+	auto const budget = parseUnsigned(memoryBudget, "Invalid memory budget, must be a whole number of MiB");
+
+	if (budget == 0) {
+		throw std::invalid_argument {"Invalid memory budget, must be positive"};
+	}
+	else if (budget > 1024 * 1024) {
+		throw std::invalid_argument {"Invalid memory budget, must be at most 1048576 MiB"};
+	}
+	return (unsigned) budget;
+}
+
+
+unsigned validatePrefetchDepth(std::string const prefetchDepth) {
+	auto const depth = parseUnsigned(prefetchDepth, "Invalid prefetch depth, must be a non-negative whole number");
+
+	if (depth > MAX_PREFETCH_DEPTH) {
+		throw std::invalid_argument {"Invalid prefetch depth, must be at most " + std::to_string(MAX_PREFETCH_DEPTH)};
+	}
+	return (unsigned) depth;
+}
+
+
+RemappingMode validateRemappingMode(std::string const remappingMode) {
+	if (remappingMode == "minimal") {
+		return RemappingMode::minimal;
+	}
+	else if (remappingMode == "fft-friendly") {
+		return RemappingMode::fftFriendly;
+	}
+	throw std::invalid_argument {"Remapping mode argument must be 'minimal' or 'fft-friendly'"};
+}
+
+
+unsigned validateConcurrentInputs(std::string const concurrentInputs) {
+	auto const inputs = parseUnsigned(concurrentInputs,
+	                                  "Invalid number of concurrent inputs, must be a non-negative whole number");
+
+	if (inputs > MAX_CONCURRENT_INPUTS) {
+		throw std::invalid_argument {"Invalid number of concurrent inputs, must be at most "
+		                             + std::to_string(MAX_CONCURRENT_INPUTS)};
+	}
+	return (unsigned) inputs;
+}
+
+
+unsigned validateInputBatchSize(std::string const inputBatchSize) {
+	auto const batchSize = parseUnsigned(inputBatchSize, "Invalid input batch size, must be a whole number");
+
+	if (batchSize == 0 || batchSize > MAX_INPUT_BATCH_SIZE) {
+		throw std::invalid_argument {"Invalid input batch size, must be between 1 and "
+		                             + std::to_string(MAX_INPUT_BATCH_SIZE)};
+	}
+	return (unsigned) batchSize;
+}
+
+
+SchedulingMode validateSchedulingMode(std::string const schedulingMode) {
+	if (schedulingMode == "static") {
+		return SchedulingMode::staticAssignment;
+	}
+	else if (schedulingMode == "dynamic") {
+		return SchedulingMode::dynamic;
+	}
+	throw std::invalid_argument {"Scheduling argument must be 'static' or 'dynamic'"};
+}
+
+
+DecompositionMode validateDecompositionMode(std::string const decompositionMode) {
+	if (decompositionMode == "antenna-input") {
+		return DecompositionMode::antennaInput;
+	}
+	else if (decompositionMode == "channel") {
+		return DecompositionMode::channel;
+	}
+	throw std::invalid_argument {"Decomposition argument must be 'antenna-input' or 'channel'"};
+}
+
+
+bool validateSharedMemory(std::string const sharedMemory) {
+	if (sharedMemory == "true") {
+		return true;
+	}
+	else if (sharedMemory == "false") {
+		return false;
+	}
+	throw std::invalid_argument {"Shared memory argument must be 'true' or 'false'"};
+}
+
+
+OutputFormat validateOutputFormat(std::string const outputFormat) {
+	if (outputFormat == "per-input") {
+		return OutputFormat::perInput;
+	}
+	else if (outputFormat == "container") {
+		return OutputFormat::container;
+	}
+	throw std::invalid_argument {"Output format argument must be 'per-input' or 'container'"};
+}
+
+
+bool validateCollectiveWrites(std::string const collectiveWrites) {
+	if (collectiveWrites == "true") {
+		return true;
+	}
+	else if (collectiveWrites == "false") {
+		return false;
+	}
+	throw std::invalid_argument {"Collective writes argument must be 'true' or 'false'"};
+}
+
+
+unsigned validateWriteBehindDepth(std::string const writeBehindDepth) {
+	auto const depth = parseUnsigned(writeBehindDepth, "Invalid write-behind depth, must be a non-negative whole number");
+
+	if (depth > MAX_WRITE_BEHIND_DEPTH) {
+		throw std::invalid_argument {"Invalid write-behind depth, must be at most " +
+		                             std::to_string(MAX_WRITE_BEHIND_DEPTH)};
+	}
+	return (unsigned) depth;
+}
+
+
+OutputBackend validateOutputBackend(std::string const outputBackend) {
+	if (outputBackend == "stream") {
+		return OutputBackend::stream;
+	}
+	else if (outputBackend == "direct") {
+		return OutputBackend::direct;
+	}
+	throw std::invalid_argument {"Output backend argument must be 'stream' or 'direct'"};
+}
+
+
+bool validateOverlapSave(std::string const overlapSave) {
+	if (overlapSave == "true") {
+		return true;
+	}
+	else if (overlapSave == "false") {
+		return false;
+	}
+	throw std::invalid_argument {"Overlap-save argument must be 'true' or 'false'"};
+}
@@ -4,13 +4,30 @@
 
 #include <string>
 
+// Positional arguments may be followed by optional arguments of the form --name=value
 // Throws std::invalid_argument
 AppConfig createAppConfig(int argc, char* argv[]);
 
+// Sets the app configuration field given by an optional argument (--name=value), throws std::invalid_argument
+void applyOptionalArgument(AppConfig& appConfig, std::string const argument);
+
 // Command line validation functions throw std::invalid_argument
 std::string validateInputDirectoryPath(std::string const inputDirectoryPath);
 unsigned long long validateObservationID(std::string const observationID);
 unsigned long long validateSignalStartTime(std::string const observationID, std::string signalStartTime);
 std::string validateInvPolyphaseFilterPath(std::string const invPolyphaseFilterPath);
 std::string validateOutputDirectoryPath(std::string const outputDirectoryPath);
-bool validateIgnoreErrors(std::string const ignoreErrors);
\ No newline at end of file
+bool validateIgnoreErrors(std::string const ignoreErrors);
+unsigned validateMemoryBudget(std::string const memoryBudget);
+unsigned validatePrefetchDepth(std::string const prefetchDepth);
+RemappingMode validateRemappingMode(std::string const remappingMode);
+unsigned validateConcurrentInputs(std::string const concurrentInputs);
+unsigned validateInputBatchSize(std::string const inputBatchSize);
+SchedulingMode validateSchedulingMode(std::string const schedulingMode);
+DecompositionMode validateDecompositionMode(std::string const decompositionMode);
+bool validateSharedMemory(std::string const sharedMemory);
+OutputFormat validateOutputFormat(std::string const outputFormat);
+bool validateCollectiveWrites(std::string const collectiveWrites);
+unsigned validateWriteBehindDepth(std::string const writeBehindDepth);
+OutputBackend validateOutputBackend(std::string const outputBackend);
+bool validateOverlapSave(std::string const overlapSave);
@@ -6,7 +6,20 @@ bool operator==(AppConfig const& lhs, AppConfig const& rhs) {
         && lhs.inputDirectoryPath == rhs.inputDirectoryPath
         && lhs.invPolyphaseFilterPath == rhs.invPolyphaseFilterPath
         && lhs.outputDirectoryPath == rhs.outputDirectoryPath
-        && lhs.ignoreErrors == rhs.ignoreErrors;
+        && lhs.ignoreErrors == rhs.ignoreErrors
+        && lhs.memoryBudget == rhs.memoryBudget
+        && lhs.prefetchDepth == rhs.prefetchDepth
+        && lhs.remappingMode == rhs.remappingMode
+        && lhs.concurrentInputs == rhs.concurrentInputs
+        && lhs.inputBatchSize == rhs.inputBatchSize
+        && lhs.schedulingMode == rhs.schedulingMode
+        && lhs.decompositionMode == rhs.decompositionMode
+        && lhs.sharedMemory == rhs.sharedMemory
+        && lhs.outputFormat == rhs.outputFormat
+        && lhs.collectiveWrites == rhs.collectiveWrites
+        && lhs.writeBehindDepth == rhs.writeBehindDepth
+        && lhs.outputBackend == rhs.outputBackend
+        && lhs.overlapSave == rhs.overlapSave;
 }
 
 bool operator==(AntennaInputPhysID const& lhs, AntennaInputPhysID const& rhs) {
@@ -17,8 +30,13 @@ bool operator==(AntennaConfig const& lhs, AntennaConfig const& rhs) {
     return lhs.antennaInputs == rhs.antennaInputs && lhs.frequencyChannels == rhs.frequencyChannels;
 }
 
+bool operator==(StageMeasurement const& lhs, StageMeasurement const& rhs) {
+    return lhs.seconds == rhs.seconds && lhs.bytes == rhs.bytes && lhs.samples == rhs.samples;
+}
+
 bool operator==(AntennaInputProcessingResults const& lhs, AntennaInputProcessingResults const& rhs) {
-    return lhs.success == rhs.success && lhs.usedChannels == rhs.usedChannels;
+    return lhs.success == rhs.success && lhs.usedChannels == rhs.usedChannels &&
+           lhs.stageMeasurements == rhs.stageMeasurements && lhs.node == rhs.node;
 }
 
 bool operator==(ObservationProcessingResults const& lhs, ObservationProcessingResults const& rhs) {
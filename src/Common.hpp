@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <map>
 #include <set>
 #include <string>
@@ -11,6 +13,48 @@ inline const int MWA_NUM_CHANNELS = 256;
 // Constant for the MWA sampling rate
 constexpr unsigned SAMPLING_RATE = MWA_NUM_CHANNELS*2;
 
+// How the new sampling frequency is chosen when remapping frequency channels, see computeChannelRemapping()
+enum class RemappingMode {
+	// The smallest valid sampling frequency
+	minimal,
+	// The valid sampling frequency with the lowest estimated inverse DFT and output storage cost
+	fftFriendly
+};
+
+// How antenna inputs are shared between the nodes
+enum class SchedulingMode {
+	// Each node is assigned a fixed range of antenna inputs up front, see assignNodeAntennaInputs()
+	staticAssignment,
+	// Nodes are handed chunks of antenna inputs as they finish their previous ones, see AntennaInputScheduler
+	dynamic
+};
+
+// How the reading of the signal files is shared between the nodes
+enum class DecompositionMode {
+	// Each node reads its own antenna inputs from every channel's signal file
+	antennaInput,
+	// Each node reads its own channels' signal files in full, and the samples are exchanged between the nodes so each
+	// ends up with every channel of its own antenna inputs, see ChannelDecomposition.hpp
+	channel
+};
+
+// How the processed signals are written to the output directory
+enum class OutputFormat {
+	// One file for each antenna input, see OutSignalWriter.hpp
+	perInput,
+	// One container file for the whole observation, with a table of the antenna inputs, see OutputContainer.hpp
+	container
+};
+
+// How the output signal files are written, see OutSignalWriter.hpp
+enum class OutputBackend {
+	// Through a C++ file stream, and so the page cache
+	stream,
+	// Preallocated at their final size, then written in large aligned chunks bypassing the page cache (O_DIRECT) where
+	// the file system allows it
+	direct
+};
+
 // Contains the observation details, and input and output file directories
 // Entered as command line arguments
 struct AppConfig {
@@ -20,6 +64,32 @@ struct AppConfig {
 	std::string invPolyphaseFilterPath;
 	std::string outputDirectoryPath;
 	bool ignoreErrors;
+	// Memory (in MiB) for raw signal data being processed and read ahead, per node.
+	unsigned memoryBudget = 2048;
+	// Maximum number of batches of antenna inputs read ahead while the current batch is processed.
+	unsigned prefetchDepth = 1;
+	// How the new sampling frequency of the processed signals is chosen.
+	RemappingMode remappingMode = RemappingMode::minimal;
+	// Maximum number of antenna inputs processed at once per node, 0 for as many as the memory budget and cores allow.
+	unsigned concurrentInputs = 1;
+	// Maximum number of antenna inputs processed together in one batch, with one inverse DFT for all of them.
+	unsigned inputBatchSize = 1;
+	// How antenna inputs are shared between the nodes.
+	SchedulingMode schedulingMode = SchedulingMode::staticAssignment;
+	// How the reading of the signal files is shared between the nodes.
+	DecompositionMode decompositionMode = DecompositionMode::antennaInput;
+	// Whether processes on the same host share one copy of the filter coefficients (in MPI shared memory).
+	bool sharedMemory = false;
+	// How the processed signals are written to the output directory.
+	OutputFormat outputFormat = OutputFormat::perInput;
+	// Whether the output container is written with collective MPI-IO, gathering the writes onto a few processes.
+	bool collectiveWrites = false;
+	// Maximum number of processed signals waiting to be written by the writer thread, 0 to write them on the processing threads.
+	unsigned writeBehindDepth = 0;
+	// How the output signal files are written (with the per input output format).
+	OutputBackend outputBackend = OutputBackend::stream;
+	// Whether the inverse PFB may use FFT convolution (overlap-save) rather than filtering directly, for long signals.
+	bool overlapSave = false;
 };
 
 
@@ -35,9 +105,35 @@ struct AntennaConfig {
 };
 
 
+// Stages of processing an antenna input which are timed, see StageTiming.hpp
+enum class ProcessingStage : unsigned {
+	read,
+	remap,
+	pfb,
+	dft,
+	postProcessing,
+	write
+};
+
+constexpr std::size_t NUM_PROCESSING_STAGES = 6;
+
+// Time spent in one stage of processing an antenna input, and the amount of data it produced
+struct StageMeasurement {
+	double seconds = 0.0;
+	unsigned long long bytes = 0;
+	unsigned long long samples = 0;
+};
+
+// Measurement of each stage, indexed by ProcessingStage
+using StageMeasurements = std::array<StageMeasurement, NUM_PROCESSING_STAGES>;
+
 struct AntennaInputProcessingResults {
 	bool success;
 	std::set<unsigned> usedChannels;
+	// Stages the antenna input went through, all zero for stages it didn't reach
+	StageMeasurements stageMeasurements{};
+	// Node which processed the antenna input. Set by the primary node when it receives the results.
+	unsigned node = 0;
 };
 
 // Contains antenna input id as key, processing results as value
@@ -50,5 +146,6 @@ struct ObservationProcessingResults {
 bool operator==(AppConfig const& lhs, AppConfig const& rhs);
 bool operator==(AntennaInputPhysID const& lhs, AntennaInputPhysID const& rhs);
 bool operator==(AntennaConfig const& lhs, AntennaConfig const& rhs);
+bool operator==(StageMeasurement const& lhs, StageMeasurement const& rhs);
 bool operator==(AntennaInputProcessingResults const& lhs, AntennaInputProcessingResults const& rhs);
 bool operator==(ObservationProcessingResults const& lhs, ObservationProcessingResults const& rhs);
@@ -0,0 +1,100 @@
+#include "ConcurrentInputProcessor.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <mkl.h>
+#include <tbb/info.h>
+
+
+ConcurrencyPlan planConcurrency(std::size_t memoryBudget, std::size_t inputMemory, unsigned numThreads,
+                                unsigned maxConcurrentInputs) {
+    std::size_t concurrentInputs = std::max(numThreads, 1u);
+    if (maxConcurrentInputs > 0) {
+        concurrentInputs = std::min<std::size_t>(concurrentInputs, maxConcurrentInputs);
+    }
+    if (inputMemory > 0) {
+        concurrentInputs = std::min(concurrentInputs, std::max<std::size_t>(memoryBudget / inputMemory, 1));
+    }
+    auto const threadsPerInput = std::max<std::size_t>(numThreads / concurrentInputs, 1);
+    return {static_cast<unsigned>(concurrentInputs), static_cast<unsigned>(threadsPerInput)};
+}
+
+ConcurrencyPlan planConcurrency(AppConfig const& appConfig, std::size_t inputMemory) {
+    std::size_t const memoryBudget = static_cast<std::size_t>(appConfig.memoryBudget) * 1024 * 1024;
+    return planConcurrency(memoryBudget, inputMemory, getAvailableThreads(), appConfig.concurrentInputs);
+}
+
+unsigned getAvailableThreads() {
+    // Takes into account the CPU affinity of the process (e.g. as bound by the MPI launcher)
+    return static_cast<unsigned>(std::max(tbb::info::default_concurrency(), 1));
+}
+
+
+ConcurrentInputProcessor::ConcurrentInputProcessor(ConcurrencyPlan const& plan, unsigned numThreads) :
+    _plan{plan},
+    _mutex{},
+    _condition{},
+    _freeSlots{},
+    _taskException{},
+    // No slots are reserved for the calling thread, since it only starts tasks rather than joining in
+    _arena{static_cast<int>(std::max(numThreads, 1u)), 0}
+{
+    // Taken from the back, so the lowest slots are used first
+    for (unsigned slot = plan.concurrentInputs; slot > 0; --slot) {
+        _freeSlots.push_back(slot - 1);
+    }
+}
+
+ConcurrentInputProcessor::~ConcurrentInputProcessor() {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _condition.wait(lock, [this]() { return _freeSlots.size() == _plan.concurrentInputs; });
+}
+
+void ConcurrentInputProcessor::run(Task task) {
+    unsigned slot;
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _condition.wait(lock, [this]() { return !_freeSlots.empty() || _taskException; });
+        _rethrowTaskException();
+        slot = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+
+    _arena.enqueue([this, task = std::move(task), slot]() {
+        std::exception_ptr exception;
+        // Share the threads between the antenna inputs, rather than each using all of them in its MKL calls
+        auto const previousThreads = mkl_set_num_threads_local(static_cast<int>(_plan.threadsPerInput));
+        try {
+            task(slot);
+        }
+        catch (...) {
+            exception = std::current_exception();
+        }
+        mkl_set_num_threads_local(previousThreads);
+
+        // Notified while holding the lock, since this object may be destroyed as soon as the lock is released
+        std::lock_guard<std::mutex> const lock{_mutex};
+        if (exception && !_taskException) {
+            _taskException = exception;
+        }
+        _freeSlots.push_back(slot);
+        _condition.notify_all();
+    });
+}
+
+void ConcurrentInputProcessor::wait() {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _condition.wait(lock, [this]() { return _freeSlots.size() == _plan.concurrentInputs; });
+    _rethrowTaskException();
+}
+
+ConcurrencyPlan const& ConcurrentInputProcessor::getPlan() const {
+    return _plan;
+}
+
+void ConcurrentInputProcessor::_rethrowTaskException() {
+    if (_taskException) {
+        std::rethrow_exception(_taskException);
+    }
+}
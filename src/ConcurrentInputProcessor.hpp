@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <tbb/task_arena.h>
+
+
+// How many antenna inputs a node processes at once, and how its threads are shared between them.
+struct ConcurrencyPlan {
+    // Number of antenna inputs processed concurrently.
+    unsigned concurrentInputs;
+    // Number of threads MKL may use within the processing of each antenna input.
+    unsigned threadsPerInput;
+};
+
+
+// Works out how many antenna inputs to process at once: as many as fit in memoryBudget bytes (each needing inputMemory
+// bytes while it is processed), up to numThreads and maxConcurrentInputs (0 for no limit besides the others). At least
+// 1 antenna input is always processed, even if it doesn't fit. The threads are split evenly between the antenna inputs.
+// If inputMemory is 0 (unknown), the budget isn't applied.
+ConcurrencyPlan planConcurrency(std::size_t memoryBudget, std::size_t inputMemory, unsigned numThreads,
+                                unsigned maxConcurrentInputs);
+
+// As above, using the memory budget and number of concurrent inputs from the app configuration, and all the threads
+// available to this process.
+ConcurrencyPlan planConcurrency(AppConfig const& appConfig, std::size_t inputMemory);
+
+// Gets the number of threads available to this process.
+unsigned getAvailableThreads();
+
+
+// Runs the processing of antenna inputs as tasks in a TBB task arena holding all of the node's threads, with at most
+// plan.concurrentInputs tasks running at once. TBB parallel loops and MKL functions (which use TBB for threading) called
+// by the tasks run in the same arena, so the tasks share the node's threads rather than oversubscribing them.
+class ConcurrentInputProcessor {
+public:
+    // Processes one antenna input. slot is in the range [0, plan.concurrentInputs) and is only used by one task at a
+    // time, so state kept for each slot (e.g. a ProcessingPlan) can be reused by the tasks without locking.
+    using Task = std::function<void(unsigned slot)>;
+
+    ConcurrentInputProcessor(ConcurrencyPlan const& plan, unsigned numThreads);
+    ConcurrentInputProcessor(ConcurrentInputProcessor const&) = delete;
+    ConcurrentInputProcessor(ConcurrentInputProcessor&&) = delete;
+
+    // Waits for any tasks still running to finish. Their exceptions are discarded.
+    ~ConcurrentInputProcessor();
+
+    // Starts a task once a slot is free, waiting for one if there isn't.
+    // Throws the exception thrown by an earlier task, if any, in which case the task isn't started.
+    void run(Task task);
+
+    // Waits for all the tasks started so far to finish.
+    // Throws the exception thrown by a task, if any.
+    void wait();
+
+    ConcurrencyPlan const& getPlan() const;
+
+    ConcurrentInputProcessor& operator=(ConcurrentInputProcessor const&) = delete;
+    ConcurrentInputProcessor& operator=(ConcurrentInputProcessor&&) = delete;
+
+private:
+    // Throws the exception thrown by a task, if any. _mutex must be held.
+    void _rethrowTaskException();
+
+    ConcurrencyPlan const _plan;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    // Slots not being used by a running task.
+    std::vector<unsigned> _freeSlots;
+    // The first exception thrown by a task.
+    std::exception_ptr _taskException;
+    tbb::task_arena _arena;
+};
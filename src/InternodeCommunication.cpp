@@ -4,10 +4,12 @@
 #include <array>
 #include <atomic>
 #include <cstddef>
+#include <limits>
 #include <map>
 #include <memory>
 #include <numeric>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -183,6 +185,70 @@ void InternodeCommunicator::indicateError() {
     _context->_errorCommunicator.indicateError();
 }
 
+// Converts byte sizes to the int counts and displacements MPI_Alltoallv() takes.
+static std::pair<std::vector<int>, std::vector<int>> getExchangeCounts(std::vector<std::size_t> const& sizes,
+                                                                        unsigned nodeCount) {
+    if (sizes.size() != nodeCount) {
+        throw std::invalid_argument{"There must be a data size for each node."};
+    }
+    std::vector<int> counts;
+    std::vector<int> displacements;
+    std::size_t displacement = 0;
+    for (auto const size : sizes) {
+        if (size > std::numeric_limits<int>::max() || displacement > std::numeric_limits<int>::max()) {
+            throw std::invalid_argument{"Too much data to exchange at once."};
+        }
+        counts.push_back(static_cast<int>(size));
+        displacements.push_back(static_cast<int>(displacement));
+        displacement += size;
+    }
+    return {counts, displacements};
+}
+
+std::vector<std::int8_t> InternodeCommunicator::exchangeData(std::vector<std::int8_t> const& sendData,
+                                                             std::vector<std::size_t> const& sendSizes,
+                                                             std::vector<std::size_t> const& receiveSizes) const {
+    auto const nodeCount = getNodeCount();
+    auto const [sendCounts, sendDisplacements] = getExchangeCounts(sendSizes, nodeCount);
+    auto const [receiveCounts, receiveDisplacements] = getExchangeCounts(receiveSizes, nodeCount);
+    if (sendData.size() != std::accumulate(sendSizes.begin(), sendSizes.end(), std::size_t{0})) {
+        throw std::invalid_argument{"Send data size must be the total of the send sizes."};
+    }
+
+    std::vector<std::int8_t> receiveData(std::accumulate(receiveSizes.begin(), receiveSizes.end(), std::size_t{0}));
+    assertMPISuccess(MPI_Alltoallv(sendData.data(), sendCounts.data(), sendDisplacements.data(), MPI_INT8_T,
+                                   receiveData.data(), receiveCounts.data(), receiveDisplacements.data(), MPI_INT8_T,
+                                   MPI_COMM_WORLD));
+    return receiveData;
+}
+
+std::set<unsigned> InternodeCommunicator::uniteChannels(std::set<unsigned> const& channels) const {
+    auto const nodeCount = getNodeCount();
+
+    // First get the number of channels from each node, then the channels themselves.
+    int const channelCount = channels.size();
+    std::vector<int> channelCounts(nodeCount);
+    assertMPISuccess(MPI_Allgather(&channelCount, 1, MPI_INT, channelCounts.data(), 1, MPI_INT, MPI_COMM_WORLD));
+    std::vector<int> displacements(nodeCount);
+    std::exclusive_scan(channelCounts.begin(), channelCounts.end(), displacements.begin(), 0);
+
+    std::vector<unsigned> const sendChannels(channels.begin(), channels.end());
+    std::vector<unsigned> allChannels(std::accumulate(channelCounts.begin(), channelCounts.end(), std::size_t{0}));
+    assertMPISuccess(MPI_Allgatherv(sendChannels.data(), channelCount, MPI_UNSIGNED, allChannels.data(),
+                                    channelCounts.data(), displacements.data(), MPI_UNSIGNED, MPI_COMM_WORLD));
+    return {allChannels.begin(), allChannels.end()};
+}
+
+std::vector<unsigned long long> InternodeCommunicator::broadcastValues(std::vector<unsigned long long> values) const {
+    assertMPISuccess(MPI_Bcast(values.data(), values.size(), MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD));
+    return values;
+}
+
+unsigned long long InternodeCommunicator::getMinimum(unsigned long long value) const {
+    assertMPISuccess(MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_UNSIGNED_LONG_LONG, MPI_MIN, MPI_COMM_WORLD));
+    return value;
+}
+
 
 // For the following communication functions, I will note that I am not an MPI expert.
 // There are likely better ways to do some of this communication, for example using custom MPI datatypes for our
@@ -223,10 +289,23 @@ void PrimaryNodeCommunicator::sendAppConfig(AppConfig const& appConfig) const {
     auto const& outputDirectoryPath = appConfig.outputDirectoryPath;
 
     // First we will send the fixed-size data, including sizes of the variable-size data (strings).
-    std::array<unsigned long long, 6> part1Buffer{
+    std::array<unsigned long long, 19> part1Buffer{
         appConfig.observationID,
         appConfig.signalStartTime,
         appConfig.ignoreErrors,
+        appConfig.memoryBudget,
+        appConfig.prefetchDepth,
+        static_cast<unsigned long long>(appConfig.remappingMode),
+        appConfig.concurrentInputs,
+        appConfig.inputBatchSize,
+        static_cast<unsigned long long>(appConfig.schedulingMode),
+        static_cast<unsigned long long>(appConfig.decompositionMode),
+        appConfig.sharedMemory,
+        static_cast<unsigned long long>(appConfig.outputFormat),
+        appConfig.collectiveWrites,
+        appConfig.writeBehindDepth,
+        static_cast<unsigned long long>(appConfig.outputBackend),
+        appConfig.overlapSave,
         inputDirectoryPath.size(),
         invPolyphaseFilterPath.size(),
         outputDirectoryPath.size()
@@ -265,6 +344,15 @@ void PrimaryNodeCommunicator::sendAntennaConfig(AntennaConfig const& antennaConf
     assertMPISuccess(MPI_Bcast(part2Buffer.data(), part2Buffer.size(), MPI_UNSIGNED, 0, MPI_COMM_WORLD));
 }
 
+void PrimaryNodeCommunicator::sendFilterCoefficients(std::vector<std::complex<float>> const& coefficients) const {
+    // First the number of coefficients, then the coefficients themselves, as they are laid out in memory.
+    unsigned long long size = coefficients.size();
+    assertMPISuccess(MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD));
+    // MPI_Bcast() doesn't take a const buffer, but the primary node's buffer is only read.
+    assertMPISuccess(MPI_Bcast(const_cast<std::complex<float>*>(coefficients.data()), coefficients.size(),
+                               MPI_C_FLOAT_COMPLEX, 0, MPI_COMM_WORLD));
+}
+
 void PrimaryNodeCommunicator::sendChannelRemapping(ChannelRemapping const& channelRemapping) const {
     // First we will send the fixed-size data, include the size of the channel map.
     std::array<unsigned, 2> part1Buffer{
@@ -285,6 +373,10 @@ void PrimaryNodeCommunicator::sendChannelRemapping(ChannelRemapping const& chann
     assertMPISuccess(MPI_Bcast(part2Buffer.data(), part2Buffer.size(), MPI_UNSIGNED, 0, MPI_COMM_WORLD));
 }
 
+void PrimaryNodeCommunicator::sendOutputContainerStatus(bool created) const {
+    assertMPISuccess(MPI_Bcast(&created, 1, MPI_CXX_BOOL, 0, MPI_COMM_WORLD));
+}
+
 void PrimaryNodeCommunicator::sendAntennaInputAssignment(unsigned node,
         std::optional<AntennaInputRange> const& antennaInputAssignment) const {
     if (node == 0) {
@@ -371,6 +463,27 @@ std::map<unsigned, ObservationProcessingResults> PrimaryNodeCommunicator::receiv
     assertMPISuccess(MPI_Gatherv(&dummyRootUsedChannel, 0, MPI_UNSIGNED, usedChannels.data(),
         perNodeUsedChannelCounts.data(), usedChannelDisplacements.data(), MPI_UNSIGNED, 0, MPI_COMM_WORLD));
 
+    // Next we will receive the stage measurements per antenna input from each secondary node. Each antenna input has
+    // the time of every stage, then the bytes and samples of every stage.
+    std::vector<int> stageCounts(nodeCount);
+    std::vector<int> stageDisplacements(nodeCount);
+    for (std::size_t node = 0; node < nodeCount; ++node) {
+        stageCounts.at(node) = antennaInputCounts.at(node) * NUM_PROCESSING_STAGES;
+        stageDisplacements.at(node) = antennaInputDisplacements.at(node) * NUM_PROCESSING_STAGES;
+    }
+    std::vector<double> stageSeconds(totalAntennaInputs * NUM_PROCESSING_STAGES);
+    double const dummyRootStageSeconds = 0.0;
+    assertMPISuccess(MPI_Gatherv(&dummyRootStageSeconds, 0, MPI_DOUBLE, stageSeconds.data(), stageCounts.data(),
+        stageDisplacements.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD));
+    for (std::size_t node = 0; node < nodeCount; ++node) {
+        stageCounts.at(node) *= 2;
+        stageDisplacements.at(node) *= 2;
+    }
+    std::vector<unsigned long long> stageAmounts(totalAntennaInputs * NUM_PROCESSING_STAGES * 2);
+    unsigned long long const dummyRootStageAmount = 0;
+    assertMPISuccess(MPI_Gatherv(&dummyRootStageAmount, 0, MPI_UNSIGNED_LONG_LONG, stageAmounts.data(),
+        stageCounts.data(), stageDisplacements.data(), MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD));
+
     // Finally we combine all the received data.
     std::map<unsigned, ObservationProcessingResults> result;
     auto usedChannelIt = usedChannels.cbegin();
@@ -382,11 +495,20 @@ std::map<unsigned, ObservationProcessingResults> PrimaryNodeCommunicator::receiv
             auto const antennaInput = antennaInputs.at(antennaInputDisplacement + antennaInputIdx);
             auto const success = successes.at(antennaInputDisplacement + antennaInputIdx);
             auto const usedChannelCount = usedChannelCounts.at(antennaInputDisplacement + antennaInputIdx);
+            StageMeasurements stageMeasurements{};
+            std::size_t const stageIdx = (antennaInputDisplacement + antennaInputIdx) * NUM_PROCESSING_STAGES;
+            for (std::size_t stage = 0; stage < NUM_PROCESSING_STAGES; ++stage) {
+                stageMeasurements.at(stage).seconds = stageSeconds.at(stageIdx + stage);
+                stageMeasurements.at(stage).bytes = stageAmounts.at(2 * stageIdx + stage);
+                stageMeasurements.at(stage).samples = stageAmounts.at(2 * stageIdx + NUM_PROCESSING_STAGES + stage);
+            }
             nodeResults.results.emplace(
                 antennaInput,
                 AntennaInputProcessingResults{
                     static_cast<bool>(success),
-                    {usedChannelIt, usedChannelIt + usedChannelCount}
+                    {usedChannelIt, usedChannelIt + usedChannelCount},
+                    stageMeasurements,
+                    node
                 });
             usedChannelIt += usedChannelCount;
         }
@@ -418,12 +540,25 @@ void SecondaryNodeCommunicator::sendNodeSetupStatus(bool status) const {
 
 AppConfig SecondaryNodeCommunicator::receiveAppConfig() const {
     // Receive the fixed-size data.
-    std::array<unsigned long long, 6> part1Buffer{};
+    std::array<unsigned long long, 19> part1Buffer{};
     assertMPISuccess(MPI_Bcast(part1Buffer.data(), part1Buffer.size(), MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD));
     auto const [
         observationID,
         signalStartTime,
         ignoreErrors,
+        memoryBudget,
+        prefetchDepth,
+        remappingMode,
+        concurrentInputs,
+        inputBatchSize,
+        schedulingMode,
+        decompositionMode,
+        sharedMemory,
+        outputFormat,
+        collectiveWrites,
+        writeBehindDepth,
+        outputBackend,
+        overlapSave,
         inputDirectoryPathSize,
         invPolyphaseFilterPathSize,
         outputDirectoryPathSize
@@ -439,7 +574,20 @@ AppConfig SecondaryNodeCommunicator::receiveAppConfig() const {
         static_cast<unsigned>(signalStartTime),
         {part2Buffer.data() + inputDirectoryPathSize, invPolyphaseFilterPathSize},
         {part2Buffer.data() + inputDirectoryPathSize + invPolyphaseFilterPathSize, outputDirectoryPathSize},
-        static_cast<bool>(ignoreErrors)
+        static_cast<bool>(ignoreErrors),
+        static_cast<unsigned>(memoryBudget),
+        static_cast<unsigned>(prefetchDepth),
+        static_cast<RemappingMode>(remappingMode),
+        static_cast<unsigned>(concurrentInputs),
+        static_cast<unsigned>(inputBatchSize),
+        static_cast<SchedulingMode>(schedulingMode),
+        static_cast<DecompositionMode>(decompositionMode),
+        static_cast<bool>(sharedMemory),
+        static_cast<OutputFormat>(outputFormat),
+        static_cast<bool>(collectiveWrites),
+        static_cast<unsigned>(writeBehindDepth),
+        static_cast<OutputBackend>(outputBackend),
+        static_cast<bool>(overlapSave)
     };
 }
 
@@ -468,6 +616,14 @@ AntennaConfig SecondaryNodeCommunicator::receiveAntennaConfig() const {
     return result;
 }
 
+std::vector<std::complex<float>> SecondaryNodeCommunicator::receiveFilterCoefficients() const {
+    unsigned long long size = 0;
+    assertMPISuccess(MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD));
+    std::vector<std::complex<float>> coefficients(size);
+    assertMPISuccess(MPI_Bcast(coefficients.data(), coefficients.size(), MPI_C_FLOAT_COMPLEX, 0, MPI_COMM_WORLD));
+    return coefficients;
+}
+
 ChannelRemapping SecondaryNodeCommunicator::receiveChannelRemapping() const {
     // Receive the fixed-size data.
     std::array<unsigned, 2> part1Buffer{};
@@ -488,6 +644,12 @@ ChannelRemapping SecondaryNodeCommunicator::receiveChannelRemapping() const {
     return result;
 }
 
+bool SecondaryNodeCommunicator::receiveOutputContainerStatus() const {
+    bool created = false;
+    assertMPISuccess(MPI_Bcast(&created, 1, MPI_CXX_BOOL, 0, MPI_COMM_WORLD));
+    return created;
+}
+
 std::optional<AntennaInputRange> SecondaryNodeCommunicator::receiveAntennaInputAssignment() const {
     std::array<unsigned, 3> buffer{};
     assertMPISuccess(
@@ -515,12 +677,23 @@ void SecondaryNodeCommunicator::sendProcessingResults(ObservationProcessingResul
     usedChannelCounts.reserve(antennaInputCount);
     std::vector<unsigned> usedChannels;
     usedChannels.reserve(antennaInputCount * 24ull);        // Approxmiate based on max number of channels.
+    std::vector<double> stageSeconds;
+    stageSeconds.reserve(antennaInputCount * NUM_PROCESSING_STAGES);
+    std::vector<unsigned long long> stageAmounts;
+    stageAmounts.reserve(antennaInputCount * NUM_PROCESSING_STAGES * 2);
     for (auto const& [antennaInput, antennaInputResult] : results.results) {
         antennaInputs.push_back(antennaInput);
         successes.push_back(static_cast<char>(antennaInputResult.success));
         usedChannelCounts.push_back(static_cast<unsigned>(antennaInputResult.usedChannels.size()));
         usedChannels.insert(usedChannels.cend(), antennaInputResult.usedChannels.cbegin(),
             antennaInputResult.usedChannels.cend());
+        for (auto const& measurement : antennaInputResult.stageMeasurements) {
+            stageSeconds.push_back(measurement.seconds);
+            stageAmounts.push_back(measurement.bytes);
+        }
+        for (auto const& measurement : antennaInputResult.stageMeasurements) {
+            stageAmounts.push_back(measurement.samples);
+        }
     }
 
     // Next we will send the list of antenna inputs to the primary node.
@@ -535,7 +708,287 @@ void SecondaryNodeCommunicator::sendProcessingResults(ObservationProcessingResul
     assertMPISuccess(MPI_Gatherv(usedChannelCounts.data(), antennaInputCount, MPI_UNSIGNED, nullptr, nullptr, nullptr,
         MPI_CHAR, 0, MPI_COMM_WORLD));
 
-    // Finally we will send the list of used channels per antenna input to the primary node.
+    // Next we will send the list of used channels per antenna input to the primary node.
     assertMPISuccess(MPI_Gatherv(usedChannels.data(), usedChannels.size(), MPI_UNSIGNED, nullptr, nullptr, nullptr,
         MPI_UNSIGNED, 0, MPI_COMM_WORLD));
+
+    // Finally we will send the stage measurements per antenna input to the primary node.
+    assertMPISuccess(MPI_Gatherv(stageSeconds.data(), stageSeconds.size(), MPI_DOUBLE, nullptr, nullptr, nullptr,
+        MPI_DOUBLE, 0, MPI_COMM_WORLD));
+    assertMPISuccess(MPI_Gatherv(stageAmounts.data(), stageAmounts.size(), MPI_UNSIGNED_LONG_LONG, nullptr, nullptr,
+        nullptr, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD));
+}
+
+
+// Messages sent by AntennaInputRequester to AntennaInputDistributor.
+enum class AntennaInputRequest : unsigned {
+    NEXT_CHUNK = 1,
+    NODE_FINISHED
+};
+
+// Creates a copy of MPI_COMM_WORLD, so dynamic scheduling requests don't interfere with the main communication.
+static MPI_Comm createSchedulingCommunicator() {
+    MPI_Comm communicator;
+    assertMPISuccess(MPI_Comm_dup(MPI_COMM_WORLD, &communicator));
+    return communicator;
+}
+
+
+AntennaInputDistributor::AntennaInputDistributor(PrimaryNodeCommunicator const& communicator,
+                                                 AntennaInputScheduler scheduler) :
+    _context{communicator.getContext()},
+    _communicator{createSchedulingCommunicator()},
+    _mutex{},
+    _scheduler{std::move(scheduler)},
+    _thread{&AntennaInputDistributor::_threadFunc, this}
+{}
+
+AntennaInputDistributor::~AntennaInputDistributor() {
+    {
+        // If we are stopping early (i.e. after an error), the secondary nodes are told there is nothing left, so they
+        // finish up rather than waiting for a reply forever.
+        std::lock_guard<std::mutex> const lock{_mutex};
+        _scheduler.cancel();
+    }
+    _thread.join();
+
+    MPI_Comm_free(&_communicator);
+}
+
+std::optional<AntennaInputRange> AntennaInputDistributor::next() {
+    std::lock_guard<std::mutex> const lock{_mutex};
+    return _scheduler.next(0);
+}
+
+void AntennaInputDistributor::_threadFunc() {
+    int nodeCount = 0;
+    assertMPISuccess(MPI_Comm_size(_communicator, &nodeCount));
+
+    // Each secondary node finishes either when it is told there are no antenna inputs left, or when it gives up.
+    auto activeNodes = nodeCount - 1;
+    while (activeNodes > 0) {
+        unsigned message = 0;
+        MPI_Status status;
+        assertMPISuccess(MPI_Recv(&message, 1, MPI_UNSIGNED, MPI_ANY_SOURCE, 0, _communicator, &status));
+        if (static_cast<AntennaInputRequest>(message) == AntennaInputRequest::NEXT_CHUNK) {
+            std::optional<AntennaInputRange> chunk;
+            {
+                std::lock_guard<std::mutex> const lock{_mutex};
+                chunk = _scheduler.next(status.MPI_SOURCE);
+            }
+
+            // Same representation as the antenna input assignment.
+            std::array<unsigned, 3> buffer;
+            if (chunk) {
+                buffer = {true, chunk.value().begin, chunk.value().end};
+            }
+            else {
+                buffer = {false, 0, 0};
+                activeNodes--;
+            }
+            assertMPISuccess(MPI_Send(buffer.data(), buffer.size(), MPI_UNSIGNED, status.MPI_SOURCE, 0, _communicator));
+        }
+        else if (static_cast<AntennaInputRequest>(message) == AntennaInputRequest::NODE_FINISHED) {
+            activeNodes--;
+        }
+    }
+}
+
+
+AntennaInputRequester::AntennaInputRequester(SecondaryNodeCommunicator const& communicator) :
+    _context{communicator.getContext()},
+    _communicator{createSchedulingCommunicator()},
+    _finished{false}
+{}
+
+AntennaInputRequester::~AntennaInputRequester() {
+    // Disable the warning about throwing exceptions in destructors causing program termination.
+    // That's exactly the behaviour we want (we cannot recover from an MPI error, which should never occur anyway).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wterminate"
+
+    if (!_finished) {
+        auto const message = static_cast<unsigned>(AntennaInputRequest::NODE_FINISHED);
+        assertMPISuccess(MPI_Send(&message, 1, MPI_UNSIGNED, 0, 0, _communicator));
+    }
+
+#pragma GCC diagnostic pop
+
+    MPI_Comm_free(&_communicator);
+}
+
+std::optional<AntennaInputRange> AntennaInputRequester::next() {
+    if (_finished) {
+        return std::nullopt;
+    }
+
+    // The receive for the reply is posted before the request is sent, so the reply never needs to be buffered.
+    std::array<unsigned, 3> buffer{};
+    std::array<MPI_Request, 2> requests;
+    assertMPISuccess(MPI_Irecv(buffer.data(), buffer.size(), MPI_UNSIGNED, 0, 0, _communicator, &requests[0]));
+    auto const message = static_cast<unsigned>(AntennaInputRequest::NEXT_CHUNK);
+    assertMPISuccess(MPI_Isend(&message, 1, MPI_UNSIGNED, 0, 0, _communicator, &requests[1]));
+    assertMPISuccess(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+
+    auto const [hasValue, begin, end] = buffer;
+    if (hasValue) {
+        return AntennaInputRange{begin, end};
+    }
+    else {
+        _finished = true;
+        return std::nullopt;
+    }
+}
+
+
+HostSharedCoefficients::HostSharedCoefficients(InternodeCommunicator const& communicator,
+                                               std::vector<std::complex<float>> coefficients) :
+    _context{communicator.getContext()},
+    _hostCommunicator{MPI_COMM_NULL},
+    _window{MPI_WIN_NULL},
+    _data{nullptr},
+    _size{0}
+{
+    // Ordered by node ID, so the primary node is always the first process on its host.
+    assertMPISuccess(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, communicator.getNodeID(),
+                                         MPI_INFO_NULL, &_hostCommunicator));
+    int hostRank = 0;
+    assertMPISuccess(MPI_Comm_rank(_hostCommunicator, &hostRank));
+    bool const hostLeader = hostRank == 0;
+
+    // Only the first process on each host takes part in sending the coefficients between hosts, so the primary node
+    // (which is also ordered first here) sends them once per host rather than once per process.
+    MPI_Comm leaderCommunicator = MPI_COMM_NULL;
+    assertMPISuccess(MPI_Comm_split(MPI_COMM_WORLD, hostLeader ? 0 : MPI_UNDEFINED, communicator.getNodeID(),
+                                    &leaderCommunicator));
+
+    unsigned long long size = coefficients.size();
+    if (hostLeader) {
+        assertMPISuccess(MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, 0, leaderCommunicator));
+    }
+    assertMPISuccess(MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, 0, _hostCommunicator));
+    _size = size;
+
+    // Only the first process allocates any memory, the others map it.
+    void* memory = nullptr;
+    auto const memorySize = static_cast<MPI_Aint>(hostLeader ? _size * sizeof(std::complex<float>) : 0);
+    assertMPISuccess(MPI_Win_allocate_shared(memorySize, sizeof(std::complex<float>), MPI_INFO_NULL, _hostCommunicator,
+                                             &memory, &_window));
+    if (!hostLeader) {
+        MPI_Aint sharedSize = 0;
+        int displacementUnit = 0;
+        assertMPISuccess(MPI_Win_shared_query(_window, 0, &sharedSize, &displacementUnit, &memory));
+    }
+
+    // The other processes may only read the coefficients once the first one has finished writing them.
+    assertMPISuccess(MPI_Win_lock_all(MPI_MODE_NOCHECK, _window));
+    if (hostLeader) {
+        auto const sharedCoefficients = static_cast<std::complex<float>*>(memory);
+        if (communicator.getNodeID() == 0) {
+            std::copy(coefficients.begin(), coefficients.end(), sharedCoefficients);
+            // Not needed any more now they're in the shared memory
+            coefficients = {};
+        }
+        assertMPISuccess(MPI_Bcast(sharedCoefficients, _size, MPI_C_FLOAT_COMPLEX, 0, leaderCommunicator));
+        assertMPISuccess(MPI_Comm_free(&leaderCommunicator));
+    }
+    assertMPISuccess(MPI_Win_sync(_window));
+    assertMPISuccess(MPI_Barrier(_hostCommunicator));
+    assertMPISuccess(MPI_Win_sync(_window));
+    assertMPISuccess(MPI_Win_unlock_all(_window));
+    _data = static_cast<std::complex<float> const*>(memory);
+}
+
+HostSharedCoefficients::~HostSharedCoefficients() {
+    MPI_Win_free(&_window);
+    MPI_Comm_free(&_hostCommunicator);
+}
+
+std::complex<float> const* HostSharedCoefficients::data() const {
+    return _data;
+}
+
+std::size_t HostSharedCoefficients::size() const {
+    return _size;
+}
+
+unsigned HostSharedCoefficients::getHostProcessCount() const {
+    int processCount = 0;
+    assertMPISuccess(MPI_Comm_size(_hostCommunicator, &processCount));
+    return processCount;
+}
+
+
+CollectiveOutputFile::CollectiveOutputFile(InternodeCommunicator const& communicator, std::string const& path) :
+    _context{communicator.getContext()},
+    _file{MPI_FILE_NULL}
+{
+    // Collective buffering gathers the nodes' writes onto one aggregator process per host, which write large
+    // contiguous runs of the file.
+    MPI_Info info = MPI_INFO_NULL;
+    assertMPISuccess(MPI_Info_create(&info));
+    assertMPISuccess(MPI_Info_set(info, "romio_cb_write", "enable"));
+    assertMPISuccess(MPI_Info_set(info, "cb_config_list", "*:1"));
+    // File errors are returned rather than aborting (the default error handler for files), and are reported here.
+    int const openResult = MPI_File_open(MPI_COMM_WORLD, path.c_str(), MPI_MODE_WRONLY, info, &_file);
+    MPI_Info_free(&info);
+
+    // Opening may fail on only some nodes (e.g. if the file isn't visible to some hosts), so they all agree on it.
+    int opened = openResult == MPI_SUCCESS;
+    assertMPISuccess(MPI_Allreduce(MPI_IN_PLACE, &opened, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD));
+    if (!opened) {
+        if (openResult == MPI_SUCCESS) {
+            MPI_File_close(&_file);
+        }
+        throw std::runtime_error{"Failed to open " + path + " for collective writes"};
+    }
+}
+
+CollectiveOutputFile::~CollectiveOutputFile() {
+    MPI_File_close(&_file);
+}
+
+CollectiveWriteRound CollectiveOutputFile::writeRound(std::vector<CollectiveWrite> const& writes, bool finished,
+                                                      bool error) const {
+    // Pieces larger than MPI can write at once are split, keeping track of which piece each part is from.
+    constexpr std::size_t maxPartSize = std::numeric_limits<int>::max();
+    std::vector<std::pair<std::size_t, CollectiveWrite>> parts;
+    for (std::size_t i = 0; i < writes.size(); i++) {
+        auto const& write = writes[i];
+        std::size_t partOffset = 0;
+        do {
+            auto const partSize = std::min(write.size - partOffset, maxPartSize);
+            parts.push_back({i, {write.offset + partOffset, static_cast<char const*>(write.data) + partOffset,
+                                 partSize}});
+            partOffset += partSize;
+        } while (partOffset < write.size);
+    }
+
+    // Every node makes as many collective write calls as the node with the most parts.
+    std::array<unsigned long long, 3> status{parts.size(), !finished, error};
+    assertMPISuccess(MPI_Allreduce(MPI_IN_PLACE, status.data(), status.size(), MPI_UNSIGNED_LONG_LONG, MPI_MAX,
+                                   MPI_COMM_WORLD));
+    auto const [maxParts, anyUnfinished, anyError] = status;
+    CollectiveWriteRound result{std::vector<bool>(writes.size(), anyError == 0), anyUnfinished == 0, anyError != 0};
+    if (result.error) {
+        return result;
+    }
+
+    for (unsigned long long part = 0; part < maxParts; part++) {
+        MPI_Status writeStatus;
+        if (part < parts.size()) {
+            auto const& [index, write] = parts[part];
+            int const size = static_cast<int>(write.size);
+            int written = 0;
+            if (MPI_File_write_at_all(_file, write.offset, write.data, size, MPI_BYTE, &writeStatus) != MPI_SUCCESS
+                    || MPI_Get_count(&writeStatus, MPI_BYTE, &written) != MPI_SUCCESS || written != size) {
+                result.written[index] = false;
+            }
+        }
+        else {
+            // Nothing left to write, but still takes part in the collective write.
+            MPI_File_write_at_all(_file, 0, nullptr, 0, MPI_BYTE, &writeStatus);
+        }
+    }
+    return result;
 }
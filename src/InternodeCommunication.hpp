@@ -1,12 +1,21 @@
 #pragma once
 
+#include "NodeAntennaInputAssigner.hpp"
+
 #include <atomic>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <variant>
+#include <vector>
 
 #include <mpi.h>
 
@@ -125,6 +134,30 @@ public:
     // Indicates to all nodes that an error has occurred.
     void indicateError();
 
+    // Sends data to and receives data from every node (including this one) at once. sendData holds sendSizes[n] bytes
+    // for each node n, one after another in node order, and receiveSizes[n] bytes are received from each node n, which
+    // are returned in the same way. Both sizes must have an element for each node, and must match the sizes given by
+    // the other nodes.
+    // All nodes must call this at the same time.
+    // Throws std::invalid_argument if there are the wrong number of sizes, or more data than MPI can send at once.
+    std::vector<std::int8_t> exchangeData(std::vector<std::int8_t> const& sendData,
+                                          std::vector<std::size_t> const& sendSizes,
+                                          std::vector<std::size_t> const& receiveSizes) const;
+
+    // Gets the union of the sets of channels given by every node.
+    // All nodes must call this at the same time.
+    std::set<unsigned> uniteChannels(std::set<unsigned> const& channels) const;
+
+    // Gets the values given by the primary node, so work which only needs doing once (e.g. reading a file header) is
+    // only done by the primary node. values must have the same number of elements on every node, and those given by
+    // the secondary nodes are ignored.
+    // All nodes must call this at the same time.
+    std::vector<unsigned long long> broadcastValues(std::vector<unsigned long long> values) const;
+
+    // Gets the smallest of the values given by every node.
+    // All nodes must call this at the same time.
+    unsigned long long getMinimum(unsigned long long value) const;
+
     InternodeCommunicator& operator=(InternodeCommunicator const&) = default;
     InternodeCommunicator& operator=(InternodeCommunicator&&) = default;
 
@@ -157,6 +190,10 @@ public:
     // Corresponding receive method is SecondaryNodeCommunicator::receiveAppConfig().
     void sendAppConfig(AppConfig const& appConfig) const;
 
+    // Sends the inverse polyphase filter coefficients to all the secondary nodes, so only the primary node reads them.
+    // Corresponding receive method is SecondaryNodeCommunicator::receiveFilterCoefficients().
+    void sendFilterCoefficients(std::vector<std::complex<float>> const& coefficients) const;
+
     // Sends the antenna input configuration to all the secondary nodes.
     // Corresponding receive method is SecondaryNodeCommunicator::receiveAntennaConfig().
     void sendAntennaConfig(AntennaConfig const& antennaConfig) const;
@@ -165,6 +202,10 @@ public:
     // Corresponding receive method is SecondaryNodeCommunicator::receiveChannelRemapping().
     void sendChannelRemapping(ChannelRemapping const& channelRemapping) const;
 
+    // Sends whether the output container was created to all the secondary nodes, so they only write into it if it was.
+    // Corresponding receive method is SecondaryNodeCommunicator::receiveOutputContainerStatus().
+    void sendOutputContainerStatus(bool created) const;
+
     // Sends a secondary node's antenna input assignment to that node.
     // Corresponding receive method is SecondaryNodeCommunicator::receiveAntennaInputAssignment().
     void sendAntennaInputAssignment(unsigned node, std::optional<AntennaInputRange> const& antennaInputAssignment) const;
@@ -201,6 +242,10 @@ public:
     // Corresponding send method is PrimaryNodeCommunicator::sendAppConfig().
     AppConfig receiveAppConfig() const;
 
+    // Receives the inverse polyphase filter coefficients.
+    // Corresponding send method is PrimaryNodeCommunicator::sendFilterCoefficients().
+    std::vector<std::complex<float>> receiveFilterCoefficients() const;
+
     // Receives the antenna input configuration.
     // Corresponding send method is PrimaryNodeCommunicator::sendAntennaConfig().
     AntennaConfig receiveAntennaConfig() const;
@@ -209,6 +254,10 @@ public:
     // Corresponding send method is PrimaryNodeCommunicator::sendChannelRemapping().
     ChannelRemapping receiveChannelRemapping() const;
 
+    // Receives whether the output container was created.
+    // Corresponding send method is PrimaryNodeCommunicator::sendOutputContainerStatus().
+    bool receiveOutputContainerStatus() const;
+
     // Receives the antenna input assignment for this node.
     // Corresponding send method is PrimaryNodeCommunicator::sendAntennaInputAssignment().
     std::optional<AntennaInputRange> receiveAntennaInputAssignment() const;
@@ -222,6 +271,157 @@ public:
 };
 
 
+// The primary node's side of dynamic scheduling: hands out chunks of antenna inputs from an AntennaInputScheduler to
+// the secondary nodes as they request them (via AntennaInputRequester).
+// Requests are answered by a background thread, so the primary node processes its own antenna inputs (taken with
+// next()) at the same time.
+// Must be constructed at the same point as the AntennaInputRequester of every secondary node, since they create a
+// separate MPI communicator together.
+class AntennaInputDistributor {
+public:
+    // scheduler must have one node for each node in the communicator.
+    AntennaInputDistributor(PrimaryNodeCommunicator const& communicator, AntennaInputScheduler scheduler);
+    AntennaInputDistributor(AntennaInputDistributor const&) = delete;
+    AntennaInputDistributor(AntennaInputDistributor&&) = delete;
+
+    // Stops handing out antenna inputs and waits for every secondary node to finish requesting them.
+    ~AntennaInputDistributor();
+
+    // Gets the next chunk of antenna inputs for the primary node to process, or an empty optional once all have been
+    // handed out.
+    std::optional<AntennaInputRange> next();
+
+    AntennaInputDistributor& operator=(AntennaInputDistributor const&) = delete;
+    AntennaInputDistributor& operator=(AntennaInputDistributor&&) = delete;
+
+private:
+    // Share ownership of the InternodeCommunicationContext so MPI isn't terminated while the thread is running.
+    std::shared_ptr<InternodeCommunicationContext> _context;
+    // MPI communicator for the requests, separate so they don't interfere with the main communication.
+    MPI_Comm _communicator;
+    std::mutex _mutex;
+    AntennaInputScheduler _scheduler;
+    // Background thread to answer requests from the secondary nodes.
+    std::thread _thread;
+
+    // Loop that answers requests until every secondary node has finished.
+    void _threadFunc();
+};
+
+
+// A secondary node's side of dynamic scheduling: requests chunks of antenna inputs from the AntennaInputDistributor.
+// Must be constructed at the same point as the AntennaInputDistributor on the primary node, since they create a
+// separate MPI communicator together.
+class AntennaInputRequester {
+public:
+    AntennaInputRequester(SecondaryNodeCommunicator const& communicator);
+    AntennaInputRequester(AntennaInputRequester const&) = delete;
+    AntennaInputRequester(AntennaInputRequester&&) = delete;
+
+    // Tells the primary node this node won't request any more antenna inputs, if it hasn't run out of them already
+    // (e.g. because processing failed).
+    ~AntennaInputRequester();
+
+    // Requests the next chunk of antenna inputs for this node to process, waiting for the reply.
+    // Returns an empty optional once all have been handed out.
+    std::optional<AntennaInputRange> next();
+
+    AntennaInputRequester& operator=(AntennaInputRequester const&) = delete;
+    AntennaInputRequester& operator=(AntennaInputRequester&&) = delete;
+
+private:
+    std::shared_ptr<InternodeCommunicationContext> _context;
+    MPI_Comm _communicator;
+    // Set once the primary node has no more antenna inputs for this node.
+    bool _finished;
+};
+
+
+// Filter coefficients held once per host in memory shared by all of its processes (an MPI shared memory window),
+// rather than each process receiving and holding its own copy.
+// Must be constructed and destroyed at the same point by every node, since they create the shared memory together.
+class HostSharedCoefficients {
+public:
+    // Distributes the primary node's coefficients (coefficients is ignored on the secondary nodes). Only the lowest
+    // ranked process on each host receives them, straight into the shared memory, and the other processes on the host
+    // use them in place once they are there.
+    // Takes the place of PrimaryNodeCommunicator::sendFilterCoefficients() and
+    // SecondaryNodeCommunicator::receiveFilterCoefficients().
+    HostSharedCoefficients(InternodeCommunicator const& communicator, std::vector<std::complex<float>> coefficients);
+    HostSharedCoefficients(HostSharedCoefficients const&) = delete;
+    HostSharedCoefficients(HostSharedCoefficients&&) = delete;
+
+    ~HostSharedCoefficients();
+
+    // The shared coefficients. Only valid while this object exists.
+    std::complex<float> const* data() const;
+    // Number of coefficients (0 if the loading failed).
+    std::size_t size() const;
+    // Number of processes on this host sharing the coefficients.
+    unsigned getHostProcessCount() const;
+
+    HostSharedCoefficients& operator=(HostSharedCoefficients const&) = delete;
+    HostSharedCoefficients& operator=(HostSharedCoefficients&&) = delete;
+
+private:
+    std::shared_ptr<InternodeCommunicationContext> _context;
+    // MPI communicator of the processes on this host.
+    MPI_Comm _hostCommunicator;
+    MPI_Win _window;
+    std::complex<float> const* _data;
+    std::size_t _size;
+};
+
+
+// Piece of data to write at an offset in a CollectiveOutputFile.
+struct CollectiveWrite {
+    // Offset in bytes from the start of the file.
+    unsigned long long offset;
+    void const* data;
+    // Size in bytes.
+    std::size_t size;
+};
+
+// Result of a round of collective writes.
+struct CollectiveWriteRound {
+    // Whether each of this node's pieces of data was written.
+    std::vector<bool> written;
+    // Whether every node has finished writing.
+    bool allFinished;
+    // Whether any node had an error, in which case nothing was written.
+    bool error;
+};
+
+
+// Existing file opened by every node together, written with collective MPI-IO so the MPI library can gather the
+// writes of all the nodes onto a few aggregator processes (collective buffering) before they reach the file system.
+// Writes are done in rounds, which every node takes part in even with nothing to write, until every node has finished.
+// Must be constructed and destroyed at the same point by every node, since they open the file together.
+class CollectiveOutputFile {
+public:
+    // Opens the file for writing, with collective buffering onto one aggregator process per host.
+    // Throws std::runtime_error on every node if it can't be opened on any of them.
+    CollectiveOutputFile(InternodeCommunicator const& communicator, std::string const& path);
+    CollectiveOutputFile(CollectiveOutputFile const&) = delete;
+    CollectiveOutputFile(CollectiveOutputFile&&) = delete;
+
+    ~CollectiveOutputFile();
+
+    // Writes this node's pieces of data, together with the pieces of every other node.
+    // finished is whether this node has nothing more to write after these pieces, and error whether it has had an
+    // error (in which case no node writes anything). Every node must call this the same number of times, until
+    // allFinished or error is set in the result.
+    CollectiveWriteRound writeRound(std::vector<CollectiveWrite> const& writes, bool finished, bool error) const;
+
+    CollectiveOutputFile& operator=(CollectiveOutputFile const&) = delete;
+    CollectiveOutputFile& operator=(CollectiveOutputFile&&) = delete;
+
+private:
+    std::shared_ptr<InternodeCommunicationContext> _context;
+    MPI_File _file;
+};
+
+
 // Thrown when internode communication fails.
 // MPI guarantees error-free communication (otherwise the program will abort), so unless the code is broken, this error
 // should never occur. It's probably best to not catch it.
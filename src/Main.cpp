@@ -1,4 +1,8 @@
+#include "AntennaInputReader.hpp"
+#include "AntennaInputSamples.hpp"
+#include "ChannelDecomposition.hpp"
 #include "ChannelRemapping.hpp"
+#include "ConcurrentInputProcessor.hpp"
 #include "CommandLineArguments.hpp"
 #include "Common.hpp"
 #include "InternodeCommunication.hpp"
@@ -6,18 +10,27 @@
 #include "NodeAntennaInputAssigner.hpp"
 #include "OutputLogFileWriter.hpp"
 #include "OutSignalWriter.hpp"
+#include "OutputContainer.hpp"
 #include "ReadCoeData.hpp"
 #include "ReadInputFile.hpp"
 #include "SignalProcessing.hpp"
+#include "SignalWriteBehind.hpp"
+#include "StageTiming.hpp"
 
+#include <algorithm>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -33,21 +46,89 @@ class IndicateErrorException : public std::runtime_error {
 };
 
 
+// Where and how this node writes the processed signals
+struct SignalOutput {
+    // This node's own handle on the output container, if writing it and it could be opened
+    std::optional<OutputContainerWriter> container;
+    // The output container opened by every node together, if writing it with collective writes
+    std::optional<CollectiveOutputFile> collectiveFile;
+    // Signals processed since the last round of collective writes, allowed for in the memory budget (see
+    // planAntennaInputProcessing())
+    std::mutex pendingMutex;
+    std::vector<PendingSignalWrite> pendingWrites;
+    // Writes the signals on a writer thread, if writing behind the processing.
+    // Declared last so its thread stops before the rest is destroyed
+    std::optional<SignalWriteBehind> writeBehind;
+};
+
+
 // Visitor functions for the primary or secondary nodes
 void runNode(PrimaryNodeCommunicator& primary, int argc, char* argv[]);
 void runNode(SecondaryNodeCommunicator& secondary, int argc, char* argv[]);
 
 AntennaConfig createAntennaConfig(AppConfig const& appConfig, bool& success);
 std::vector<std::complex<float>> createFilterCoefficients(std::string const filterPath, bool& success);
+CoefficientSpan getFilterCoefficients(std::vector<std::complex<float>> const& coefficients,
+                                      std::optional<HostSharedCoefficients> const& sharedCoefficients);
+std::vector<std::optional<AntennaInputRange>> getNodeAntennaInputAssignments(unsigned nodeCount,
+                                                                              AntennaConfig const& antennaConfig);
 std::optional<AntennaInputRange> communicateNodeAntennaInputAssignment(PrimaryNodeCommunicator const& primary,
-                                                                       unsigned const numAntennaInputs);
+                                                                       AntennaConfig const& antennaConfig);
+void openChannelExchange(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                         InternodeCommunicator const& communicator, std::string const& nodeName,
+                         std::optional<ChannelExchange>& channelExchange);
+unsigned planChannelExchangeGroupSize(AppConfig const& appConfig, ChannelRemapping const& channelRemapping,
+                                      ChannelExchange const& channelExchange, ConcurrencyPlan const& concurrency,
+                                      InternodeCommunicator const& communicator);
 unsigned getActiveNodeCount(std::map<unsigned, bool> const& secondaryNodeStatus);
-
-void processAntennaInput(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
-                         std::vector<std::complex<float>> const& coefficients, ChannelRemapping const& channelRemapping,
-                         unsigned const index, ObservationProcessingResults& processingResults);
-void readRawSignalFiles(AppConfig const& appConfig, AntennaConfig const& antennaConfig, unsigned const index,
-                        std::vector<std::vector<std::complex<float>>>& antennaInputSignals, std::set<unsigned>& usedChannels);
+AntennaInputScheduler createAntennaInputScheduler(AppConfig const& appConfig, unsigned numNodes,
+                                                  unsigned numAntennaInputs);
+template<typename ChunkSource>
+AntennaInputPrefetcher::BatchSource getAntennaInputBatchSource(
+    std::optional<AntennaInputRange> const& antennaInputRange, std::optional<ChunkSource>& chunkSource,
+    unsigned batchSize);
+AntennaInputPrefetcher::BatchReader getAntennaInputBatchReader(AppConfig const& appConfig,
+                                                               AntennaConfig const& antennaConfig,
+                                                               std::optional<AntennaInputBatch>& groupAntennaInputs);
+
+bool createObservationOutputContainer(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                      ChannelRemapping const& channelRemapping);
+void openOutputContainer(AppConfig const& appConfig, InternodeCommunicator const& communicator,
+                         std::string const& nodeName, SignalOutput& output);
+CollectiveWriteRound writeCollectiveRound(SignalOutput& output, AntennaConfig const& antennaConfig, bool finished,
+                                          bool error, std::mutex& resultsMutex,
+                                          ObservationProcessingResults& processingResults);
+void flushCollectiveWrites(SignalOutput& output, AntennaConfig const& antennaConfig, std::mutex& resultsMutex,
+                           ObservationProcessingResults& processingResults, std::string const& nodeName);
+void finishCollectiveWrites(SignalOutput& output, AntennaConfig const& antennaConfig, std::mutex& resultsMutex,
+                            ObservationProcessingResults& processingResults, std::string const& nodeName);
+void abortCollectiveWrites(SignalOutput& output);
+void startWriteBehind(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                      ConcurrencyPlan const& concurrency, SignalOutput& output, std::string const& nodeName);
+void finishWriteBehind(SignalOutput& output, std::mutex& resultsMutex, ObservationProcessingResults& processingResults);
+
+std::size_t getWriteBehindMemory(AppConfig const& appConfig, ChannelRemapping const& channelRemapping,
+                                 std::size_t numSamples);
+std::pair<ConcurrencyPlan, ReadAheadPlan> planAntennaInputProcessing(
+    AppConfig const& appConfig, AntennaConfig const& antennaConfig, ChannelRemapping const& channelRemapping,
+    std::optional<AntennaInputRange> const& antennaInputRange);
+std::optional<AntennaInputBatch> nextAntennaInputBatch(AntennaInputPrefetcher& prefetcher);
+void processAntennaInputBatch(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                              CoefficientSpan coefficients, ChannelRemapping const& channelRemapping,
+                              SignalOutput& output,
+                              ConcurrentInputProcessor& processor, std::vector<std::optional<ProcessingPlan>>& processingPlans,
+                              AntennaInputBatch& batch, std::mutex& resultsMutex,
+                              ObservationProcessingResults& processingResults);
+void processAntennaInputs(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                          CoefficientSpan coefficients, ChannelRemapping const& channelRemapping,
+                          SignalOutput& output,
+                          std::optional<ProcessingPlan>& processingPlan, std::vector<unsigned> const& indices,
+                          std::vector<AntennaInputSamples> const& antennaInputSignals,
+                          std::vector<StageMeasurements> const& readMeasurements,
+                          std::set<unsigned> const& usedChannels, ObservationProcessingResults& processingResults);
+
+void writeProcessedSignal(AppConfig const& appConfig, SignalOutput const& output,
+                          unsigned index, AntennaInputPhysID const& antenna, std::vector<std::int16_t> const& signal);
 
 void mergeSecondaryProcessingResults(PrimaryNodeCommunicator const& primary, ObservationProcessingResults& processingResults);
 
@@ -112,6 +193,19 @@ void runNode(PrimaryNodeCommunicator& primary, int argc, char* argv[]) {
     std::cout << "Node 0 (Primary): Sending app configuration to secondary nodes" << std::endl;
     primary.sendAppConfig(appConfig);
 
+    // Send the filter coefficients read at startup to secondary nodes, so the file is only read once. If sharing them
+    // between the processes on each host, they are only sent to the first process on each host, into the shared memory
+    std::cout << "Node 0 (Primary): Sending filter coefficients to secondary nodes" << std::endl;
+    std::optional<HostSharedCoefficients> sharedCoefficients;
+    if (appConfig.sharedMemory) {
+        sharedCoefficients.emplace(primary, std::exchange(coefficients, {}));
+        std::cout << "Node 0 (Primary): Sharing filter coefficients between "
+                  << sharedCoefficients->getHostProcessCount() << " process(es) on this host" << std::endl;
+    }
+    else {
+        primary.sendFilterCoefficients(coefficients);
+    }
+
     // Receive setup status from all secondary nodes
     std::cout << "Node 0 (Primary): Receiving setup status from secondary nodes" << std::endl;
     auto const secondaryNodeStatus = primary.receiveNodeSetupStatus();
@@ -134,46 +228,160 @@ void runNode(PrimaryNodeCommunicator& primary, int argc, char* argv[]) {
     primary.sendAntennaConfig(antennaConfig);
 
     // Compute frequency channel remapping
-    auto const channelRemapping = computeChannelRemapping(MWA_NUM_CHANNELS * 2, antennaConfig.frequencyChannels);
+    auto const minSamplingFreq =
+        computeChannelRemapping(MWA_NUM_CHANNELS * 2, antennaConfig.frequencyChannels).newSamplingFreq;
+    auto const channelRemapping = computeChannelRemapping(MWA_NUM_CHANNELS * 2, antennaConfig.frequencyChannels,
+                                                          appConfig.remappingMode);
+    std::cout << "Node 0 (Primary): Fourier transform length " << channelRemapping.newSamplingFreq
+              << " (minimal " << minSamplingFreq << ")" << std::endl;
+
+    // Create the output container before any node opens it
+    bool outputContainerCreated = false;
+    if (appConfig.outputFormat == OutputFormat::container) {
+        outputContainerCreated = createObservationOutputContainer(appConfig, antennaConfig, channelRemapping);
+    }
 
     // Send channel remapping to secondary nodes
     std::cout << "Node 0 (Primary): Sending channel remapping to secondary nodes" << std::endl;
     primary.sendChannelRemapping(channelRemapping);
 
-    // Send antenna input assignments to secondary nodes
-    std::cout << "Node 0 (Primary): Sending antenna input assignments to secondary nodes" << std::endl;
-    auto const antennaInputRange = communicateNodeAntennaInputAssignment(primary, antennaConfig.antennaInputs.size());
+    // Nodes only open the output container if it was created, rather than writing into one left by an earlier run
+    SignalOutput output;
+    if (appConfig.outputFormat == OutputFormat::container) {
+        primary.sendOutputContainerStatus(outputContainerCreated);
+        if (outputContainerCreated) {
+            openOutputContainer(appConfig, primary, "Node 0 (Primary)", output);
+        }
+    }
+
+    std::optional<AntennaInputRange> antennaInputRange;
+    // Hands out antenna inputs to all nodes as they are processed, if scheduling dynamically.
+    // Kept until all the processing results are gathered, since the secondary nodes may still be requesting them.
+    std::optional<AntennaInputDistributor> distributor;
+    if (appConfig.schedulingMode == SchedulingMode::dynamic) {
+        std::cout << "Node 0 (Primary): Handing out antenna inputs to nodes as they request them" << std::endl;
+        distributor.emplace(primary, createAntennaInputScheduler(appConfig, primary.getNodeCount(),
+                                                                 antennaConfig.antennaInputs.size()));
+    }
+    else {
+        // Send antenna input assignments to secondary nodes
+        std::cout << "Node 0 (Primary): Sending antenna input assignments to secondary nodes" << std::endl;
+        antennaInputRange = communicateNodeAntennaInputAssignment(primary, antennaConfig);
+    }
+
+    // Reads the signal files by channel together with the other nodes, if doing so
+    std::optional<ChannelExchange> channelExchange;
+    if (appConfig.decompositionMode == DecompositionMode::channel) {
+        std::cout << "Node 0 (Primary): Reading signal files by channel and exchanging them with other nodes"
+                  << std::endl;
+        openChannelExchange(appConfig, antennaConfig, primary, "Node 0 (Primary)", channelExchange);
+    }
 
     std::cout << "Node 0 (Primary): Starting signal processing" << std::endl;
 
     // Process all assigned antenna inputs (if any)
     ObservationProcessingResults processingResults;
-    if (antennaInputRange.has_value()) {
+    std::mutex resultsMutex;
+    // With channel decomposition every node takes part in each exchange, even if it has no antenna inputs
+    if (antennaInputRange.has_value() || distributor.has_value() || channelExchange.has_value()) {
         try {
-		    for (unsigned index = antennaInputRange.value().begin; index <= antennaInputRange.value().end; index++) {
-                if (!primary.getErrorStatus()) {
-                    processAntennaInput(appConfig, antennaConfig, coefficients, channelRemapping, index, processingResults);
+            // Read the next batches of antenna inputs in the background while processing the current ones
+            auto const [concurrency, readAhead] = planAntennaInputProcessing(appConfig, antennaConfig,
+                                                                             channelRemapping, antennaInputRange);
+            std::cout << "Node 0 (Primary): Processing " << concurrency.concurrentInputs << " antenna input(s) at a time, "
+                      << concurrency.threadsPerInput << " thread(s) each" << std::endl;
+            std::cout << "Node 0 (Primary): Reading " << readAhead.batchSize << " antenna input(s) at a time, up to "
+                      << readAhead.prefetchDepth << " batch(es) ahead" << std::endl;
+            startWriteBehind(appConfig, antennaConfig, concurrency, output, "Node 0 (Primary)");
+            if (channelExchange.has_value()) {
+                channelExchange->setGroupSize(planChannelExchangeGroupSize(appConfig, channelRemapping,
+                                                                           channelExchange.value(), concurrency,
+                                                                           primary));
+                std::cout << "Node 0 (Primary): Exchanging antenna inputs in " << channelExchange->getNumGroups()
+                          << " group(s)" << std::endl;
+            }
+            auto const filterCoefficients = getFilterCoefficients(coefficients, sharedCoefficients);
+            // One plan for each concurrently processed antenna input, planned from the first antenna input it
+            // processes then reused for the rest
+            std::vector<std::optional<ProcessingPlan>> processingPlans(concurrency.concurrentInputs);
+            // Declared after everything its tasks use, so it waits for them before those are destroyed
+            ConcurrentInputProcessor processor{concurrency, getAvailableThreads()};
+
+            // Without channel decomposition, all of this node's antenna inputs are read from the signal files as one
+            // group. Otherwise each group is exchanged with the other nodes, then processed before the next one
+            unsigned const numGroups = channelExchange.has_value() ? channelExchange->getNumGroups() : 1;
+            for (unsigned group = 0; group < numGroups; group++) {
+                auto groupAntennaInputRange = antennaInputRange;
+                std::optional<AntennaInputBatch> groupAntennaInputs;
+                if (channelExchange.has_value()) {
+                    groupAntennaInputRange = channelExchange->getNodeGroup(group);
+                    groupAntennaInputs = channelExchange->exchangeGroup(group);
+                }
+                AntennaInputPrefetcher prefetcher{getAntennaInputBatchSource(groupAntennaInputRange, distributor,
+                                                                             readAhead.batchSize),
+                                                  getAntennaInputBatchReader(appConfig, antennaConfig,
+                                                                             groupAntennaInputs),
+                                                  readAhead.prefetchDepth};
+
+                while (auto batch = nextAntennaInputBatch(prefetcher)) {
+                    if (!primary.getErrorStatus()) {
+                        processAntennaInputBatch(appConfig, antennaConfig, filterCoefficients, channelRemapping,
+                                                 output, processor, processingPlans, batch.value(), resultsMutex,
+                                                 processingResults);
+                        // Write the signals processed so far together with the other nodes
+                        if (output.collectiveFile.has_value() &&
+                                writeCollectiveRound(output, antennaConfig, false, false, resultsMutex,
+                                                     processingResults).error) {
+                            throw NodeException("Node 0 (Primary): Other node has signalled an error occurred, "
+                                                "terminating node");
+                        }
+                    }
+                    else {
+                        abortCollectiveWrites(output);
+                        throw NodeException("Node 0 (Primary): Other node has signalled an error occurred, "
+                                            "terminating node");
+                    }
                 }
-                else {
-                    throw NodeException("Node 0 (Primary): Other node has signalled an error occurred, terminating node");
+                processor.wait();
+                // Every node writes all of the group's signals before the next group is exchanged, so the nodes don't
+                // mix up the collective writes and the exchange
+                if (channelExchange.has_value()) {
+                    flushCollectiveWrites(output, antennaConfig, resultsMutex, processingResults, "Node 0 (Primary)");
                 }
             }
         }
         catch (IndicateErrorException const&) {
             primary.indicateError();
+            abortCollectiveWrites(output);
             throw NodeException("Node 0 (Primary): Read error has occurred, notifying other nodes... terminating node");
         }
     }
 
+    // Every node takes part in the collective writes until all have written their last signals, even if it had no
+    // antenna inputs
+    finishCollectiveWrites(output, antennaConfig, resultsMutex, processingResults, "Node 0 (Primary)");
+    finishWriteBehind(output, resultsMutex, processingResults);
+
     std::cout << "Node 0 (Primary): Finished signal processing" << std::endl;
 
     // Gather processing results from secondary nodes and merge into processingResults
     mergeSecondaryProcessingResults(primary, processingResults);
     std::cout << "Node 0 (Primary): Received processing results from secondary nodes" << std::endl;
 
+    // Record which signals were written in the output container, now every node has finished writing them
+    if (output.container.has_value()) {
+        try {
+            markOutputContainerWritten(getOutputContainerPath(appConfig), processingResults);
+            std::cout << "Node 0 (Primary): Finished writing output container" << std::endl;
+        }
+        catch (OutSignalException const& e) {
+            std::cerr << "Node 0 (Primary): Error finishing output container: " << e.getMessage() << std::endl;
+        }
+    }
+
     // Write output log file
     try {
-        writeLogFile(appConfig, channelRemapping, processingResults, antennaConfig);
+        writeLogFile(appConfig, channelRemapping, minSamplingFreq, processingResults, antennaConfig);
         std::cout << "Node 0 (Primary): Finished writing output log file" << std::endl;
     }
     catch (LogWriterException const& e) {
@@ -200,10 +408,18 @@ void runNode(SecondaryNodeCommunicator& secondary, int argc, char* argv[]) {
                  ": Receiving app configuration" << std::endl;
     auto const appConfig = secondary.receiveAppConfig();
 
-    // Read in filter coefficients
+    // Receive filter coefficients from primary node (which has already checked them), only keeping one copy per host if
+    // sharing them between the processes on each host
     std::cout << "Node " + std::to_string(secondary.getNodeID()) +
-                 ": Reading in filter coefficients" << std::endl;
-    auto const coefficients = createFilterCoefficients(appConfig.invPolyphaseFilterPath, setupStatus);
+                 ": Receiving filter coefficients" << std::endl;
+    std::vector<std::complex<float>> coefficients;
+    std::optional<HostSharedCoefficients> sharedCoefficients;
+    if (appConfig.sharedMemory) {
+        sharedCoefficients.emplace(secondary, std::vector<std::complex<float>>{});
+    }
+    else {
+        coefficients = secondary.receiveFilterCoefficients();
+    }
 
     // Send setup status to primary node
     secondary.sendNodeSetupStatus(setupStatus);
@@ -228,35 +444,120 @@ void runNode(SecondaryNodeCommunicator& secondary, int argc, char* argv[]) {
     std::cout << "Node " + std::to_string(secondary.getNodeID()) +
                  ": Received channel remapping" << std::endl;
 
-    // Receive antenna input assignment from primary node
-    auto const antennaInputRange = secondary.receiveAntennaInputAssignment();
-    std::cout << "Node " + std::to_string(secondary.getNodeID()) +
-                 ": Received antenna input assignment" << std::endl;
+    // Open the output container if the primary node managed to create it
+    SignalOutput output;
+    if (appConfig.outputFormat == OutputFormat::container && secondary.receiveOutputContainerStatus()) {
+        openOutputContainer(appConfig, secondary, "Node " + std::to_string(secondary.getNodeID()), output);
+    }
+
+    std::optional<AntennaInputRange> antennaInputRange;
+    // Requests antenna inputs from the primary node as they are processed, if scheduling dynamically
+    std::optional<AntennaInputRequester> requester;
+    if (appConfig.schedulingMode == SchedulingMode::dynamic) {
+        requester.emplace(secondary);
+        std::cout << "Node " + std::to_string(secondary.getNodeID()) +
+                     ": Requesting antenna inputs from primary node" << std::endl;
+    }
+    else {
+        // Receive antenna input assignment from primary node
+        antennaInputRange = secondary.receiveAntennaInputAssignment();
+        std::cout << "Node " + std::to_string(secondary.getNodeID()) +
+                     ": Received antenna input assignment" << std::endl;
+    }
+
+    // Reads the signal files by channel together with the other nodes, if doing so
+    std::optional<ChannelExchange> channelExchange;
+    if (appConfig.decompositionMode == DecompositionMode::channel) {
+        std::cout << "Node " + std::to_string(secondary.getNodeID()) +
+                     ": Reading signal files by channel and exchanging them with other nodes" << std::endl;
+        openChannelExchange(appConfig, antennaConfig, secondary, "Node " + std::to_string(secondary.getNodeID()),
+                            channelExchange);
+    }
 
     std::cout << "Node " + std::to_string(secondary.getNodeID()) +
                  ": Starting signal processing" << std::endl;
 
     // Process all assigned antenna inputs (if any)
     ObservationProcessingResults processingResults;
-    if (antennaInputRange.has_value()) {
+    std::mutex resultsMutex;
+    // With channel decomposition every node takes part in each exchange, even if it has no antenna inputs
+    if (antennaInputRange.has_value() || requester.has_value() || channelExchange.has_value()) {
         try {
-		    for (unsigned index = antennaInputRange.value().begin; index <= antennaInputRange.value().end; index++) {
-                if (!secondary.getErrorStatus()) {
-                    processAntennaInput(appConfig, antennaConfig, coefficients, channelRemapping, index, processingResults);
+            // Read the next batches of antenna inputs in the background while processing the current ones
+            auto const [concurrency, readAhead] = planAntennaInputProcessing(appConfig, antennaConfig,
+                                                                             channelRemapping, antennaInputRange);
+            startWriteBehind(appConfig, antennaConfig, concurrency, output,
+                             "Node " + std::to_string(secondary.getNodeID()));
+            if (channelExchange.has_value()) {
+                channelExchange->setGroupSize(planChannelExchangeGroupSize(appConfig, channelRemapping,
+                                                                           channelExchange.value(), concurrency,
+                                                                           secondary));
+            }
+            auto const filterCoefficients = getFilterCoefficients(coefficients, sharedCoefficients);
+            // One plan for each concurrently processed antenna input, planned from the first antenna input it
+            // processes then reused for the rest
+            std::vector<std::optional<ProcessingPlan>> processingPlans(concurrency.concurrentInputs);
+            // Declared after everything its tasks use, so it waits for them before those are destroyed
+            ConcurrentInputProcessor processor{concurrency, getAvailableThreads()};
+
+            // Without channel decomposition, all of this node's antenna inputs are read from the signal files as one
+            // group. Otherwise each group is exchanged with the other nodes, then processed before the next one
+            unsigned const numGroups = channelExchange.has_value() ? channelExchange->getNumGroups() : 1;
+            for (unsigned group = 0; group < numGroups; group++) {
+                auto groupAntennaInputRange = antennaInputRange;
+                std::optional<AntennaInputBatch> groupAntennaInputs;
+                if (channelExchange.has_value()) {
+                    groupAntennaInputRange = channelExchange->getNodeGroup(group);
+                    groupAntennaInputs = channelExchange->exchangeGroup(group);
+                }
+                AntennaInputPrefetcher prefetcher{getAntennaInputBatchSource(groupAntennaInputRange, requester,
+                                                                             readAhead.batchSize),
+                                                  getAntennaInputBatchReader(appConfig, antennaConfig,
+                                                                             groupAntennaInputs),
+                                                  readAhead.prefetchDepth};
+
+                while (auto batch = nextAntennaInputBatch(prefetcher)) {
+                    if (!secondary.getErrorStatus()) {
+                        processAntennaInputBatch(appConfig, antennaConfig, filterCoefficients, channelRemapping,
+                                                 output, processor, processingPlans, batch.value(), resultsMutex,
+                                                 processingResults);
+                        // Write the signals processed so far together with the other nodes
+                        if (output.collectiveFile.has_value() &&
+                                writeCollectiveRound(output, antennaConfig, false, false, resultsMutex,
+                                                     processingResults).error) {
+                            throw NodeException("Node " + std::to_string(secondary.getNodeID()) +
+                                                ": Other node has signalled an error occurred, terminating node");
+                        }
+                    }
+                    else {
+                        abortCollectiveWrites(output);
+                        throw NodeException("Node " + std::to_string(secondary.getNodeID()) +
+                                            ": Other node has signalled an error occurred, terminating node");
+                    }
                 }
-                else {
-                    throw NodeException("Node " + std::to_string(secondary.getNodeID()) +
-                                        ": Other node has signalled an error occurred, terminating node");
+                processor.wait();
+                // Every node writes all of the group's signals before the next group is exchanged, so the nodes don't
+                // mix up the collective writes and the exchange
+                if (channelExchange.has_value()) {
+                    flushCollectiveWrites(output, antennaConfig, resultsMutex, processingResults,
+                                          "Node " + std::to_string(secondary.getNodeID()));
                 }
             }
         }
         catch (IndicateErrorException const&) {
             secondary.indicateError();
+            abortCollectiveWrites(output);
             throw NodeException("Node " + std::to_string(secondary.getNodeID()) +
                                 ": Read error has occurred, notifying other nodes... terminating node");
         }
     }
 
+    // Every node takes part in the collective writes until all have written their last signals, even if it had no
+    // antenna inputs
+    finishCollectiveWrites(output, antennaConfig, resultsMutex, processingResults,
+                           "Node " + std::to_string(secondary.getNodeID()));
+    finishWriteBehind(output, resultsMutex, processingResults);
+
     std::cout << "Node " + std::to_string(secondary.getNodeID()) +
                  ": Finished signal processing" << std::endl;
 
@@ -270,78 +571,450 @@ void runNode(SecondaryNodeCommunicator& secondary, int argc, char* argv[]) {
 }
 
 
-void processAntennaInput(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
-                         std::vector<std::complex<float>> const& coefficients, ChannelRemapping const& channelRemapping,
-                         unsigned const index, ObservationProcessingResults& processingResults) {
-	// Used to store raw signal data from all channels recorded by one antenna input
-    std::vector<std::vector<std::complex<float>>> antennaInputSignals;
-    // Used to store processed signal for one antenna input
-    std::vector<std::int16_t> processedSignal;
-    // Used to store which channels are used in the processed signal
-    std::set<unsigned> usedChannels;
-
-    // Used to store antenna input being processed
-    auto const antenna = antennaConfig.antennaInputs.at(index);
-
-    if (!antenna.flagged) {
-        // Read in raw signal files from all channels recorded by one antenna input
-        readRawSignalFiles(appConfig, antennaConfig, index, antennaInputSignals, usedChannels);
-
-        if (!antennaInputSignals.empty()) {
-            // Converting set of channels used to vector for use in processSignal()
-            std::vector<unsigned> channelIndexMapping(usedChannels.begin(), usedChannels.end());
-
-            // Process signal
-            std::cout << "Processing tile " << antenna.tile << antenna.signalChain << std::endl;
-            processSignal(antennaInputSignals, channelIndexMapping, processedSignal, coefficients, channelRemapping);
-
-            // Write processed antenna input signal to file
-            try {
-                outSignalWriter(processedSignal, appConfig, antenna);
-                processingResults.results.insert({index, {true, usedChannels}});
-                std::cout << "Tile " << antenna.tile << antenna.signalChain << " written to file successfully" << std::endl;
-            }
-            catch (OutSignalException const& e) {
-                processingResults.results.insert({index, {false, usedChannels}});
-                std::cerr << "Tile " << antenna.tile << antenna.signalChain << " writing failed" << std::endl;
+// Create the output container for the whole observation, sized for signals of the length the channel remapping gives.
+// Returns whether it was created. A failure is reported, but processing carries on, with each antenna input's write
+// failing (as with per input files)
+bool createObservationOutputContainer(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                      ChannelRemapping const& channelRemapping) {
+    try {
+        auto const antennaInputRawSize = getAntennaInputRawSize(appConfig, antennaConfig);
+        // Each raw sample is 2 bytes, and every one becomes newSamplingFreq output samples
+        unsigned long long numSamples = 0;
+        if (antennaInputRawSize > 0) {
+            numSamples = static_cast<unsigned long long>(antennaInputRawSize) /
+                         (antennaConfig.frequencyChannels.size() * 2) * channelRemapping.newSamplingFreq;
+        }
+        auto const path = getOutputContainerPath(appConfig);
+        createOutputContainer(path, planOutputContainer(appConfig, antennaConfig, channelRemapping.newSamplingFreq,
+                                                        numSamples));
+        std::cout << "Node 0 (Primary): Created output container " << path.string() << std::endl;
+        return true;
+    }
+    catch (OutSignalException const& e) {
+        std::cerr << "Node 0 (Primary): Error creating output container: " << e.getMessage() << std::endl;
+        return false;
+    }
+}
+
+// Open the observation's output container for this node to write its antenna inputs into, and together with the other
+// nodes if writing it collectively. Must be called by every node at the same point. Left empty on failure, in which
+// case each antenna input's write fails
+void openOutputContainer(AppConfig const& appConfig, InternodeCommunicator const& communicator,
+                         std::string const& nodeName, SignalOutput& output) {
+    auto const path = getOutputContainerPath(appConfig);
+    try {
+        output.container.emplace(path);
+    }
+    catch (OutSignalException const& e) {
+        std::cerr << nodeName << ": Error opening output container: " << e.getMessage() << std::endl;
+    }
+    if (appConfig.collectiveWrites) {
+        // Fails on every node together
+        try {
+            output.collectiveFile.emplace(communicator, path.string());
+        }
+        catch (std::runtime_error const& e) {
+            std::cerr << nodeName << ": Error opening output container for collective writes: " << e.what()
+                      << std::endl;
+        }
+    }
+}
+
+// Writes the signals processed since the last round in a round of collective writes with the other nodes, recording
+// the results of their antenna inputs. The round's time is shared between the signals written in it
+CollectiveWriteRound writeCollectiveRound(SignalOutput& output, AntennaConfig const& antennaConfig, bool finished,
+                                          bool error, std::mutex& resultsMutex,
+                                          ObservationProcessingResults& processingResults) {
+    std::vector<PendingSignalWrite> pendingWrites;
+    {
+        std::lock_guard<std::mutex> const lock{output.pendingMutex};
+        pendingWrites.swap(output.pendingWrites);
+    }
+
+    // Signals which don't fit their slot in the container aren't written, so fail
+    std::vector<CollectiveWrite> writes;
+    std::vector<std::size_t> writeIndices;
+    for (std::size_t i = 0; i < pendingWrites.size(); i++) {
+        auto const& pending = pendingWrites[i];
+        if (output.container.has_value()) {
+            auto const& layout = output.container->getLayout();
+            if (pending.index < layout.antennaInputs.size() && !layout.antennaInputs[pending.index].flagged &&
+                    pending.signal.size() == layout.numSamples) {
+                writes.push_back({layout.antennaInputs[pending.index].offset, pending.signal.data(),
+                                  pending.signal.size() * sizeof(std::int16_t)});
+                writeIndices.push_back(i);
             }
         }
+    }
+
+    StageTimer const writeTimer;
+    auto round = output.collectiveFile->writeRound(writes, finished, error);
+    double const writeSeconds = writes.empty() ? 0.0 : writeTimer.getElapsedSeconds() / writes.size();
+
+    std::vector<bool> written(pendingWrites.size(), false);
+    for (std::size_t i = 0; i < writeIndices.size(); i++) {
+        written[writeIndices[i]] = round.written[i];
+    }
+
+    std::lock_guard<std::mutex> const lock{resultsMutex};
+    for (std::size_t i = 0; i < pendingWrites.size(); i++) {
+        auto& pending = pendingWrites[i];
+        auto const antenna = antennaConfig.antennaInputs.at(pending.index);
+        if (written[i]) {
+            addStageMeasurement(pending.measurements, ProcessingStage::write, writeSeconds,
+                                pending.signal.size() * sizeof(std::int16_t), pending.signal.size());
+            processingResults.results.insert({pending.index, {true, pending.usedChannels, pending.measurements}});
+            std::cout << "Tile " << antenna.tile << antenna.signalChain << " written to file successfully" << std::endl;
+        }
         else {
-            // Indicate antenna input skipped due to no readable data
-            processingResults.results.insert({index, {false, usedChannels}});
-            std::cerr << "Tile " << antenna.tile << antenna.signalChain << " not processed (no readable data)" << std::endl;
+            processingResults.results.insert({pending.index, {false, pending.usedChannels, pending.measurements}});
+            std::cerr << "Tile " << antenna.tile << antenna.signalChain << " writing failed" << std::endl;
         }
     }
-    else {
-        // Skip processing for flagged antenna inputs
-        processingResults.results.insert({index, {false, usedChannels}});
-        std::cout << "Skipping flagged tile " << antenna.tile << antenna.signalChain << std::endl;
+    return round;
+}
+
+// Runs rounds of collective writes, if writing collectively, until every node has written all the signals it has
+// processed so far. Throws NodeException if another node has signalled an error
+void flushCollectiveWrites(SignalOutput& output, AntennaConfig const& antennaConfig, std::mutex& resultsMutex,
+                           ObservationProcessingResults& processingResults, std::string const& nodeName) {
+    if (!output.collectiveFile.has_value()) {
+        return;
     }
+    while (true) {
+        auto const round = writeCollectiveRound(output, antennaConfig, true, false, resultsMutex, processingResults);
+        if (round.error) {
+            throw NodeException(nodeName + ": Other node has signalled an error occurred, terminating node");
+        }
+        if (round.allFinished) {
+            break;
+        }
+    }
+}
+
+// Runs the final rounds of collective writes, if writing collectively, until every node has written all its signals.
+// The file is then closed by every node together. Throws NodeException if another node has signalled an error
+void finishCollectiveWrites(SignalOutput& output, AntennaConfig const& antennaConfig, std::mutex& resultsMutex,
+                            ObservationProcessingResults& processingResults, std::string const& nodeName) {
+    flushCollectiveWrites(output, antennaConfig, resultsMutex, processingResults, nodeName);
+    output.collectiveFile.reset();
 }
 
-void readRawSignalFiles(AppConfig const& appConfig, AntennaConfig const& antennaConfig, unsigned const index,
-                        std::vector<std::vector<std::complex<float>>>& antennaInputSignals, std::set<unsigned>& usedChannels) {
-    for (auto channel : antennaConfig.frequencyChannels) {
-        std::filesystem::path dir (appConfig.inputDirectoryPath);
-        std::filesystem::path filename = std::to_string(appConfig.observationID) + "_" +
-                                            std::to_string(appConfig.signalStartTime) + "_" +
-                                            std::to_string(channel) + ".sub";
-        std::filesystem::path voltageFile = dir / filename;
+// Signals this node's error to the other nodes in the next round of collective writes, if writing collectively, so
+// they stop writing too
+void abortCollectiveWrites(SignalOutput& output) {
+    if (output.collectiveFile.has_value()) {
+        output.collectiveFile->writeRound({}, true, true);
+    }
+}
 
+// Start the writer thread, if writing behind the processing. Collective writes are already done apart from the
+// processing, in rounds between batches, so they don't use it. The writer thread keeps at most as many buffers of
+// written signals as are processed at once (as planned by planAntennaInputProcessing()), since that's as many as
+// processing can take back before it hands off more signals
+void startWriteBehind(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                      ConcurrencyPlan const& concurrency, SignalOutput& output, std::string const& nodeName) {
+    if (appConfig.writeBehindDepth == 0 || output.collectiveFile.has_value()) {
+        return;
+    }
+    output.writeBehind.emplace([&appConfig, &antennaConfig, &output](unsigned index,
+                                                                     std::vector<std::int16_t> const& signal) {
+        auto const antenna = antennaConfig.antennaInputs.at(index);
         try {
-            antennaInputSignals.push_back(readInputDataFile(voltageFile, index, antennaConfig.antennaInputs.size()));
-            usedChannels.insert(channel);
+            writeProcessedSignal(appConfig, output, index, antenna, signal);
+            std::cout << "Tile " << antenna.tile << antenna.signalChain << " written to file successfully" << std::endl;
+            return true;
         }
-        catch (ReadInputDataException const& e) {
-            // Indicate reading error has occurred if not ignoring errors
-            if (!appConfig.ignoreErrors) {
-                std::cerr << "Error occurred reading: " << (std::string) voltageFile << std::endl;
-                throw IndicateErrorException("");
+        catch (OutSignalException const& e) {
+            std::cerr << "Tile " << antenna.tile << antenna.signalChain << " writing failed" << std::endl;
+            return false;
+        }
+    }, appConfig.writeBehindDepth, concurrency.concurrentInputs * appConfig.inputBatchSize);
+    std::cout << nodeName << ": Writing signals behind processing, up to " << appConfig.writeBehindDepth
+              << " waiting at a time" << std::endl;
+}
+
+// Wait for the writer thread to write all the processed signals, if writing behind the processing, and record the
+// results of writing them
+void finishWriteBehind(SignalOutput& output, std::mutex& resultsMutex, ObservationProcessingResults& processingResults) {
+    if (output.writeBehind.has_value()) {
+        auto writeResults = output.writeBehind->finish();
+        std::lock_guard<std::mutex> const lock{resultsMutex};
+        processingResults.results.merge(writeResults.results);
+    }
+}
+
+
+// Memory for the processed signals held by the writer thread, if writing behind the processing: those waiting to be
+// written and the one being written. Collective writes don't use it
+std::size_t getWriteBehindMemory(AppConfig const& appConfig, ChannelRemapping const& channelRemapping,
+                                 std::size_t numSamples) {
+    if (appConfig.writeBehindDepth == 0 || appConfig.collectiveWrites) {
+        return 0;
+    }
+    std::size_t const signalSize = static_cast<std::size_t>(channelRemapping.newSamplingFreq) * numSamples *
+                                   sizeof(std::int16_t);
+    return (static_cast<std::size_t>(appConfig.writeBehindDepth) + 1) * signalSize;
+}
+
+// Plans how many antenna inputs are processed at once and how they are read ahead, sharing the memory budget between
+// them. Processing gets as much as it can use, and the rest is used for reading ahead. antennaInputRange is the node's
+// assigned antenna inputs, if it has a fixed range.
+std::pair<ConcurrencyPlan, ReadAheadPlan> planAntennaInputProcessing(
+        AppConfig const& appConfig, AntennaConfig const& antennaConfig, ChannelRemapping const& channelRemapping,
+        std::optional<AntennaInputRange> const& antennaInputRange) {
+    auto const antennaInputRawSize = getAntennaInputRawSize(appConfig, antennaConfig);
+    std::size_t antennaInputMemory = 0;
+    // Memory for each antenna input read ahead
+    std::size_t antennaInputReadMemory = antennaInputRawSize;
+    std::size_t writeBehindMemory = 0;
+    if (antennaInputRawSize > 0) {
+        // Each raw sample is 2 bytes
+        auto const numSamples = antennaInputRawSize / (antennaConfig.frequencyChannels.size() * 2);
+        // A batch of antenna inputs is processed as one
+        antennaInputMemory = appConfig.inputBatchSize *
+            (antennaInputRawSize + estimateProcessingMemory(channelRemapping, numSamples));
+        // With collective writes, processed signals wait for the next round, which comes after the antenna inputs of
+        // the next read batch have been started. So at most the signals of the antenna inputs being processed and of a
+        // read batch are waiting, which is allowed for by giving every antenna input processed or read ahead room for
+        // a waiting signal.
+        if (appConfig.collectiveWrites) {
+            std::size_t const signalSize = static_cast<std::size_t>(channelRemapping.newSamplingFreq) * numSamples *
+                                           sizeof(std::int16_t);
+            antennaInputMemory += appConfig.inputBatchSize * signalSize;
+            antennaInputReadMemory += signalSize;
+        }
+        writeBehindMemory = getWriteBehindMemory(appConfig, channelRemapping, numSamples);
+    }
+    // The signals waiting to be written behind the processing come out of the budget first
+    std::size_t const fullBudget = static_cast<std::size_t>(appConfig.memoryBudget) * 1024 * 1024;
+    std::size_t const memoryBudget = fullBudget > writeBehindMemory ? fullBudget - writeBehindMemory : 0;
+    auto const concurrency = planConcurrency(memoryBudget, antennaInputMemory, getAvailableThreads(),
+                                             appConfig.concurrentInputs);
+
+    // The read ahead plan already allows for the batch being processed, so only the other antenna inputs being
+    // processed come out of its budget
+    std::size_t const processingMemory = (concurrency.concurrentInputs - 1) * antennaInputMemory;
+    // Each signal file is read once per batch, so the whole of the node's range is read as one batch if the budget
+    // allows (with dynamic scheduling, batches are also limited by the chunks handed out). Read batches are made at
+    // least as large as the input batches, so the input batches can be filled
+    unsigned const maxReadBatchSize = antennaInputRange.has_value() ?
+                                      antennaInputRange->end - antennaInputRange->begin + 1 :
+                                      static_cast<unsigned>(antennaConfig.antennaInputs.size());
+    auto const readAhead = planReadAhead(memoryBudget > processingMemory ? memoryBudget - processingMemory : 0,
+                                         antennaInputReadMemory, appConfig.prefetchDepth, maxReadBatchSize,
+                                         appConfig.inputBatchSize);
+    return {concurrency, readAhead};
+}
+
+// Plans how many antenna inputs each node exchanges with the others at once when reading the signal files by channel.
+// The antenna inputs being processed and read ahead are taken from the group last exchanged, so the group gets
+// whatever of the memory budget isn't needed for processing them (as planned by planAntennaInputProcessing()) or for
+// the exchange buffers. Groups are a whole number of input batches, and at least one even if that doesn't fit.
+// Must be called by every node at the same point, since they all use the smallest group planned by any node
+unsigned planChannelExchangeGroupSize(AppConfig const& appConfig, ChannelRemapping const& channelRemapping,
+                                      ChannelExchange const& channelExchange, ConcurrencyPlan const& concurrency,
+                                      InternodeCommunicator const& communicator) {
+    auto const antennaInputRawSize = channelExchange.getAntennaInputSize();
+    unsigned groupSize = std::numeric_limits<unsigned>::max();
+    if (antennaInputRawSize > 0) {
+        // Each raw sample is 2 bytes
+        auto const numSamples = antennaInputRawSize / (channelExchange.getUsedChannels().size() * 2);
+        std::size_t processingMemory = static_cast<std::size_t>(concurrency.concurrentInputs) *
+            appConfig.inputBatchSize * estimateProcessingMemory(channelRemapping, numSamples);
+        // Both the data being sent and that being received
+        std::size_t const exchangeMemory = 2 * CHANNEL_EXCHANGE_CHUNK_BYTES;
+        // With collective writes, every antenna input in the group may have a processed signal waiting for the next
+        // round (see planAntennaInputProcessing())
+        std::size_t antennaInputMemory = antennaInputRawSize;
+        if (appConfig.collectiveWrites) {
+            antennaInputMemory += static_cast<std::size_t>(channelRemapping.newSamplingFreq) * numSamples *
+                                  sizeof(std::int16_t);
+        }
+        // As are the signals waiting to be written behind the processing
+        processingMemory += getWriteBehindMemory(appConfig, channelRemapping, numSamples);
+        std::size_t const memoryBudget = static_cast<std::size_t>(appConfig.memoryBudget) * 1024 * 1024;
+        std::size_t const groupMemory = memoryBudget > processingMemory + exchangeMemory ?
+                                        memoryBudget - processingMemory - exchangeMemory : 0;
+        auto const numInputBatches = std::max<std::size_t>(
+            groupMemory / (appConfig.inputBatchSize * antennaInputMemory), 1);
+        groupSize = static_cast<unsigned>(std::min<std::size_t>(numInputBatches * appConfig.inputBatchSize,
+                                                                std::numeric_limits<unsigned>::max()));
+    }
+    return static_cast<unsigned>(communicator.getMinimum(groupSize));
+}
+
+// Gets the next batch of antenna inputs from the prefetcher, indicating an error if it couldn't be read
+std::optional<AntennaInputBatch> nextAntennaInputBatch(AntennaInputPrefetcher& prefetcher) {
+    try {
+        return prefetcher.next();
+    }
+    catch (ReadInputDataException const& e) {
+        std::cerr << e.what() << std::endl;
+        throw IndicateErrorException("");
+    }
+}
+
+// Starts processing the antenna inputs of the batch, in groups of up to the input batch size, as soon as the processor
+// has room for each group
+void processAntennaInputBatch(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                              CoefficientSpan coefficients, ChannelRemapping const& channelRemapping,
+                              SignalOutput& output,
+                              ConcurrentInputProcessor& processor, std::vector<std::optional<ProcessingPlan>>& processingPlans,
+                              AntennaInputBatch& batch, std::mutex& resultsMutex,
+                              ObservationProcessingResults& processingResults) {
+    // The batch is read as a whole, so its read time is shared between the antenna inputs read
+    auto const numRead = std::count_if(batch.signals.begin(), batch.signals.end(),
+                                       [](AntennaInputSamples const& signals) { return !signals.empty(); });
+    double const readSeconds = numRead > 0 ? batch.readSeconds / numRead : 0.0;
+
+    for (unsigned begin = batch.antennaInputs.begin; begin <= batch.antennaInputs.end; begin += appConfig.inputBatchSize) {
+        auto const end = std::min(begin + appConfig.inputBatchSize - 1, batch.antennaInputs.end);
+        std::vector<unsigned> indices;
+        // Take ownership of the group's signals so they are freed once it is processed
+        auto const antennaInputSignals = std::make_shared<std::vector<AntennaInputSamples>>();
+        std::vector<StageMeasurements> readMeasurements;
+        for (unsigned index = begin; index <= end; index++) {
+            indices.push_back(index);
+            auto& signals = batch.signals.at(index - batch.antennaInputs.begin);
+            // Each raw sample is 2 bytes
+            unsigned long long const numSamples = static_cast<unsigned long long>(signals.getNumChannels()) *
+                                                  signals.getNumSamples();
+            readMeasurements.emplace_back();
+            if (!signals.empty()) {
+                addStageMeasurement(readMeasurements.back(), ProcessingStage::read, readSeconds, numSamples * 2,
+                                    numSamples);
             }
+            antennaInputSignals->push_back(std::move(signals));
         }
+        processor.run([&appConfig, &antennaConfig, coefficients, &channelRemapping, &output, &processingPlans,
+                       &resultsMutex, &processingResults, indices = std::move(indices), antennaInputSignals,
+                       readMeasurements = std::move(readMeasurements),
+                       usedChannels = batch.usedChannels](unsigned slot) {
+            ObservationProcessingResults antennaInputResults;
+            processAntennaInputs(appConfig, antennaConfig, coefficients, channelRemapping, output,
+                                 processingPlans.at(slot), indices, *antennaInputSignals, readMeasurements,
+                                 usedChannels, antennaInputResults);
+            std::lock_guard<std::mutex> const lock{resultsMutex};
+            processingResults.results.merge(antennaInputResults.results);
+        });
     }
 }
 
+// Processes a group of antenna inputs, transforming the readable, unflagged ones together in one batch
+void processAntennaInputs(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                          CoefficientSpan coefficients, ChannelRemapping const& channelRemapping,
+                          SignalOutput& output,
+                          std::optional<ProcessingPlan>& processingPlan, std::vector<unsigned> const& indices,
+                          std::vector<AntennaInputSamples> const& antennaInputSignals,
+                          std::vector<StageMeasurements> const& readMeasurements,
+                          std::set<unsigned> const& usedChannels, ObservationProcessingResults& processingResults) {
+    // Antenna inputs to be processed, their signals, and the measurements of their stages so far
+    std::vector<unsigned> processedIndices;
+    std::vector<AntennaInputSamples const*> processedSignals;
+    std::vector<StageMeasurements> stageMeasurements;
+
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        auto const index = indices[i];
+        // Used to store antenna input being processed
+        auto const antenna = antennaConfig.antennaInputs.at(index);
+
+        if (!antenna.flagged) {
+            if (!antennaInputSignals[i].empty()) {
+                std::cout << "Processing tile " << antenna.tile << antenna.signalChain << std::endl;
+                processedIndices.push_back(index);
+                processedSignals.push_back(&antennaInputSignals[i]);
+                stageMeasurements.push_back(readMeasurements[i]);
+            }
+            else {
+                // Indicate antenna input skipped due to no readable data
+                processingResults.results.insert({index, {false, usedChannels}});
+                std::cerr << "Tile " << antenna.tile << antenna.signalChain << " not processed (no readable data)" << std::endl;
+            }
+        }
+        else {
+            // Skip processing for flagged antenna inputs
+            processingResults.results.insert({index, {false, {}}});
+            std::cout << "Skipping flagged tile " << antenna.tile << antenna.signalChain << std::endl;
+        }
+    }
+
+    if (processedSignals.empty()) {
+        return;
+    }
+
+    // Converting set of channels used to vector for use in processSignalBatch()
+    std::vector<unsigned> channelIndexMapping(usedChannels.begin(), usedChannels.end());
+
+    // Process signals
+    // All antenna inputs have the same number of samples, so the plan is only built again if that changes
+    unsigned const numSamples = processedSignals.front()->getNumSamples();
+    if (!processingPlan.has_value() || processingPlan->getNumBlocks() != numSamples) {
+        processingPlan.emplace(channelRemapping, coefficients, numSamples, appConfig.inputBatchSize,
+                               appConfig.overlapSave);
+    }
+    // Used to store processed signal for each antenna input, in the buffers of signals already written if writing
+    // behind the processing so they aren't allocated again
+    std::vector<std::vector<std::int16_t>> processedSignalBatch;
+    if (output.writeBehind.has_value()) {
+        for (std::size_t i = 0; i < processedSignals.size(); i++) {
+            processedSignalBatch.push_back(output.writeBehind->takeBuffer());
+        }
+    }
+    processSignalBatch(processedSignals, channelIndexMapping, processedSignalBatch, processingPlan.value());
+
+    for (std::size_t i = 0; i < processedIndices.size(); i++) {
+        auto const index = processedIndices[i];
+        auto const antenna = antennaConfig.antennaInputs.at(index);
+        auto& measurements = stageMeasurements[i];
+        auto const& processingMeasurements = processingPlan->getStageMeasurements(i);
+        for (std::size_t stage = 0; stage < NUM_PROCESSING_STAGES; stage++) {
+            addStageMeasurement(measurements, static_cast<ProcessingStage>(stage), processingMeasurements[stage].seconds,
+                                processingMeasurements[stage].bytes, processingMeasurements[stage].samples);
+        }
+
+        // Written in the next round of collective writes if writing collectively, which records the result
+        if (output.collectiveFile.has_value()) {
+            std::lock_guard<std::mutex> const lock{output.pendingMutex};
+            output.pendingWrites.push_back({index, std::move(processedSignalBatch[i]), usedChannels, measurements});
+            continue;
+        }
+        // Handed off to the writer thread if writing behind the processing, which records the result
+        if (output.writeBehind.has_value()) {
+            output.writeBehind->write({index, std::move(processedSignalBatch[i]), usedChannels, measurements});
+            continue;
+        }
+
+        // Write processed antenna input signal to file
+        auto const& processedSignal = processedSignalBatch[i];
+        StageTimer const writeTimer;
+        try {
+            writeProcessedSignal(appConfig, output, index, antenna, processedSignal);
+            addStageMeasurement(measurements, ProcessingStage::write, writeTimer.getElapsedSeconds(),
+                                processedSignal.size() * sizeof(std::int16_t), processedSignal.size());
+            processingResults.results.insert({index, {true, usedChannels, measurements}});
+            std::cout << "Tile " << antenna.tile << antenna.signalChain << " written to file successfully" << std::endl;
+        }
+        catch (OutSignalException const& e) {
+            processingResults.results.insert({index, {false, usedChannels, measurements}});
+            std::cerr << "Tile " << antenna.tile << antenna.signalChain << " writing failed" << std::endl;
+        }
+    }
+}
+
+// Write a processed antenna input signal in the configured output format, throws OutSignalException
+void writeProcessedSignal(AppConfig const& appConfig, SignalOutput const& output,
+                          unsigned index, AntennaInputPhysID const& antenna, std::vector<std::int16_t> const& signal) {
+    if (appConfig.outputFormat == OutputFormat::container) {
+        if (!output.container.has_value()) {
+            throw OutSignalException("Output container isn't open");
+        }
+        output.container->write(index, signal);
+    }
+    else {
+        outSignalWriter(signal, appConfig, antenna);
+    }
+}
 
 void mergeSecondaryProcessingResults(PrimaryNodeCommunicator const& primary, ObservationProcessingResults& processingResults) {
     // Gather secondary node processing results
@@ -389,26 +1062,123 @@ std::vector<std::complex<float>> createFilterCoefficients(std::string const filt
 }
 
 
+// Get the filter coefficients to process with: the ones shared between the processes on this host if sharing them,
+// otherwise the node's own
+CoefficientSpan getFilterCoefficients(std::vector<std::complex<float>> const& coefficients,
+                                      std::optional<HostSharedCoefficients> const& sharedCoefficients) {
+    if (sharedCoefficients.has_value()) {
+        return {sharedCoefficients->data(), sharedCoefficients->size()};
+    }
+    else {
+        return coefficients;
+    }
+}
+
+
+// Calculate range of antenna inputs for each node to process, balancing the cost of the antenna inputs (flagged ones
+// cost nothing) and keeping both antenna inputs of each tile on the same node
+std::vector<std::optional<AntennaInputRange>> getNodeAntennaInputAssignments(unsigned nodeCount,
+                                                                              AntennaConfig const& antennaConfig) {
+    return assignNodeAntennaInputs(nodeCount, getAntennaInputCosts(antennaConfig), true);
+}
+
+
 std::optional<AntennaInputRange> communicateNodeAntennaInputAssignment(PrimaryNodeCommunicator const& primary,
-                                                                       unsigned const numAntennaInputs) {
-    // Calculate range of antenna inputs for each node to process
-    auto antennaInputAssignments = assignNodeAntennaInputs(primary.getNodeCount(), numAntennaInputs);
+                                                                       AntennaConfig const& antennaConfig) {
+    auto antennaInputAssignments = getNodeAntennaInputAssignments(primary.getNodeCount(), antennaConfig);
 
 	// Send antenna input assignments to all secondary nodes
     for (unsigned nodeID = 1; nodeID < primary.getNodeCount(); nodeID++) {
         auto const range = antennaInputAssignments.at(nodeID);
-        std::cout << "Assigning node " << nodeID << " antennas | " << range.value().begin << " - " << range.value().end << std::endl;
+        if (range.has_value()) {
+            std::cout << "Assigning node " << nodeID << " antennas | " << range.value().begin << " - " << range.value().end << std::endl;
+        }
+        else {
+            std::cout << "Assigning node " << nodeID << " no antennas" << std::endl;
+        }
 
         primary.sendAntennaInputAssignment(nodeID, range);
     }
 
     auto const range = antennaInputAssignments.at(0);
-    std::cout << "Assigning primary node antennas | " << range.value().begin << " - " << range.value().end << std::endl;
+    if (range.has_value()) {
+        std::cout << "Assigning primary node antennas | " << range.value().begin << " - " << range.value().end << std::endl;
+    }
+    else {
+        std::cout << "Assigning primary node no antennas" << std::endl;
+    }
 
  	return range;
 }
 
 
+// Set up reading the antenna inputs by channel, exchanging the signal files' data with the other nodes.
+// Every node works out the same antenna input assignments as the primary node sends out, so each knows where to send
+// its channels' data. Must be called by every node at the same point
+void openChannelExchange(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                         InternodeCommunicator const& communicator, std::string const& nodeName,
+                         std::optional<ChannelExchange>& channelExchange) {
+    try {
+        channelExchange.emplace(appConfig, antennaConfig, communicator,
+                                getNodeAntennaInputAssignments(communicator.getNodeCount(), antennaConfig));
+    }
+    catch (ReadInputDataException const& e) {
+        // Every node fails together, so there are no other nodes to notify
+        std::cerr << e.what() << std::endl;
+        throw NodeException(nodeName + ": Read error has occurred, terminating node");
+    }
+}
+
+
+// Create the scheduler which hands out antenna inputs to the nodes when scheduling dynamically.
+// Chunks are as large as the input batches (rounded up to whole tiles by the scheduler), so each request gives a node
+// at least one input batch while keeping the chunks small enough to even out the nodes' run times
+AntennaInputScheduler createAntennaInputScheduler(AppConfig const& appConfig, unsigned numNodes,
+                                                  unsigned numAntennaInputs) {
+    auto const chunkSize = appConfig.inputBatchSize;
+    std::cout << "Node 0 (Primary): Scheduling antenna inputs dynamically, in chunks of up to " << chunkSize
+              << " antenna input(s)" << std::endl;
+    return AntennaInputScheduler{numNodes, numAntennaInputs, chunkSize};
+}
+
+
+// Get the batches of antenna inputs for this node to read: the chunks handed out by chunkSource (an
+// AntennaInputDistributor or AntennaInputRequester) as they are needed if scheduling dynamically, otherwise its
+// assigned range
+template<typename ChunkSource>
+AntennaInputPrefetcher::BatchSource getAntennaInputBatchSource(
+    std::optional<AntennaInputRange> const& antennaInputRange, std::optional<ChunkSource>& chunkSource,
+    unsigned batchSize) {
+    if (chunkSource.has_value()) {
+        return splitAntennaInputChunks([&chunkSource]() { return chunkSource->next(); }, batchSize);
+    }
+    else {
+        // The assigned range is the one and only chunk
+        return splitAntennaInputChunks([range = antennaInputRange]() mutable {
+            return std::exchange(range, std::nullopt);
+        }, batchSize);
+    }
+}
+
+
+// Get how the batches of antenna inputs are read: taken from the group of the node's antenna inputs if it has already
+// been exchanged by channel, otherwise read from the signal files
+AntennaInputPrefetcher::BatchReader getAntennaInputBatchReader(AppConfig const& appConfig,
+                                                               AntennaConfig const& antennaConfig,
+                                                               std::optional<AntennaInputBatch>& groupAntennaInputs) {
+    if (groupAntennaInputs.has_value()) {
+        return [&groupAntennaInputs](AntennaInputRange const& batch) {
+            return takeAntennaInputBatch(groupAntennaInputs.value(), batch);
+        };
+    }
+    else {
+        return [&appConfig, &antennaConfig](AntennaInputRange const& batch) {
+            return readAntennaInputBatch(appConfig, antennaConfig, batch);
+        };
+    }
+}
+
+
 // Return the total number of active nodes (nodes that didn't fail on startup)
 unsigned getActiveNodeCount(std::map<unsigned, bool> const& secondaryNodeStatus) {
     unsigned numActiveNodes = 1;
@@ -1,5 +1,7 @@
 #include "NodeAntennaInputAssigner.hpp"
 
+#include <algorithm>
+#include <numeric>
 #include <stdexcept>
 
 // Creates a vector of size numNodes,
@@ -15,41 +17,144 @@ std::vector<std::optional<AntennaInputRange>> assignNodeAntennaInputs(unsigned n
     }
 
     std::vector<std::optional<AntennaInputRange>> ranges;
-    // Calculate average number (rounded down) of antenna inputs per node
-    unsigned averageInputsToProcess = numAntennaInputs / numNodes;
-
-    if (averageInputsToProcess >= 1) {
-        // Assign average number of antenna inputs to all nodes
-        for (unsigned i = 0; i < numNodes; i++) {
-            ranges.push_back({{i * averageInputsToProcess,
-                              (i * averageInputsToProcess) + averageInputsToProcess - 1}});
+    // Every node gets the average number (rounded down) of antenna inputs, and the first nodes get one more each until
+    // all have been assigned
+    unsigned const averageInputsToProcess = numAntennaInputs / numNodes;
+    unsigned const remainingInputs = numAntennaInputs % numNodes;
+    unsigned begin = 0;
+    for (unsigned i = 0; i < numNodes; i++) {
+        unsigned const inputsToProcess = averageInputsToProcess + (i < remainingInputs ? 1 : 0);
+        if (inputsToProcess > 0) {
+            ranges.push_back({{begin, begin + inputsToProcess - 1}});
         }
-        // Assign one additional antenna input to each node until all (inputs) have been assigned
-        unsigned index = 0;
-        while (ranges.back().value().end != numAntennaInputs - 1) {
-            ranges.at(index).value().end++;
-            index++;
-
-            for (unsigned i = index; i < numNodes; i++) {
-                ranges.at(i).value().begin++;
-                ranges.at(i).value().end++;
-            }
+        else {
+            // Assign null to the remaining nodes
+            ranges.push_back(std::nullopt);
         }
+        begin += inputsToProcess;
+    }
+    return ranges;
+}
+
+// Creates a vector of size numNodes, splitting the antenna inputs into contiguous ranges of near equal total cost.
+// The range boundaries are found by binary search of the cumulative costs, so this takes O(n + numNodes log n) time.
+std::vector<std::optional<AntennaInputRange>> assignNodeAntennaInputs(unsigned numNodes, std::vector<double> const& costs,
+                                                                      bool keepTilesTogether) {
+    // Throw exceptions for invalid arguments
+    if (numNodes == 0) {
+        throw std::invalid_argument{"numNodes must be > 0"};
+    }
+    else if (costs.empty()) {
+        throw std::invalid_argument{"costs must not be empty"};
     }
-    else {
-        // Assign one antenna input to each node until all (inputs) have been assigned
-        for (unsigned i = 0; i < numAntennaInputs; i++) {
-            ranges.push_back({{i, i}});
+    else if (std::any_of(costs.begin(), costs.end(), [](double cost) { return !(cost >= 0.0); })) {
+        throw std::invalid_argument{"costs must be >= 0"};
+    }
+
+    unsigned const numAntennaInputs = costs.size();
+    // Ranges are made of whole groups of antenna inputs, either single antenna inputs or tiles
+    unsigned const groupSize = keepTilesTogether ? ANTENNA_INPUTS_PER_TILE : 1;
+    unsigned const numGroups = (numAntennaInputs + groupSize - 1) / groupSize;
+
+    // Total cost of the groups before each group boundary
+    std::vector<double> cumulativeCosts(numGroups + 1, 0.0);
+    for (unsigned i = 0; i < numAntennaInputs; i++) {
+        cumulativeCosts[i / groupSize + 1] += costs[i];
+    }
+    std::partial_sum(cumulativeCosts.begin(), cumulativeCosts.end(), cumulativeCosts.begin());
+    double const totalCost = cumulativeCosts.back();
+    if (totalCost <= 0.0) {
+        return assignNodeAntennaInputs(numNodes, std::vector<double>(numAntennaInputs, 1.0), keepTilesTogether);
+    }
+
+    std::vector<std::optional<AntennaInputRange>> ranges;
+    unsigned beginGroup = 0;
+    for (unsigned i = 0; i < numNodes; i++) {
+        unsigned endGroup = numGroups;
+        if (i + 1 < numNodes) {
+            // End the range at the group boundary closest to this node's share of the total cost
+            double const targetCost = totalCost * (i + 1) / numNodes;
+            auto const boundary = std::lower_bound(cumulativeCosts.begin() + beginGroup, cumulativeCosts.end(),
+                                                   targetCost);
+            endGroup = std::min<unsigned>(boundary - cumulativeCosts.begin(), numGroups);
+            if (endGroup > beginGroup
+                    && targetCost - cumulativeCosts[endGroup - 1] < cumulativeCosts[endGroup] - targetCost) {
+                endGroup--;
+            }
+        }
+
+        if (endGroup > beginGroup) {
+            ranges.push_back({{beginGroup * groupSize, std::min(endGroup * groupSize, numAntennaInputs) - 1}});
         }
-        // Assign null to the remaining nodes
-        while (ranges.size() < numNodes) {
+        else {
             ranges.push_back(std::nullopt);
         }
+        beginGroup = endGroup;
     }
     return ranges;
 }
 
+std::vector<double> getAntennaInputCosts(AntennaConfig const& antennaConfig) {
+    // Channels missing from the observation are missing for every antenna input, so they reduce every cost alike
+    double const unflaggedCost = antennaConfig.frequencyChannels.size();
+    std::vector<double> costs;
+    costs.reserve(antennaConfig.antennaInputs.size());
+    for (auto const& antennaInput : antennaConfig.antennaInputs) {
+        costs.push_back(antennaInput.flagged ? 0.0 : unflaggedCost);
+    }
+    return costs;
+}
+
 // Compare that two AntennaInputRange structs are equal
 bool operator==(AntennaInputRange const& lhs, AntennaInputRange const& rhs) {
     return lhs.begin == rhs.begin && lhs.end == rhs.end;
 }
+
+
+AntennaInputScheduler::AntennaInputScheduler(unsigned numNodes, unsigned numAntennaInputs, unsigned chunkSize) :
+    _chunks(numNodes)
+{
+    // Start from the usual assignment, but of tiles rather than antenna inputs so no tile is split between nodes
+    auto const numTiles = (numAntennaInputs + ANTENNA_INPUTS_PER_TILE - 1) / ANTENNA_INPUTS_PER_TILE;
+    auto const tileRanges = assignNodeAntennaInputs(numNodes, numTiles);
+    auto const tilesPerChunk = std::max((chunkSize + ANTENNA_INPUTS_PER_TILE - 1) / ANTENNA_INPUTS_PER_TILE, 1u);
+    for (unsigned node = 0; node < numNodes; node++) {
+        if (tileRanges.at(node).has_value()) {
+            auto const tiles = tileRanges.at(node).value();
+            for (unsigned tile = tiles.begin; tile <= tiles.end; tile += tilesPerChunk) {
+                auto const endTile = std::min(tile + tilesPerChunk - 1, tiles.end);
+                _chunks.at(node).push_back({tile * ANTENNA_INPUTS_PER_TILE,
+                                            std::min((endTile + 1) * ANTENNA_INPUTS_PER_TILE, numAntennaInputs) - 1});
+            }
+        }
+    }
+}
+
+unsigned AntennaInputScheduler::getNumNodes() const {
+    return _chunks.size();
+}
+
+std::optional<AntennaInputRange> AntennaInputScheduler::next(unsigned node) {
+    auto& chunks = _chunks.at(node);
+    if (chunks.empty()) {
+        // Take over the later half of the chunks left to the node with the most, which it would have reached last
+        auto const victim = std::max_element(_chunks.begin(), _chunks.end(),
+            [](auto const& lhs, auto const& rhs) { return lhs.size() < rhs.size(); });
+        if (victim->empty()) {
+            return std::nullopt;
+        }
+        auto const numStolen = (victim->size() + 1) / 2;
+        chunks.assign(victim->end() - numStolen, victim->end());
+        victim->erase(victim->end() - numStolen, victim->end());
+    }
+
+    auto const chunk = chunks.front();
+    chunks.pop_front();
+    return chunk;
+}
+
+void AntennaInputScheduler::cancel() {
+    for (auto& chunks : _chunks) {
+        chunks.clear();
+    }
+}
@@ -1,12 +1,56 @@
 #pragma once
 
+#include "Common.hpp"
+
+#include <deque>
 #include <optional>
 #include <vector>
 
+// Number of antenna inputs of each tile: its X and Y signal chains, which are consecutive antenna inputs.
+constexpr unsigned ANTENNA_INPUTS_PER_TILE = 2;
+
 struct AntennaInputRange {
 	unsigned int begin;
 	unsigned int end;
 };
 
 std::vector<std::optional<AntennaInputRange>> assignNodeAntennaInputs(unsigned numNodes, unsigned numAntennaInputs);
+// Splits the antenna inputs into contiguous ranges for each node with near equal total cost, given the cost of
+// processing each antenna input (e.g. from getAntennaInputCosts()). If keepTilesTogether is set, both antenna inputs
+// of a tile are always assigned to the same node.
+// Nodes left without any antenna inputs (e.g. if one antenna input costs much more than the rest) get null entries.
+// If every cost is 0, the antenna inputs are split as if they all cost the same.
+// Throws std::invalid_argument if numNodes is 0, costs is empty, or any cost is negative.
+std::vector<std::optional<AntennaInputRange>> assignNodeAntennaInputs(unsigned numNodes, std::vector<double> const& costs,
+                                                                      bool keepTilesTogether);
+// Gets the relative cost of processing each antenna input: 0 for flagged antenna inputs (which are skipped), otherwise
+// the number of frequency channels which are read and processed for it.
+std::vector<double> getAntennaInputCosts(AntennaConfig const& antennaConfig);
 bool operator==(AntennaInputRange const& lhs, AntennaInputRange const& rhs);
+
+
+// Hands out antenna inputs to nodes in chunks as they ask for them, so nodes which get through their antenna inputs
+// quickly take on more (dynamic scheduling).
+// Each node starts with its own contiguous range of whole tiles, split into chunks of chunkSize antenna inputs (rounded
+// up to whole tiles), which it is handed in order. Once a node's chunks run out, it takes the later half of the chunks
+// left to the node with the most, so each node still reads mostly contiguous antenna inputs and the X and Y antenna
+// inputs of a tile are always handed out together.
+// Not thread-safe.
+class AntennaInputScheduler {
+public:
+	// Throws std::invalid_argument if numNodes or numAntennaInputs is 0.
+	AntennaInputScheduler(unsigned numNodes, unsigned numAntennaInputs, unsigned chunkSize);
+
+	unsigned getNumNodes() const;
+
+	// Gets the next chunk of antenna inputs for a node to process, or an empty optional once all have been handed out.
+	// Throws std::out_of_range if node isn't less than the number of nodes.
+	std::optional<AntennaInputRange> next(unsigned node);
+
+	// Drops all the chunks not yet handed out, so next() returns an empty optional from now on.
+	void cancel();
+
+private:
+	// Chunks not yet handed out, for each node in the order they are handed out.
+	std::vector<std::deque<AntennaInputRange>> _chunks;
+};
@@ -4,13 +4,34 @@
 #include <string>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include "Common.hpp"
 #include "OutSignalWriter.hpp"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Alignment of the buffer, offsets and sizes of O_DIRECT writes, which covers the logical block size of the usual
+// file systems
+constexpr std::size_t DIRECT_IO_ALIGNMENT = 4096;
+// Size of the chunks signals are written in by writeAlignedSignalFile(), large enough that each write is efficient
+// without O_DIRECT's page cache bypass, and small enough to keep the aligned buffer cheap
+constexpr std::size_t DIRECT_IO_CHUNK_SIZE = 8 * 1024 * 1024;
+
 static std::filesystem::path generateFilePath(const AppConfig &observation, const AntennaInputPhysID &physID);
 void outSignalWriter(const std::vector<std::int16_t> &inputData, const AppConfig &observation, const AntennaInputPhysID &physID){
 
     std::filesystem::path newpath = generateFilePath(observation,physID);
+
+    if(observation.outputBackend == OutputBackend::direct){
+        writeAlignedSignalFile(newpath, inputData);
+        return;
+    }
     
     //error checking to make sure the file dosnt already exist
     if(std::filesystem::exists(newpath)){
@@ -55,3 +76,90 @@ static std::filesystem::path generateFilePath(const AppConfig &observation, cons
         throw OutSignalException(("Error generating file path"));
     }
 }
+
+
+bool writeAlignedSignalFile(std::filesystem::path const& path, std::vector<std::int16_t> const& signal) {
+    bool direct = true;
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_DIRECT, 0644);
+    if (fd < 0 && errno == EINVAL) {
+        // The file system doesn't allow O_DIRECT
+        direct = false;
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    }
+    if (fd < 0) {
+        throw OutSignalException(errno == EEXIST ? "File Already exists" : "Error Creating File");
+    }
+
+    std::size_t const size = signal.size() * sizeof(std::int16_t);
+    auto const data = reinterpret_cast<char const*>(signal.data());
+    bool success = true;
+    // Allocate the whole file up front so it isn't extended (and possibly fragmented) by every chunk. Only some file
+    // systems support it, but running out of space is a failure either way
+    if (size > 0 && ::fallocate(fd, 0, 0, size) != 0 && errno != EOPNOTSUPP && errno != ENOSYS) {
+        success = false;
+    }
+
+    // O_DIRECT needs an aligned buffer, and the signal's own memory usually isn't aligned
+    std::unique_ptr<char, decltype(&std::free)> buffer{nullptr, &std::free};
+    if (direct) {
+        buffer.reset(static_cast<char*>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, DIRECT_IO_CHUNK_SIZE)));
+        direct = buffer != nullptr;
+        if (!direct) {
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+        }
+    }
+
+    for (std::size_t offset = 0; success && offset < size; offset += DIRECT_IO_CHUNK_SIZE) {
+        auto const chunkSize = std::min(DIRECT_IO_CHUNK_SIZE, size - offset);
+        if (direct) {
+            // The last chunk is padded to a whole number of aligned blocks, and the padding truncated afterwards
+            auto const paddedSize = (chunkSize + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+            std::memcpy(buffer.get(), data + offset, chunkSize);
+            std::memset(buffer.get() + chunkSize, 0, paddedSize - chunkSize);
+            if (writeFully(fd, buffer.get(), paddedSize, offset)) {
+                continue;
+            }
+            else if (errno != EINVAL) {
+                success = false;
+                break;
+            }
+            // Some file systems accept O_DIRECT when opening but not when writing (or need larger alignment), so
+            // carry on without it
+            direct = false;
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+        }
+        success = writeFully(fd, data + offset, chunkSize, offset);
+    }
+
+    // Remove any padding, and check the file ended up the right size
+    struct stat status;
+    success = success && ::ftruncate(fd, size) == 0 && ::fstat(fd, &status) == 0
+              && static_cast<std::size_t>(status.st_size) == size;
+    success = ::close(fd) == 0 && success;
+    if (!success) {
+        throw OutSignalException(("Error writing to output file"));
+    }
+    return direct;
+}
+
+
+bool writeFully(int fd, void const* data, std::size_t size, std::size_t offset) {
+    auto bytes = static_cast<char const*>(data);
+    while (size > 0) {
+        auto const written = ::pwrite(fd, bytes, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        // No progress (e.g. the device is full), which would otherwise loop forever
+        if (written == 0) {
+            return false;
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+    return true;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -12,6 +13,15 @@ struct AntennaInputPhysID;
 
 void outSignalWriter(const std::vector<std::int16_t> &inputData, const AppConfig &observation, const AntennaInputPhysID &physID);
 
+// Writes a signal to a new file as OutputBackend::direct does: the file is preallocated at its final size, then written
+// in large chunks which bypass the page cache (O_DIRECT), or with plain pwrite() if the file system doesn't allow
+// O_DIRECT. Returns whether O_DIRECT was used for the whole file.
+// Throws OutSignalException if the file already exists or can't be written.
+bool writeAlignedSignalFile(std::filesystem::path const& path, std::vector<std::int16_t> const& signal);
+
+// Writes all of data to a file descriptor at offset, retrying partial writes. Returns false on error, with errno set.
+bool writeFully(int fd, void const* data, std::size_t size, std::size_t offset);
+
 //Custom Exception
 class OutSignalException : public std::exception {
 public:
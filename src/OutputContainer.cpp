@@ -0,0 +1,264 @@
+#include "OutputContainer.hpp"
+
+#include "OutSignalWriter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+static std::size_t alignUp(std::size_t size) {
+    return (size + OUTPUT_CONTAINER_ALIGNMENT - 1) / OUTPUT_CONTAINER_ALIGNMENT * OUTPUT_CONTAINER_ALIGNMENT;
+}
+
+// Size of each signal's slot, a whole number of aligned blocks
+static std::size_t getSlotSize(OutputContainerLayout const& layout) {
+    return alignUp(layout.numSamples * sizeof(std::int16_t));
+}
+
+static void putLittleEndian(std::uint8_t* destination, std::uint64_t value, std::size_t size) {
+    for (std::size_t i = 0; i < size; i++) {
+        destination[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+static std::uint64_t getLittleEndian(std::uint8_t const* source, std::size_t size) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        value |= static_cast<std::uint64_t>(source[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Reads all of size bytes at offset, retrying partial reads. Fails if the file ends first
+static bool readFully(int fd, void* data, std::size_t size, std::size_t offset) {
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        auto const read = ::pread(fd, bytes, size, offset);
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read <= 0) {
+            return false;
+        }
+        bytes += read;
+        size -= read;
+        offset += read;
+    }
+    return true;
+}
+
+static std::vector<std::uint8_t> serialiseHeader(OutputContainerLayout const& layout) {
+    std::vector<std::uint8_t> header(OUTPUT_CONTAINER_HEADER_SIZE, 0);
+    std::copy(std::begin(OUTPUT_CONTAINER_MAGIC), std::end(OUTPUT_CONTAINER_MAGIC), header.begin());
+    putLittleEndian(&header[8], OUTPUT_CONTAINER_VERSION, 4);
+    putLittleEndian(&header[12], layout.samplingFreq, 4);
+    putLittleEndian(&header[16], layout.observationID, 8);
+    putLittleEndian(&header[24], layout.signalStartTime, 8);
+    putLittleEndian(&header[32], layout.numSamples, 8);
+    putLittleEndian(&header[40], layout.antennaInputs.size(), 4);
+    putLittleEndian(&header[48], layout.dataOffset, 8);
+    return header;
+}
+
+static std::vector<std::uint8_t> serialiseTable(OutputContainerLayout const& layout) {
+    std::vector<std::uint8_t> table(layout.antennaInputs.size() * OUTPUT_CONTAINER_ENTRY_SIZE, 0);
+    for (std::size_t i = 0; i < layout.antennaInputs.size(); i++) {
+        auto const& entry = layout.antennaInputs[i];
+        auto const destination = &table[i * OUTPUT_CONTAINER_ENTRY_SIZE];
+        putLittleEndian(destination, entry.tile, 4);
+        destination[4] = static_cast<std::uint8_t>(entry.signalChain);
+        destination[5] = entry.flagged;
+        destination[6] = entry.written;
+        putLittleEndian(destination + 8, entry.offset, 8);
+    }
+    return table;
+}
+
+static OutputContainerLayout readLayout(int fd) {
+    std::vector<std::uint8_t> header(OUTPUT_CONTAINER_HEADER_SIZE);
+    if (!readFully(fd, header.data(), header.size(), 0)) {
+        throw OutSignalException("Error reading output container header");
+    }
+    if (!std::equal(std::begin(OUTPUT_CONTAINER_MAGIC), std::end(OUTPUT_CONTAINER_MAGIC), header.begin())
+            || getLittleEndian(&header[8], 4) != OUTPUT_CONTAINER_VERSION) {
+        throw OutSignalException("Not a valid output container");
+    }
+
+    OutputContainerLayout layout{
+        static_cast<unsigned>(getLittleEndian(&header[12], 4)),
+        getLittleEndian(&header[16], 8),
+        getLittleEndian(&header[24], 8),
+        getLittleEndian(&header[32], 8),
+        getLittleEndian(&header[48], 8),
+        std::vector<OutputContainerEntry>(getLittleEndian(&header[40], 4))
+    };
+    std::vector<std::uint8_t> table(layout.antennaInputs.size() * OUTPUT_CONTAINER_ENTRY_SIZE);
+    if (!readFully(fd, table.data(), table.size(), OUTPUT_CONTAINER_HEADER_SIZE)) {
+        throw OutSignalException("Error reading output container antenna input table");
+    }
+    for (std::size_t i = 0; i < layout.antennaInputs.size(); i++) {
+        auto const source = &table[i * OUTPUT_CONTAINER_ENTRY_SIZE];
+        layout.antennaInputs[i] = {
+            static_cast<unsigned>(getLittleEndian(source, 4)),
+            static_cast<char>(source[4]),
+            source[5] != 0,
+            source[6] != 0,
+            getLittleEndian(source + 8, 8)
+        };
+    }
+
+    // Every signal must be within the file, so writing one can't overwrite the header or table
+    struct stat fileStatus{};
+    if (::fstat(fd, &fileStatus) != 0) {
+        throw OutSignalException("Error reading output container");
+    }
+    auto const fileSize = static_cast<std::size_t>(fileStatus.st_size);
+    for (auto const& entry : layout.antennaInputs) {
+        if (!entry.flagged && (entry.offset < layout.dataOffset
+                               || entry.offset + layout.numSamples * sizeof(std::int16_t) > fileSize)) {
+            throw OutSignalException("Not a valid output container");
+        }
+    }
+    return layout;
+}
+
+
+std::size_t OutputContainerLayout::getFileSize() const {
+    auto const numSignals = std::count_if(antennaInputs.begin(), antennaInputs.end(),
+                                          [](OutputContainerEntry const& entry) { return !entry.flagged; });
+    return dataOffset + numSignals * getSlotSize(*this);
+}
+
+
+OutputContainerLayout planOutputContainer(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                          unsigned samplingFreq, unsigned long long numSamples) {
+    OutputContainerLayout layout{
+        samplingFreq,
+        appConfig.observationID,
+        appConfig.signalStartTime,
+        numSamples,
+        alignUp(OUTPUT_CONTAINER_HEADER_SIZE + antennaConfig.antennaInputs.size() * OUTPUT_CONTAINER_ENTRY_SIZE),
+        {}
+    };
+    // Flagged antenna inputs aren't processed, so they don't get a slot
+    auto offset = layout.dataOffset;
+    for (auto const& antennaInput : antennaConfig.antennaInputs) {
+        layout.antennaInputs.push_back({antennaInput.tile, antennaInput.signalChain, antennaInput.flagged, false,
+                                        antennaInput.flagged ? 0 : offset});
+        if (!antennaInput.flagged) {
+            offset += getSlotSize(layout);
+        }
+    }
+    return layout;
+}
+
+std::filesystem::path getOutputContainerPath(AppConfig const& appConfig) {
+    if (appConfig.outputDirectoryPath.empty()) {
+        throw OutSignalException("Error generating file path");
+    }
+    return std::filesystem::path{appConfig.outputDirectoryPath} /
+        (std::to_string(appConfig.observationID) + "_" + std::to_string(appConfig.signalStartTime) + ".tdr");
+}
+
+void createOutputContainer(std::filesystem::path const& path, OutputContainerLayout const& layout) {
+    // Fails if the file already exists, in the same check as the create
+    int const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        throw OutSignalException(errno == EEXIST ? "File Already exists" : "Error Creating File");
+    }
+    auto const header = serialiseHeader(layout);
+    auto const table = serialiseTable(layout);
+    // Sizing the file up front leaves the unwritten signals as holes, rather than extending the file with each write
+    bool const success = writeFully(fd, header.data(), header.size(), 0)
+                         && writeFully(fd, table.data(), table.size(), header.size())
+                         && ::ftruncate(fd, layout.getFileSize()) == 0;
+    if (::close(fd) != 0 || !success) {
+        throw OutSignalException("Error writing to output container");
+    }
+}
+
+OutputContainerLayout readOutputContainerLayout(std::filesystem::path const& path) {
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw OutSignalException("Error opening output container");
+    }
+    try {
+        auto layout = readLayout(fd);
+        ::close(fd);
+        return layout;
+    }
+    catch (OutSignalException const&) {
+        ::close(fd);
+        throw;
+    }
+}
+
+void markOutputContainerWritten(std::filesystem::path const& path, ObservationProcessingResults const& processingResults) {
+    int const fd = ::open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw OutSignalException("Error opening output container");
+    }
+    try {
+        auto layout = readLayout(fd);
+        for (auto const& [index, results] : processingResults.results) {
+            if (results.success && index < layout.antennaInputs.size()) {
+                layout.antennaInputs[index].written = true;
+            }
+        }
+        auto const table = serialiseTable(layout);
+        if (!writeFully(fd, table.data(), table.size(), OUTPUT_CONTAINER_HEADER_SIZE)) {
+            throw OutSignalException("Error writing to output container");
+        }
+    }
+    catch (OutSignalException const&) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) {
+        throw OutSignalException("Error writing to output container");
+    }
+}
+
+
+OutputContainerWriter::OutputContainerWriter(std::filesystem::path const& path) :
+    _fd{::open(path.c_str(), O_RDWR)}, _layout{}
+{
+    if (_fd < 0) {
+        throw OutSignalException("Error opening output container");
+    }
+    try {
+        _layout = readLayout(_fd);
+    }
+    catch (OutSignalException const&) {
+        ::close(_fd);
+        throw;
+    }
+}
+
+OutputContainerWriter::~OutputContainerWriter() {
+    ::close(_fd);
+}
+
+OutputContainerLayout const& OutputContainerWriter::getLayout() const {
+    return _layout;
+}
+
+void OutputContainerWriter::write(unsigned antennaInput, std::vector<std::int16_t> const& signal) const {
+    if (antennaInput >= _layout.antennaInputs.size() || _layout.antennaInputs[antennaInput].flagged) {
+        throw OutSignalException("Antenna input has no signal in the output container");
+    }
+    if (signal.size() != _layout.numSamples) {
+        throw OutSignalException("Signal doesn't match the output container's number of samples");
+    }
+    if (!writeFully(_fd, signal.data(), signal.size() * sizeof(std::int16_t),
+                    _layout.antennaInputs[antennaInput].offset)) {
+        throw OutSignalException("Error writing to output container");
+    }
+}
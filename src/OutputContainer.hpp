@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+// Single file output for a whole observation, used instead of one file per antenna input (see OutSignalWriter.hpp) with
+// --output-format=container. The primary node creates the file with its header and antenna input table, then every
+// node writes its antenna inputs' signals straight into their slots, so the file system sees one create rather than one
+// per antenna input.
+//
+// File layout (all integers little-endian):
+//  - Header, OUTPUT_CONTAINER_HEADER_SIZE bytes:
+//      - 0: magic, the 8 characters "MWATDRC\0"
+//      - 8: format version (u32), OUTPUT_CONTAINER_VERSION
+//      - 12: sampling frequency of the signals (u32), as a multiple of the channel bandwidth
+//            (ChannelRemapping::newSamplingFreq)
+//      - 16: observation ID (u64)
+//      - 24: signal start time (u64)
+//      - 32: number of samples in each signal (u64)
+//      - 40: number of antenna inputs (u32)
+//      - 44: reserved (u32), 0
+//      - 48: offset of the first signal from the start of the file (u64)
+//      - 56: reserved (u64), 0
+//  - Antenna input table, directly after the header, with one OUTPUT_CONTAINER_ENTRY_SIZE byte entry for each antenna
+//    input in the metadata file's order:
+//      - 0: tile ID (u32)
+//      - 4: signal chain (character)
+//      - 5: 1 if the antenna input is flagged, else 0 (u8)
+//      - 6: 1 if the antenna input's signal was written, else 0 (u8)
+//      - 7: reserved (u8), 0
+//      - 8: offset of the signal from the start of the file (u64), 0 for flagged antenna inputs
+//  - Signals, each as 16-bit signed integers, at offsets aligned to OUTPUT_CONTAINER_ALIGNMENT bytes. Flagged antenna
+//    inputs have no signal. The slots of signals which weren't written are left as holes in the file.
+
+
+constexpr char OUTPUT_CONTAINER_MAGIC[8] = {'M', 'W', 'A', 'T', 'D', 'R', 'C', '\0'};
+constexpr std::uint32_t OUTPUT_CONTAINER_VERSION = 1;
+constexpr std::size_t OUTPUT_CONTAINER_HEADER_SIZE = 64;
+constexpr std::size_t OUTPUT_CONTAINER_ENTRY_SIZE = 16;
+// Signals start on file system block boundaries, so nodes writing neighbouring signals don't write the same blocks.
+constexpr std::size_t OUTPUT_CONTAINER_ALIGNMENT = 4096;
+
+
+// Entry of the antenna input table of an output container.
+struct OutputContainerEntry {
+    unsigned tile;
+    char signalChain;
+    bool flagged;
+    // Whether the signal has been written. Only set once the whole observation has been processed.
+    bool written;
+    // Offset of the signal from the start of the file, 0 if flagged.
+    unsigned long long offset;
+};
+
+// Contents of an output container's header and antenna input table.
+struct OutputContainerLayout {
+    unsigned samplingFreq;
+    unsigned long long observationID;
+    unsigned long long signalStartTime;
+    // Number of samples in each signal.
+    unsigned long long numSamples;
+    // Offset of the first signal from the start of the file.
+    unsigned long long dataOffset;
+    std::vector<OutputContainerEntry> antennaInputs;
+
+    // Size of the whole file, including the slots of every unflagged antenna input's signal.
+    std::size_t getFileSize() const;
+};
+
+
+// Plans the layout of an output container for the observation's antenna inputs, with signals of numSamples samples at
+// sampling frequency samplingFreq (as a multiple of the channel bandwidth).
+OutputContainerLayout planOutputContainer(AppConfig const& appConfig, AntennaConfig const& antennaConfig,
+                                          unsigned samplingFreq, unsigned long long numSamples);
+
+// Gets the path of the observation's output container: <output directory>/<observation ID>_<signal start time>.tdr
+// Throws OutSignalException if the output directory is empty.
+std::filesystem::path getOutputContainerPath(AppConfig const& appConfig);
+
+// Creates the output container file with the header and antenna input table of layout, sized for all the signals.
+// Throws OutSignalException if the file already exists or can't be written.
+void createOutputContainer(std::filesystem::path const& path, OutputContainerLayout const& layout);
+
+// Reads the header and antenna input table of an output container.
+// Throws OutSignalException if the file can't be read or isn't a valid output container.
+OutputContainerLayout readOutputContainerLayout(std::filesystem::path const& path);
+
+// Marks the signals of the antenna inputs which were processed successfully as written in the container's antenna
+// input table.
+// Throws OutSignalException if the file can't be read or written, or isn't a valid output container.
+void markOutputContainerWritten(std::filesystem::path const& path, ObservationProcessingResults const& processingResults);
+
+
+// Writes processed signals into their slots of an existing output container. Signals may be written from multiple
+// threads at once.
+class OutputContainerWriter {
+public:
+    // Opens the output container and reads its layout.
+    // Throws OutSignalException if the file can't be opened or isn't a valid output container.
+    explicit OutputContainerWriter(std::filesystem::path const& path);
+    OutputContainerWriter(OutputContainerWriter const&) = delete;
+
+    ~OutputContainerWriter();
+
+    OutputContainerLayout const& getLayout() const;
+
+    // Writes the signal of an antenna input (indexed as in the antenna input table).
+    // Throws OutSignalException if the antenna input isn't in the container or is flagged, the signal is the wrong size,
+    // or it can't be written.
+    void write(unsigned antennaInput, std::vector<std::int16_t> const& signal) const;
+
+    OutputContainerWriter& operator=(OutputContainerWriter const&) = delete;
+
+private:
+    int _fd;
+    OutputContainerLayout _layout;
+};
@@ -2,22 +2,28 @@
 
 #include "ChannelRemapping.hpp"
 #include "Common.hpp"
+#include "StageTiming.hpp"
 
 #include <cmath>
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <set>
 
 
 void writeObservationDetails(std::ofstream& log, AppConfig const& appConfig);
-void writeProcessingDetails(std::ofstream& log, ChannelRemapping const& channelRemapping);
+void writeProcessingDetails(std::ofstream& log, ChannelRemapping const& channelRemapping, unsigned minSamplingFreq);
 void writeChannelRemappingDetails(std::ofstream& log, ChannelRemapping const& channelRemapping);
 void writeProcessingResults(std::ofstream& log, ObservationProcessingResults const& results, AntennaConfig const& antennaConfig);
+void writeStageTimings(std::ofstream& log, ObservationProcessingResults const& results);
+void writeStageSummaries(std::ofstream& log, ObservationProcessingResults const& results, std::optional<unsigned> node);
 std::filesystem::path generateOutputLogFilepath(AppConfig const& appConfig);
 double roundThreeDecimalPlace(double num);
 
 
-void writeLogFile(AppConfig const& appConfig, ChannelRemapping const& channelRemapping,
+void writeLogFile(AppConfig const& appConfig, ChannelRemapping const& channelRemapping, unsigned minSamplingFreq,
 				  ObservationProcessingResults const& results, AntennaConfig const& antennaConfig) {
     // Generate output log filepath and open file for writing
 	auto filepath = generateOutputLogFilepath(appConfig);
@@ -25,9 +31,10 @@ void writeLogFile(AppConfig const& appConfig, ChannelRemapping const& channelRem
 
 	if (log.is_open()) {
 		writeObservationDetails(log, appConfig);
-		writeProcessingDetails(log, channelRemapping);
+		writeProcessingDetails(log, channelRemapping, minSamplingFreq);
 		writeChannelRemappingDetails(log, channelRemapping);
 		writeProcessingResults(log, results, antennaConfig);
+		writeStageTimings(log, results);
 
         // Check if error occurred while writing
         if (log.fail()) {
@@ -51,7 +58,7 @@ void writeObservationDetails(std::ofstream& log, AppConfig const& appConfig) {
 }
 
 // Write information about the signal sample rate and sampling period to the log file.
-void writeProcessingDetails(std::ofstream& log, ChannelRemapping const& channelRemapping) {
+void writeProcessingDetails(std::ofstream& log, ChannelRemapping const& channelRemapping, unsigned minSamplingFreq) {
     const double CHANNEL_BANDWIDTH_MHZ = 1.28;
 
     // Calculate output sample rate and sampling period (time between samples) for processed signals
@@ -60,6 +67,7 @@ void writeProcessingDetails(std::ofstream& log, ChannelRemapping const& channelR
 
     log << "SIGNAL PROCESSING DETAILS" << std::endl;
     log << "Integer length of Fourier transform: " << channelRemapping.newSamplingFreq << std::endl;
+    log << "Minimal integer length of Fourier transform: " << minSamplingFreq << std::endl;
     log << "Output sample rate: " << roundThreeDecimalPlace(sampleRate) << " MHz" << std::endl;
     log << "Output sampling period: " << roundThreeDecimalPlace(samplingPeriod) << " ns\n" << std::endl;
 }
@@ -111,6 +119,45 @@ void writeProcessingResults(std::ofstream& log, ObservationProcessingResults con
     }
 }
 
+// Write the time spent in each processing stage and its throughput, over all nodes and then for each node, to the log
+// file.
+void writeStageTimings(std::ofstream& log, ObservationProcessingResults const& results) {
+    log << "PROCESSING STAGE TIMINGS" << std::endl;
+    log << "Time per antenna input given as min / median / max, throughput is the data produced per second in the stage"
+        << std::endl;
+    log << "All nodes:" << std::endl;
+    writeStageSummaries(log, results, {});
+
+    std::set<unsigned> nodes;
+    for (auto const& [index, outcome] : results.results) {
+        nodes.insert(outcome.node);
+    }
+    for (auto const node : nodes) {
+        log << "Node " << node << ":" << std::endl;
+        writeStageSummaries(log, results, node);
+    }
+}
+
+// Write a summary line for each processing stage, over the antenna inputs processed by node (or all nodes if empty).
+void writeStageSummaries(std::ofstream& log, ObservationProcessingResults const& results, std::optional<unsigned> node) {
+    for (std::size_t stage = 0; stage < NUM_PROCESSING_STAGES; ++stage) {
+        auto const summary = summariseStage(results, static_cast<ProcessingStage>(stage), node);
+        log << "-" << getStageName(static_cast<ProcessingStage>(stage)) << ": ";
+        if (summary.numAntennaInputs == 0) {
+            log << "N/A" << std::endl;
+            continue;
+        }
+        log << summary.numAntennaInputs << " antenna input(s), "
+            << roundThreeDecimalPlace(summary.totalSeconds) << " s total, "
+            << roundThreeDecimalPlace(summary.minSeconds) << " / "
+            << roundThreeDecimalPlace(summary.medianSeconds) << " / "
+            << roundThreeDecimalPlace(summary.maxSeconds) << " s, "
+            << roundThreeDecimalPlace(getBytesPerSecond(summary) / 1e6) << " MB/s, "
+            << roundThreeDecimalPlace(getSamplesPerSecond(summary) / 1e6) << " Msamples/s" << std::endl;
+    }
+    log << std::endl;
+}
+
 
 // Generates a filepath which can be used to open the log file for writing.
 std::filesystem::path generateOutputLogFilepath(AppConfig const& appConfig) {
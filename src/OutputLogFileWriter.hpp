@@ -8,8 +8,10 @@ struct AppConfig;
 struct ChannelRemapping;
 struct ObservationProcessingResults;
 
+// minSamplingFreq is the new sampling frequency of the minimal channel remapping, which channelRemapping may differ
+// from if it was chosen for a cheaper Fourier transform.
 // Throws LogWriterException
-void writeLogFile(AppConfig const& appConfig, ChannelRemapping const& channelRemapping,
+void writeLogFile(AppConfig const& appConfig, ChannelRemapping const& channelRemapping, unsigned minSamplingFreq,
 				  ObservationProcessingResults const& results, AntennaConfig const& antennaConfig);
 
 class LogWriterException : public std::runtime_error {
@@ -0,0 +1,147 @@
+#include "OverlapSaveFilter.hpp"
+
+#include "SignalProcessing.hpp"
+
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <mkl.h>
+
+
+// Shortest FFT length used, below which the cost of each transform is dominated by overheads.
+constexpr unsigned MIN_SEGMENT_LENGTH = 256;
+// Segments are at least this many times the filter length, so little of each transform is spent on the overlap.
+constexpr unsigned SEGMENT_LENGTH_FACTOR = 8;
+
+
+// Throws if an MKL DFT function failed.
+static void handleDFTError(MKL_LONG const status) {
+    if (status && !DftiErrorClass(status, DFTI_NO_ERROR)) {
+        throw SignalProcessingMKLError{std::string{"Overlap-save FFT error: "} + DftiErrorMessage(status)};
+    }
+}
+
+
+// MKL descriptor of the forward and inverse FFTs of a segment, for all channels at once.
+struct OverlapSaveFilter::FFT {
+    DFTI_DESCRIPTOR_HANDLE descriptor = nullptr;
+
+    ~FFT() {
+        if (descriptor != nullptr) {
+            DftiFreeDescriptor(&descriptor);
+        }
+    }
+};
+
+
+unsigned chooseOverlapSaveSegmentLength(unsigned numTaps) {
+    unsigned segmentLength = MIN_SEGMENT_LENGTH;
+    while (segmentLength < numTaps * SEGMENT_LENGTH_FACTOR) {
+        segmentLength *= 2;
+    }
+    return segmentLength;
+}
+
+
+OverlapSaveFilter::OverlapSaveFilter(std::vector<std::complex<float>> const& taps, unsigned numChannels,
+                                     unsigned segmentLength) :
+    _numChannels{numChannels},
+    _numTaps{},
+    _segmentLength{segmentLength},
+    _tapSpectra{},
+    _fft{},
+    _segment{}
+{
+    if (numChannels == 0 || taps.empty() || taps.size() % numChannels != 0) {
+        throw std::invalid_argument{"FIR filter taps must be a non-empty multiple of the number of channels"};
+    }
+    _numTaps = taps.size() / numChannels;
+    if (_segmentLength == 0) {
+        _segmentLength = chooseOverlapSaveSegmentLength(_numTaps);
+    }
+    if (_segmentLength < _numTaps) {
+        throw std::invalid_argument{"Overlap-save segment length must be at least the number of taps"};
+    }
+
+    // Each channel is a transform along the time axis, so its samples are numChannels apart and consecutive channels
+    // are 1 apart
+    _fft = std::make_unique<FFT>();
+    MKL_LONG const strides[] = {0, static_cast<MKL_LONG>(numChannels)};
+    handleDFTError(DftiCreateDescriptor(&_fft->descriptor, DFTI_SINGLE, DFTI_COMPLEX, 1,
+                                        static_cast<MKL_LONG>(_segmentLength)));
+    handleDFTError(DftiSetValue(_fft->descriptor, DFTI_PLACEMENT, DFTI_INPLACE));
+    handleDFTError(DftiSetValue(_fft->descriptor, DFTI_NUMBER_OF_TRANSFORMS, static_cast<MKL_LONG>(numChannels)));
+    handleDFTError(DftiSetValue(_fft->descriptor, DFTI_INPUT_DISTANCE, static_cast<MKL_LONG>(1)));
+    handleDFTError(DftiSetValue(_fft->descriptor, DFTI_OUTPUT_DISTANCE, static_cast<MKL_LONG>(1)));
+    handleDFTError(DftiSetValue(_fft->descriptor, DFTI_INPUT_STRIDES, strides));
+    handleDFTError(DftiSetValue(_fft->descriptor, DFTI_OUTPUT_STRIDES, strides));
+    handleDFTError(DftiCommitDescriptor(_fft->descriptor));
+
+    // Spectra of the taps, scaled so the inverse transform needs no scaling of its own
+    _tapSpectra.assign(static_cast<std::size_t>(_segmentLength) * numChannels, {0.0f, 0.0f});
+    std::copy(taps.begin(), taps.end(), _tapSpectra.begin());
+    handleDFTError(DftiComputeForward(_fft->descriptor, _tapSpectra.data()));
+    float const scale = 1.0f / _segmentLength;
+    for (auto& value : _tapSpectra) {
+        value *= scale;
+    }
+
+    _segment.resize(_tapSpectra.size());
+}
+
+OverlapSaveFilter::~OverlapSaveFilter() = default;
+
+unsigned OverlapSaveFilter::getNumChannels() const {
+    return _numChannels;
+}
+
+unsigned OverlapSaveFilter::getNumTaps() const {
+    return _numTaps;
+}
+
+unsigned OverlapSaveFilter::getSegmentLength() const {
+    return _segmentLength;
+}
+
+void OverlapSaveFilter::apply(std::complex<float>* signal, std::size_t numBlocks) {
+    if (numBlocks == 0) {
+        return;
+    }
+
+    std::size_t const rowSize = _numChannels;
+    // Output block b uses input blocks b - pastBlocks to b + futureBlocks
+    std::size_t const futureBlocks = _numTaps / 2;
+    std::size_t const pastBlocks = _numTaps - 1 - futureBlocks;
+    // The first numTaps - 1 blocks of each filtered segment are wrapped around by the circular convolution, the rest
+    // are output
+    std::size_t const overlapBlocks = _numTaps - 1;
+    std::size_t const stepBlocks = _segmentLength - overlapBlocks;
+
+    // The original input of the pastBlocks blocks before the segment, since they have been overwritten with their
+    // output by the time the segment is filtered. Zero before the start of the signal.
+    std::vector<std::complex<float>> history(pastBlocks * rowSize, {0.0f, 0.0f});
+
+    for (std::size_t begin = 0; begin < numBlocks; begin += stepBlocks) {
+        std::size_t const numOutputBlocks = std::min(stepBlocks, numBlocks - begin);
+
+        // Segment block i is input block begin - pastBlocks + i, zero past the end of the signal
+        std::copy(history.begin(), history.end(), _segment.begin());
+        std::size_t const inputEnd = std::min(begin + _segmentLength - pastBlocks, numBlocks);
+        auto const segmentInputEnd = std::copy(signal + begin * rowSize, signal + inputEnd * rowSize,
+                                               _segment.begin() + pastBlocks * rowSize);
+        std::fill(segmentInputEnd, _segment.end(), std::complex<float>{0.0f, 0.0f});
+        // The next segment's history is the input just before its first output block
+        std::copy_n(_segment.begin() + numOutputBlocks * rowSize, history.size(), history.begin());
+
+        handleDFTError(DftiComputeForward(_fft->descriptor, _segment.data()));
+        vcMul(static_cast<MKL_INT>(_segment.size()), reinterpret_cast<MKL_Complex8 const*>(_segment.data()),
+              reinterpret_cast<MKL_Complex8 const*>(_tapSpectra.data()), reinterpret_cast<MKL_Complex8*>(_segment.data()));
+        handleDFTError(DftiComputeBackward(_fft->descriptor, _segment.data()));
+
+        std::copy_n(_segment.begin() + overlapBlocks * rowSize, numOutputBlocks * rowSize, signal + begin * rowSize);
+    }
+}
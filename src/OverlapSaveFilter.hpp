@@ -0,0 +1,56 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+// Gets the FFT length used by OverlapSaveFilter for filters of numTaps taps: the smallest power of 2 of at least
+// 8 times the number of taps (and at least 256), so at most an eighth of each transformed segment is overlap.
+unsigned chooseOverlapSaveSegmentLength(unsigned numTaps);
+
+
+// FIR filters for every channel of a complex signal laid out [block][channel], using FFT convolution (overlap-save)
+// along the time axis. Segments of the signal are transformed for all channels at once, multiplied by the cached
+// spectra of the taps, and transformed back, so the cost per sample grows with the log of the filter length rather
+// than the filter length. Used for the inverse PFB when the filters are long.
+// The filter's scratch buffers and MKL descriptor are reused by each call to apply(), so a filter may only be used by
+// one thread at a time.
+class OverlapSaveFilter {
+public:
+    // taps holds numTaps (possibly complex) taps for each of numChannels channels, laid out [tap][channel].
+    // segmentLength is the FFT length, which must be greater than numTaps - 1. 0 uses
+    // chooseOverlapSaveSegmentLength().
+    // Throws std::invalid_argument if taps is empty or not a multiple of numChannels, or segmentLength is too short,
+    // or SignalProcessingMKLError (see SignalProcessing.hpp) if MKL fails to create the FFT descriptor.
+    OverlapSaveFilter(std::vector<std::complex<float>> const& taps, unsigned numChannels, unsigned segmentLength = 0);
+    OverlapSaveFilter(OverlapSaveFilter const&) = delete;
+    OverlapSaveFilter(OverlapSaveFilter&&) = delete;
+    ~OverlapSaveFilter();
+
+    OverlapSaveFilter& operator=(OverlapSaveFilter const&) = delete;
+    OverlapSaveFilter& operator=(OverlapSaveFilter&&) = delete;
+
+    unsigned getNumChannels() const;
+    unsigned getNumTaps() const;
+    unsigned getSegmentLength() const;
+
+    // Filters numBlocks blocks of signal in place, with the same output as ChannelFIRFilter::apply(): output block b
+    // is sum(taps[k] * signal[b + numTaps/2 - k]), with the signal taken as zero outside its blocks.
+    void apply(std::complex<float>* signal, std::size_t numBlocks);
+
+private:
+    // MKL descriptor, defined in OverlapSaveFilter.cpp so MKL isn't needed to use this header
+    struct FFT;
+
+    unsigned _numChannels;
+    unsigned _numTaps;
+    unsigned _segmentLength;
+    // Forward transform of each channel's taps, zero padded to the segment length and scaled by 1 / segmentLength for
+    // the inverse transform. Laid out [frequency][channel].
+    std::vector<std::complex<float>> _tapSpectra;
+    std::unique_ptr<FFT> _fft;
+    // Segment being filtered, laid out [block][channel]
+    std::vector<std::complex<float>> _segment;
+};
@@ -7,6 +7,7 @@
 #include <complex>
 #include <array>
 #include <string>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 
@@ -32,12 +33,15 @@ std::vector<std::complex<float>> readCoeData(std::string fileName){
             throw ReadCoeDataException("Error File size is not expected");
         }
 
-        // reading the data into the array
-       float rbuffer;
-       result.reserve(filterLength*MWA_NUM_CHANNELS);
-       while(infile.read(reinterpret_cast<char*>(&rbuffer), sizeof(float)))
-
-       result.push_back({rbuffer,0.0f});
+        // reading all of the data into the array with one read, rather than a float at a time
+        std::vector<float> values(static_cast<std::size_t>(filterLength)*MWA_NUM_CHANNELS);
+        if(!infile.read(reinterpret_cast<char*>(values.data()), values.size()*sizeof(float))){
+            throw ReadCoeDataException("Error reading the file");
+        }
+        result.reserve(values.size());
+        for(auto const value : values){
+            result.push_back({value,0.0f});
+        }
     }
     else{
         throw ReadCoeDataException("Failed to open the file");
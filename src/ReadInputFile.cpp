@@ -12,109 +12,113 @@
 */
 #include "ReadInputFile.hpp"
 #include "Common.hpp"
+#include "SampleConversion.hpp"
+#include "SubfileIndex.hpp"
+#include "SubfileView.hpp"
 #include <complex>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string>
-#include <filesystem>
-
-//Meta data inside each file readers
-std::string getMetaDataString(std::string fileName);
-unsigned int getMetaDataSize(std::string fileName);
-int getNInputs(std::string fileName);
-int getNPols(std::string fileName);
-int getNSamples(std::string fileName);
+#include <utility>
 
 //Main function for reading in of the data file takes the name of the file it is to read from
 //will read all files for a specific calculation into 1 complex vector array for signal processing
-std::vector<std::complex<float>> readInputDataFile(std::string fileName,int antenaInput, unsigned int expectedNInputs){    
-
-    std::vector<std::complex<float>> datavalues;
-        
-    std::string metadata = getMetaDataString(fileName);
-    long long metadatasize = getMetaDataSize(metadata);
-    //This is the number of samples per 50ms time slice in the data files this is subject to change based on the MWA wiki
-    long long NUMSAMPLES = getNSamples(metadata);
-    //This needs to be moved to a diff function as for each file it could be a different number
-    long long NUMTILES = getNInputs(metadata) * getNPols(metadata);
-    //This is how large the delay meta data block is inside of the file is is dependent on how many tiles are in the observation
-    long long DELAYDATALENGTH = NUMTILES*NUMSAMPLES*2;
-
-    //error checking to make sure the file is of the right size this is to validate that all the infomation inside atleast of the correct
-     
-     if(validateInputData(fileName, expectedNInputs) != true){
-         throw ReadInputDataException("Data file faild validation");
-     }
-    //Opening the first data filestream this changes each interation of the loop to pass thru all files
-    std::ifstream datafile(fileName, std::ios::binary);   
-    // main error handling statement
-    if(datafile.is_open()){
-        //this gets changed depending on what antean we want to read the data from
-        //per antena per polarisation there is a 64000 bytes of data
-        //long long antoffset = antenaInput+1;         
-        std::streamoff offset = NUMSAMPLES*antenaInput*2;              
-        //reading the data into the vector
-        //known size of data file enteries as per file specification pre allocation to save time later
-        datavalues.reserve(NUMSAMPLES*160);        
-        //alot of this is dependent on the meta data file reader numbers are subject to change once i figure out what to do
-        //seeking to the start of the data portion of the file 
-        //this will be antena 0 polarisation x and y sample 1 of 64000
-        std::vector<std::int8_t> datablock;
-        datablock.resize(NUMSAMPLES*2);
-        for(int i = 1; i <= 160;i++){
-            datafile.seekg(DELAYDATALENGTH*i+offset+metadatasize, std::ios::beg);
-                datafile.read(reinterpret_cast<char*>(&datablock[0]),sizeof(std::int8_t)*NUMSAMPLES*2);
-                if(datafile.fail()){
-                    throw ReadInputDataException("Failed to read data byte from file");
-                }
-                for(long j = 0; j<datablock.size();){
-                    float real = static_cast<float>(datablock.at(j));
-                    j++;
-                    float imag = static_cast<float>(datablock.at(j));
-                    j++;
-                   datavalues.push_back({real,imag}); 
-                }
-            }  
+std::vector<std::complex<float>> readInputDataFile(std::string fileName,int antenaInput, unsigned int expectedNInputs){
+    if(antenaInput < 0){
+        throw ReadInputDataException("Antenna input must not be negative");
     }
-    else{
-        //if file was unable to be opened an exception will be thrown
-        throw ReadInputDataException("Failed to open the file");
+    AntennaInputRange const range{static_cast<unsigned int>(antenaInput), static_cast<unsigned int>(antenaInput)};
+    return std::move(readInputDataFile(fileName, range, expectedNInputs).front());
+}
+
+//reads a contiguous range of antenna inputs at once. inside each of the 160 data blocks the inputs are stored one after
+//another so the whole range is one contiguous run of bytes per block, this means the file is walked from start to end
+//exactly once no matter how many inputs are asked for. the file is memory mapped so the samples are converted straight
+//out of the page cache without being copied into a stream buffer first
+std::vector<std::vector<std::complex<float>>> readInputDataFile(std::string fileName, AntennaInputRange antennaInputs,
+                                                                unsigned int expectedNInputs){
+    //validates the file size and meta data when it is mapped
+    SubfileView const view(fileName, expectedNInputs);
+    if(antennaInputs.begin > antennaInputs.end || antennaInputs.end >= view.getNumAntennaInputs()){
+        throw ReadInputDataException("Antenna input range is outside of the data file");
+    }
+    std::size_t const numInputs = antennaInputs.end - antennaInputs.begin + 1;
+    std::size_t const inputSize = static_cast<std::size_t>(view.getNumSamples()) * 2;
+
+    //known size of data file enteries as per file specification, sized up front so each block can be converted
+    //straight into place
+    std::vector<std::vector<std::complex<float>>> datavalues(numInputs);
+    for(auto& inputValues : datavalues){
+        inputValues.resize(static_cast<std::size_t>(view.getNumSamples()) * view.getNumBlocks());
+    }
+
+    view.adviseWillNeed(0, antennaInputs);
+    for(unsigned block = 0; block < view.getNumBlocks(); block++){
+        //get the os reading the next block in while this one is converted
+        if(block + 1 < view.getNumBlocks()){
+            view.adviseWillNeed(block + 1, antennaInputs);
+        }
+        auto const samples = view.getSamples(block, antennaInputs);
+        //scatter the block out to the vector of the input it belongs to, converting with the fastest simd the cpu has
+        for(std::size_t input = 0; input < numInputs; input++){
+            convertSamples(samples.data() + input*inputSize, view.getNumSamples(),
+                           datavalues[input].data() + static_cast<std::size_t>(block) * view.getNumSamples());
+        }
+        //this block wont be looked at again
+        view.adviseDontNeed(block, antennaInputs);
     }
     return datavalues;
 }
 
 
-//function used to validate if the data file is the correct size and thus allowing the program to know if there is anything missing.
-//The file size this program will be given is a constant as such its easy to validate if the file is correct or not
-//break
-bool validateInputData(std::string fileName, unsigned int expectedNInputs){
-    //MWA documentation states this is the standered file size for a 128 tile dual polarisation file
-    //4096+161*32768000
-    //meta data 160 volatage data blocks + the single delay block before the data * the size of the delay block what is 
-    //Number of tiles *2 polarisations * 128000 bytes 64000 1 byte samples for each real and imag part
-    std::string metadata = getMetaDataString(fileName);    
-    //2 bytes per sample
-    long samplebytesize = getNSamples(metadata)*2;
-    long delaydata = getNInputs(metadata) * getNPols(metadata) * samplebytesize;
-    long actualNInputs = getNInputs(metadata) * getNPols(metadata);
-    if(actualNInputs != expectedNInputs){
-        return false;
+//reads a range of antenna inputs the same way as readInputDataFile() but just copies the raw bytes out of each block
+std::vector<std::vector<std::int8_t>> readRawInputDataFile(std::string fileName, AntennaInputRange antennaInputs,
+                                                          unsigned int expectedNInputs){
+    SubfileView const view(fileName, expectedNInputs);
+    if(antennaInputs.begin > antennaInputs.end || antennaInputs.end >= view.getNumAntennaInputs()){
+        throw ReadInputDataException("Antenna input range is outside of the data file");
     }
-    long metadatasize = getMetaDataSize(metadata);
-    long long expectedInputSize = metadatasize + delaydata * 161;
-    if(std::filesystem::file_size(fileName) != expectedInputSize){
-        return false;
+    std::size_t const numInputs = antennaInputs.end - antennaInputs.begin + 1;
+    std::size_t const inputSize = static_cast<std::size_t>(view.getNumSamples()) * 2;
+
+    std::vector<std::vector<std::int8_t>> datavalues(numInputs);
+    for(auto& inputValues : datavalues){
+        inputValues.reserve(inputSize * view.getNumBlocks());
     }
-    else{
-        return true;
+
+    view.adviseWillNeed(0, antennaInputs);
+    for(unsigned block = 0; block < view.getNumBlocks(); block++){
+        if(block + 1 < view.getNumBlocks()){
+            view.adviseWillNeed(block + 1, antennaInputs);
+        }
+        auto const samples = view.getSamples(block, antennaInputs);
+        for(std::size_t input = 0; input < numInputs; input++){
+            std::int8_t const* inputSamples = samples.data() + input*inputSize;
+            datavalues[input].insert(datavalues[input].end(), inputSamples, inputSamples + inputSize);
+        }
+        view.adviseDontNeed(block, antennaInputs);
     }
+    return datavalues;
+}
+
+
+//function used to validate if the data file is the correct size and thus allowing the program to know if there is anything missing.
+//The file size this program will be given is a constant as such its easy to validate if the file is correct or not
+//MWA documentation states this is the standered file size for a 128 tile dual polarisation file
+//4096+161*32768000
+//meta data 160 volatage data blocks + the single delay block before the data * the size of the delay block what is 
+//Number of tiles *2 polarisations * 128000 bytes 64000 1 byte samples for each real and imag part
+//the header is only parsed and the file size only looked up the first time a file is seen, see SubfileIndex
+bool validateInputData(std::string fileName, unsigned int expectedNInputs){
+    return getSubfileIndex(fileName)->isValid(expectedNInputs);
 }
 
 std::string getMetaDataString(std::string fileName){
     std::ifstream f(fileName);   
     if (f){
-        long size = 4096;
+        long size = SUBFILE_HEADER_READ_SIZE;
         std::string str(size, ' ');
         f.read(&str[0], size); 
         return str;
@@ -1,14 +1,38 @@
 #pragma once
 
+#include "NodeAntennaInputAssigner.hpp"
+
 #include <vector>
 #include <complex>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 //take s a file name will read that file remove the data that is applicable for this run of the program and output a set containing the data
 //file name shoud be observation start time _ signal start time
 std::vector<std::complex<float>> readInputDataFile(std::string fileName,int antenaInput, unsigned int expectedNInputs);
 
+//reads every antenna input in the range out of the file in a single forward pass, so the file only has to be streamed
+//once for all of them. output has one vector per antenna input in the range, first element is antennaInputs.begin
+std::vector<std::vector<std::complex<float>>> readInputDataFile(std::string fileName, AntennaInputRange antennaInputs,
+                                                                unsigned int expectedNInputs);
+
+//same as above but keeps the samples in their raw form (interleaved 8 bit real and imaginary values) rather than
+//converting them to complex floats, which takes a quarter of the memory. output has one vector per antenna input
+std::vector<std::vector<std::int8_t>> readRawInputDataFile(std::string fileName, AntennaInputRange antennaInputs,
+                                                          unsigned int expectedNInputs);
+
 bool validateInputData(std::string fileName, unsigned int expectedNInputs);
 
+//number of bytes at the start of each file that are read as the meta data header
+constexpr long SUBFILE_HEADER_READ_SIZE = 4096;
+
+//Meta data inside each file readers, the readers take the header string from getMetaDataString
+std::string getMetaDataString(std::string fileName);
+unsigned int getMetaDataSize(std::string fileName);
+int getNInputs(std::string fileName);
+int getNPols(std::string fileName);
+int getNSamples(std::string fileName);
+
 //Exception that will be thrown by readinputdatafile
 class ReadInputDataException :public std::runtime_error {
 public:
@@ -0,0 +1,276 @@
+#include "SampleConversion.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include <immintrin.h>
+
+
+// The vectorised versions are compiled for their instruction set regardless of the compiler's target, and only called
+// if the CPU supports it. std::complex<float> is guaranteed to have the same layout as float[2], so the output can be
+// written as a plain float array.
+// Real and imaginary parts are multiplied by realFactor and imagFactor respectively, which is exact for the usual
+// factors of 1 and 2 (and their negatives, for conjugation).
+
+static void convertSamplesScalar(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                                 std::size_t outputStride, float realFactor, float imagFactor) {
+    for (std::size_t i = 0; i < numSamples; ++i) {
+        output[i * outputStride] = {static_cast<float>(input[2 * i]) * realFactor,
+                                    static_cast<float>(input[2 * i + 1]) * imagFactor};
+    }
+}
+
+// Widens 8 bytes (4 samples) to floats and multiplies them by the factors.
+__attribute__((target("avx2")))
+static inline __m256 widenAVX2(__m128i bytes, __m256 factors) {
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(bytes)), factors);
+}
+
+__attribute__((target("avx2")))
+static void convertSamplesAVX2(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                               std::size_t outputStride, float realFactor, float imagFactor) {
+    __m256 const factors = _mm256_setr_ps(realFactor, imagFactor, realFactor, imagFactor,
+                                          realFactor, imagFactor, realFactor, imagFactor);
+    std::size_t i = 0;
+    if (outputStride == 1) {
+        auto const outputFloats = reinterpret_cast<float*>(output);
+        // 16 samples (32 bytes) per iteration, widened 8 bytes at a time.
+        for (; i + 16 <= numSamples; i += 16) {
+            __m256i const bytes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(input + 2 * i));
+            __m128i const low = _mm256_castsi256_si128(bytes);
+            __m128i const high = _mm256_extracti128_si256(bytes, 1);
+            float* const out = outputFloats + 2 * i;
+            _mm256_storeu_ps(out, widenAVX2(low, factors));
+            _mm256_storeu_ps(out + 8, widenAVX2(_mm_srli_si128(low, 8), factors));
+            _mm256_storeu_ps(out + 16, widenAVX2(high, factors));
+            _mm256_storeu_ps(out + 24, widenAVX2(_mm_srli_si128(high, 8), factors));
+        }
+        for (; i + 4 <= numSamples; i += 4) {
+            __m128i const bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(input + 2 * i));
+            _mm256_storeu_ps(outputFloats + 2 * i, widenAVX2(bytes, factors));
+        }
+    }
+    else {
+        // 4 samples per iteration, each stored separately as a pair of floats.
+        for (; i + 4 <= numSamples; i += 4) {
+            __m128i const bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(input + 2 * i));
+            __m256 const samples = widenAVX2(bytes, factors);
+            __m128 const low = _mm256_castps256_ps128(samples);
+            __m128 const high = _mm256_extractf128_ps(samples, 1);
+            _mm_storel_pi(reinterpret_cast<__m64*>(output + i * outputStride), low);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(output + (i + 1) * outputStride), low);
+            _mm_storel_pi(reinterpret_cast<__m64*>(output + (i + 2) * outputStride), high);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(output + (i + 3) * outputStride), high);
+        }
+    }
+    convertSamplesScalar(input + 2 * i, numSamples - i, output + i * outputStride, outputStride,
+                         realFactor, imagFactor);
+}
+
+// GCC 12's AVX-512 intrinsics (which start from _mm512_undefined_*()) trigger spurious -Wmaybe-uninitialized
+// warnings once inlined (GCC bug 105593).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// Widens 16 bytes (8 samples) to floats and multiplies them by the factors.
+__attribute__((target("avx512f")))
+static inline __m512 widenAVX512(__m128i bytes, __m512 factors) {
+    return _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(bytes)), factors);
+}
+
+__attribute__((target("avx512f")))
+static void convertSamplesAVX512(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                                 std::size_t outputStride, float realFactor, float imagFactor) {
+    __m512 const factors = _mm512_setr_ps(realFactor, imagFactor, realFactor, imagFactor,
+                                          realFactor, imagFactor, realFactor, imagFactor,
+                                          realFactor, imagFactor, realFactor, imagFactor,
+                                          realFactor, imagFactor, realFactor, imagFactor);
+    std::size_t i = 0;
+    if (outputStride == 1) {
+        auto const outputFloats = reinterpret_cast<float*>(output);
+        // 32 samples (64 bytes) per iteration, widened 16 bytes at a time.
+        for (; i + 32 <= numSamples; i += 32) {
+            auto const in = reinterpret_cast<__m128i const*>(input + 2 * i);
+            float* const out = outputFloats + 2 * i;
+            for (unsigned j = 0; j < 4; ++j) {
+                __m128i const bytes = _mm_loadu_si128(in + j);
+                _mm512_storeu_ps(out + 16 * j, widenAVX512(bytes, factors));
+            }
+        }
+        for (; i + 8 <= numSamples; i += 8) {
+            __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + 2 * i));
+            _mm512_storeu_ps(outputFloats + 2 * i, widenAVX512(bytes, factors));
+        }
+    }
+    else {
+        // 8 samples per iteration, scattered as 64-bit (float pair) elements.
+        auto const stride = static_cast<long long>(outputStride);
+        __m512i const indices = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride,
+                                                 3 * stride, 2 * stride, stride, 0);
+        for (; i + 8 <= numSamples; i += 8) {
+            __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + 2 * i));
+            __m512 const samples = widenAVX512(bytes, factors);
+            _mm512_i64scatter_pd(output + i * outputStride, indices, _mm512_castps_pd(samples), 8);
+        }
+    }
+    convertSamplesScalar(input + 2 * i, numSamples - i, output + i * outputStride, outputStride,
+                         realFactor, imagFactor);
+}
+
+#pragma GCC diagnostic pop
+
+static void dispatchConvertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                                   std::size_t outputStride, float scale, bool conjugate, SampleConversionISA isa) {
+    float const imagFactor = conjugate ? -scale : scale;
+    switch (isa) {
+        case SampleConversionISA::AVX512:
+            convertSamplesAVX512(input, numSamples, output, outputStride, scale, imagFactor);
+            break;
+        case SampleConversionISA::AVX2:
+            convertSamplesAVX2(input, numSamples, output, outputStride, scale, imagFactor);
+            break;
+        default:
+            convertSamplesScalar(input, numSamples, output, outputStride, scale, imagFactor);
+            break;
+    }
+}
+
+// Conversion to 16-bit integers clamps in floating point first, so the truncating float to 32-bit integer conversion
+// can't overflow, and the values narrowed to 16 bits are already in range.
+constexpr float INT16_MAX_FLOAT = std::numeric_limits<std::int16_t>::max();
+constexpr float INT16_MIN_FLOAT = std::numeric_limits<std::int16_t>::min();
+
+static void convertToInt16Scalar(float const* input, std::size_t numSamples, std::int16_t* output) {
+    for (std::size_t i = 0; i < numSamples; ++i) {
+        float const sample = input[i];
+        if (sample > INT16_MAX_FLOAT) {
+            output[i] = std::numeric_limits<std::int16_t>::max();
+        }
+        else if (sample < INT16_MIN_FLOAT) {
+            output[i] = std::numeric_limits<std::int16_t>::min();
+        }
+        else {
+            output[i] = static_cast<std::int16_t>(sample);
+        }
+    }
+}
+
+// Clamps 8 floats to the 16-bit range and truncates them to 32-bit integers.
+__attribute__((target("avx2")))
+static inline __m256i clampAVX2(float const* input) {
+    __m256 const clamped = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input), _mm256_set1_ps(INT16_MIN_FLOAT)),
+                                         _mm256_set1_ps(INT16_MAX_FLOAT));
+    return _mm256_cvttps_epi32(clamped);
+}
+
+__attribute__((target("avx2")))
+static void convertToInt16AVX2(float const* input, std::size_t numSamples, std::int16_t* output) {
+    std::size_t i = 0;
+    // 16 samples per iteration. Packing works within each 128-bit lane, so the 64-bit quarters are put back in order
+    // afterwards.
+    for (; i + 16 <= numSamples; i += 16) {
+        __m256i const packed = _mm256_packs_epi32(clampAVX2(input + i), clampAVX2(input + i + 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    convertToInt16Scalar(input + i, numSamples - i, output + i);
+}
+
+// See widenAVX512().
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+__attribute__((target("avx512f")))
+static void convertToInt16AVX512(float const* input, std::size_t numSamples, std::int16_t* output) {
+    __m512 const minimum = _mm512_set1_ps(INT16_MIN_FLOAT);
+    __m512 const maximum = _mm512_set1_ps(INT16_MAX_FLOAT);
+    std::size_t i = 0;
+    // 16 samples per iteration.
+    for (; i + 16 <= numSamples; i += 16) {
+        __m512 const clamped = _mm512_min_ps(_mm512_max_ps(_mm512_loadu_ps(input + i), minimum), maximum);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i),
+                            _mm512_cvtsepi32_epi16(_mm512_cvttps_epi32(clamped)));
+    }
+    convertToInt16Scalar(input + i, numSamples - i, output + i);
+}
+#pragma GCC diagnostic pop
+
+static void dispatchConvertToInt16(float const* input, std::size_t numSamples, std::int16_t* output,
+                                   SampleConversionISA isa) {
+    switch (isa) {
+        case SampleConversionISA::AVX512:
+            convertToInt16AVX512(input, numSamples, output);
+            break;
+        case SampleConversionISA::AVX2:
+            convertToInt16AVX2(input, numSamples, output);
+            break;
+        default:
+            convertToInt16Scalar(input, numSamples, output);
+            break;
+    }
+}
+
+
+SampleConversionISA getSampleConversionISA() {
+    static SampleConversionISA const isa = []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX512)) {
+            return SampleConversionISA::AVX512;
+        }
+        else if (isSampleConversionISASupported(SampleConversionISA::AVX2)) {
+            return SampleConversionISA::AVX2;
+        }
+        else {
+            return SampleConversionISA::SCALAR;
+        }
+    }();
+    return isa;
+}
+
+bool isSampleConversionISASupported(SampleConversionISA isa) {
+    __builtin_cpu_init();
+    switch (isa) {
+        case SampleConversionISA::SCALAR:
+            return true;
+        case SampleConversionISA::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SampleConversionISA::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return false;
+    }
+}
+
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride) {
+    dispatchConvertSamples(input, numSamples, output, outputStride, 1.0f, false, getSampleConversionISA());
+}
+
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride, SampleConversionISA isa) {
+    convertSamples(input, numSamples, output, outputStride, 1.0f, false, isa);
+}
+
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride, float scale, bool conjugate) {
+    dispatchConvertSamples(input, numSamples, output, outputStride, scale, conjugate, getSampleConversionISA());
+}
+
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride, float scale, bool conjugate, SampleConversionISA isa) {
+    if (!isSampleConversionISASupported(isa)) {
+        throw std::invalid_argument{"Sample conversion instruction set isn't supported by this CPU"};
+    }
+    dispatchConvertSamples(input, numSamples, output, outputStride, scale, conjugate, isa);
+}
+
+void convertToInt16(float const* input, std::size_t numSamples, std::int16_t* output) {
+    dispatchConvertToInt16(input, numSamples, output, getSampleConversionISA());
+}
+
+void convertToInt16(float const* input, std::size_t numSamples, std::int16_t* output, SampleConversionISA isa) {
+    if (!isSampleConversionISASupported(isa)) {
+        throw std::invalid_argument{"Sample conversion instruction set isn't supported by this CPU"};
+    }
+    dispatchConvertToInt16(input, numSamples, output, isa);
+}
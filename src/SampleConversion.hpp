@@ -0,0 +1,49 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+
+// Instruction set used to convert raw signal samples.
+enum class SampleConversionISA {
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+
+// Gets the fastest instruction set supported by the CPU, which is what convertSamples() uses by default.
+SampleConversionISA getSampleConversionISA();
+
+// Checks if the CPU supports an instruction set.
+bool isSampleConversionISASupported(SampleConversionISA isa);
+
+// Converts raw signal samples (interleaved pairs of 8-bit signed integers, real then imaginary) to complex floats.
+// numSamples is the number of complex samples. Sample i is written to output[i * outputStride], which must already be
+// allocated; the elements in between are not touched.
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride = 1);
+
+// As above, but with a specific instruction set rather than the fastest one (mainly for testing).
+// Throws std::invalid_argument if the CPU doesn't support the instruction set.
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride, SampleConversionISA isa);
+
+// Converts raw signal samples as above, also multiplying each sample by scale and conjugating it if requested, so that
+// output[i * outputStride] is scale * sample i, or scale * conj(sample i).
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride, float scale, bool conjugate);
+
+// As above, but with a specific instruction set rather than the fastest one (mainly for testing).
+// Throws std::invalid_argument if the CPU doesn't support the instruction set.
+void convertSamples(std::int8_t const* input, std::size_t numSamples, std::complex<float>* output,
+                    std::size_t outputStride, float scale, bool conjugate, SampleConversionISA isa);
+
+// Converts processed signal samples to 16-bit signed integers. Samples outside the range of std::int16_t are clamped
+// to it, and the rest are rounded towards zero.
+void convertToInt16(float const* input, std::size_t numSamples, std::int16_t* output);
+
+// As above, but with a specific instruction set rather than the fastest one (mainly for testing).
+// Throws std::invalid_argument if the CPU doesn't support the instruction set.
+void convertToInt16(float const* input, std::size_t numSamples, std::int16_t* output, SampleConversionISA isa);
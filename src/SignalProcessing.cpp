@@ -1,9 +1,14 @@
-#include<limits>
+#include<algorithm>
+#include<numeric>
+#include<optional>
 #include<mkl.h>
 #include<tbb/tbb.h>
 #include"SignalProcessing.hpp"
+#include"AntennaInputSamples.hpp"
 #include"ChannelRemapping.hpp"
 #include"Common.hpp"
+#include"SampleConversion.hpp"
+#include"StageTiming.hpp"
 #include<iostream>
 // Assert that these are indeed the same type at compile type due to the unsafe reinterpret_cast 's used in these functions
 // Both of these types should be a struct containing two floats
@@ -26,8 +31,19 @@ void remapChannels(std::vector<std::vector<std::complex<float>>> const& signalDa
                    std::map<unsigned, ChannelRemapping::RemappedChannel> const& channelRemapping,
                    unsigned const outNumChannels);
 
+// Same as above but converts the raw samples as it goes, straight into their remapped position. Conjugation and the
+// edge channel scaling are applied as the samples are converted, so the output is only written once.
+void remapChannels(AntennaInputSamples const& signalDataIn,
+                   std::vector<unsigned> const& signalDataInMapping,
+                   std::vector<std::complex<float>>& signalDataOut,
+                   std::map<unsigned, ChannelRemapping::RemappedChannel> const& channelRemapping,
+                   unsigned const outNumChannels);
+
 static const unsigned PFB_COE_CHANNELS = MWA_NUM_CHANNELS;
 static const unsigned MWA_SAMPLING_RATE = SAMPLING_RATE;
+// Size of the time domain output of each tile of blocks the inverse DFT is done in, small enough to stay in the L2
+// cache until it is converted to 16 bit integers
+static const std::size_t DFT_TILE_BYTES = 256 * 1024;
 
 // Performs an inverse polyphase filter bank (PFB) on the signal data, the mapping is required
 // for this function so the convolution only goes over the appropriate channels. This mapping
@@ -38,6 +54,15 @@ void performPFB(std::vector<std::complex<float>>& signalData,
                        unsigned const numOfBlocks,
                        unsigned const numOfChannels);
 
+// Same as above, using a specific PFB engine rather than the fastest one for the coefficients.
+// Throws std::invalid_argument if the channelFIR engine is used with complex coefficients.
+void performPFB(std::vector<std::complex<float>>& signalData,
+                std::vector<std::complex<float>> const& coefficantPFB,
+                std::map<unsigned, ChannelRemapping::RemappedChannel> const& mapping,
+                unsigned const numOfBlocks,
+                unsigned const numOfChannels,
+                PFBEngine const engine);
+
 // Performs an inverse discrete fourier transorm on the signal data, changing the frequency
 void performDFT(std::vector<std::complex<float>>& signalData,
                 std::vector<float>& outData,
@@ -103,6 +128,556 @@ static inline void handleVSLError(int const status) {
     }
 }
 
+// MKL handles owned by a ProcessingPlan. Each is freed when the plan is destroyed, including if planning fails part way.
+struct ProcessingPlan::MKLTasks {
+    VSLConvTaskPtr convolution = nullptr;
+
+    ~MKLTasks() {
+        if (convolution != nullptr) {
+            vslConvDeleteTask(&convolution);
+        }
+    }
+};
+
+// Everything a ProcessingPlan needs to process a batch of a given number of input signals. The signals are interleaved
+// a block at a time, so each block of the batch holds that block of every signal.
+struct ProcessingPlan::BatchTasks {
+    // Number of blocks in each tile the inverse DFT is done in, fewer for more signals so a tile stays the same size
+    unsigned tileBlocks = 0;
+    // DFT descriptors for a full tile of blocks, and for the shorter last tile (if there is one), of every signal
+    DFTI_DESCRIPTOR_HANDLE tileDFT = nullptr;
+    DFTI_DESCRIPTOR_HANDLE lastTileDFT = nullptr;
+    // Only used by the channelFIR engine, with the channels of every signal
+    std::optional<ChannelFIRFilter> firFilter;
+    // Only used by the overlapSave engine, with the channels of every signal
+    std::optional<OverlapSaveFilter> overlapSaveFilter;
+
+    ~BatchTasks() {
+        if (tileDFT != nullptr) {
+            DftiFreeDescriptor(&tileDFT);
+        }
+        if (lastTileDFT != nullptr) {
+            DftiFreeDescriptor(&lastTileDFT);
+        }
+    }
+};
+
+CoefficientSpan::CoefficientSpan(std::complex<float> const* data, std::size_t size) :
+    _data{data}, _size{size}
+{}
+
+CoefficientSpan::CoefficientSpan(std::vector<std::complex<float>> const& coefficients) :
+    CoefficientSpan{coefficients.data(), coefficients.size()}
+{}
+
+std::complex<float> const* CoefficientSpan::data() const {
+    return _data;
+}
+
+std::size_t CoefficientSpan::size() const {
+    return _size;
+}
+
+std::complex<float> const* CoefficientSpan::begin() const {
+    return _data;
+}
+
+std::complex<float> const* CoefficientSpan::end() const {
+    return _data + _size;
+}
+
+std::complex<float> const& CoefficientSpan::operator[](std::size_t index) const {
+    return _data[index];
+}
+
+// Checks the arguments a ProcessingPlan is built from are consistent, for input signals with inNumBlocks samples per
+// channel
+static void validatePlanArguments(std::size_t const inNumBlocks,
+                                  CoefficientSpan const coefficiantPFB,
+                                  ChannelRemapping const& remappingData) {
+    if ( remappingData.channelMap.empty() ) {
+        throw std::invalid_argument("ChannelRemapping cannot be empty ");
+    }
+
+    if ( inNumBlocks % 2 != 0 && inNumBlocks != 1 ) {
+        throw std::invalid_argument("Number of samples in the input data is not a multiple of 2 or size of 1");
+    }
+
+    if ( coefficiantPFB.size() == 0 ) {
+        throw std::invalid_argument("PFB coefficiant array cannot be empty");
+    }
+
+    if ( coefficiantPFB.size() % PFB_COE_CHANNELS != 0 ) {
+        throw std::invalid_argument("PFB coefficant data is not a multiple of number of PFB channels "
+                + std::to_string(PFB_COE_CHANNELS));
+    }
+
+    if ( (coefficiantPFB.size() / PFB_COE_CHANNELS) > inNumBlocks ) {
+        throw std::invalid_argument("The PFB Array must contain the same number or less blocks as the signal data");
+    }
+}
+
+// Checks an input signal with numInChannels channels of inNumBlocks samples each can be processed with the plan
+static void validateSignalArguments(std::size_t const numInChannels,
+                                    std::size_t const inNumBlocks,
+                                    std::vector<unsigned> const& signalDataInMapping,
+                                    ProcessingPlan const& plan) {
+    if ( plan.getChannels().size() != signalDataInMapping.size() ) {
+        throw std::invalid_argument("Different number of remapped channels and input channels");
+    }
+
+    if ( signalDataInMapping.size() != numInChannels ) {
+        throw std::invalid_argument("Number of channels present in input signal do not equal number of channels in mapping");
+    }
+
+    if ( inNumBlocks != plan.getNumBlocks() ) {
+        throw std::invalid_argument("Number of samples in the input data does not match the processing plan");
+    }
+}
+
+// Flattens the channel map into a list of channels, in order of the original channel
+static std::vector<ProcessingPlan::Channel> flattenChannelMap(
+        std::map<unsigned, ChannelRemapping::RemappedChannel> const& channelRemapping,
+        unsigned const nyquistChannel) {
+    std::vector<ProcessingPlan::Channel> channels;
+    channels.reserve(channelRemapping.size());
+    for (auto const& [oldChannel, remappedChannel] : channelRemapping) {
+        // Scale by two for these edge cases
+        bool const scaled = (remappedChannel.newChannel == nyquistChannel - 1) || // If nyquist frequency
+                            (remappedChannel.newChannel == 0 && oldChannel != 0); // If something was remapped to zero
+        channels.push_back({oldChannel, remappedChannel.newChannel, remappedChannel.flipped, scaled ? 2.0f : 1.0f});
+    }
+    return channels;
+}
+
+// Gets the index into channels of each original channel, -1 for channels which aren't remapped
+static std::vector<int> indexChannels(std::vector<ProcessingPlan::Channel> const& channels) {
+    std::vector<int> channelIndex;
+    for (std::size_t i = 0; i < channels.size(); ++i) {
+        if (channels[i].oldChannel >= channelIndex.size()) {
+            channelIndex.resize(channels[i].oldChannel + 1, -1);
+        }
+        channelIndex[channels[i].oldChannel] = static_cast<int>(i);
+    }
+    return channelIndex;
+}
+
+// Looks up the remapping of an original channel
+static ProcessingPlan::Channel const& findChannel(std::vector<ProcessingPlan::Channel> const& channels,
+                                                  std::vector<int> const& channelIndex,
+                                                  unsigned const oldChannel,
+                                                  unsigned const nyquistChannel) {
+    if (oldChannel >= channelIndex.size() || channelIndex[oldChannel] < 0) {
+        throw std::invalid_argument("Signal mapping and Channel mapping do not match");
+    }
+    auto const& channel = channels[channelIndex[oldChannel]];
+    if (channel.newChannel > nyquistChannel) {
+        throw std::invalid_argument("Channel mapping values greater than the nyquist channel");
+    }
+    return channel;
+}
+
+// Remaps the channels into signalDataOut, which has nyquistChannel channels of NUM_OF_BLOCKS samples, with blockStride
+// samples from the start of one block to the next.
+// Only the remapped channels are written, the others are left as they are.
+static void remapChannels(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
+                          std::vector<unsigned> const& signalDataInMapping,
+                          std::complex<float>* const signalDataOut,
+                          std::vector<ProcessingPlan::Channel> const& channels,
+                          std::vector<int> const& channelIndex,
+                          unsigned const nyquistChannel,
+                          std::size_t const blockStride) {
+    unsigned const NUM_OF_BLOCKS = signalDataIn.at(0).size();
+
+    // Work over each element of the mapping
+    for (unsigned unmappedChannel = 0; unmappedChannel < signalDataInMapping.size(); ++unmappedChannel) {
+        auto const& channel = findChannel(channels, channelIndex, signalDataInMapping.at(unmappedChannel),
+                                          nyquistChannel);
+
+        // Grab the correct channel vector based on the mapping
+        std::vector<std::complex<float>> const& channelVector = signalDataIn.at(unmappedChannel);
+
+        if (channel.flipped) {
+            // Do a strided conjugated copy over it
+            vcConjI(NUM_OF_BLOCKS,
+                    reinterpret_cast<const MKL_Complex8*>(channelVector.data()), 1,
+                    reinterpret_cast<MKL_Complex8*>(signalDataOut + channel.newChannel), blockStride);
+        }
+        else {
+            // Do a strided copy over it
+            cblas_ccopy(NUM_OF_BLOCKS,
+                        channelVector.data(), 1,
+                        signalDataOut + channel.newChannel, blockStride);
+        }
+
+        if (channel.scale != 1.0f) {
+            cblas_csscal(NUM_OF_BLOCKS, channel.scale, signalDataOut + channel.newChannel, blockStride);
+        }
+    }
+}
+
+// Same as above but converts the raw samples as it goes, straight into their remapped position
+static void remapChannels(AntennaInputSamples const& signalDataIn,
+                          std::vector<unsigned> const& signalDataInMapping,
+                          std::complex<float>* const signalDataOut,
+                          std::vector<ProcessingPlan::Channel> const& channels,
+                          std::vector<int> const& channelIndex,
+                          unsigned const nyquistChannel,
+                          std::size_t const blockStride) {
+    std::size_t const NUM_OF_BLOCKS = signalDataIn.getNumSamples();
+
+    // Work over each element of the mapping
+    for (unsigned unmappedChannel = 0; unmappedChannel < signalDataInMapping.size(); ++unmappedChannel) {
+        auto const& channel = findChannel(channels, channelIndex, signalDataInMapping.at(unmappedChannel),
+                                          nyquistChannel);
+
+        // Do a strided (and possibly conjugated and scaled) conversion straight into the remapped channel
+        signalDataIn.convert(unmappedChannel, 0, NUM_OF_BLOCKS, signalDataOut + channel.newChannel, blockStride,
+                             channel.scale, channel.flipped);
+    }
+}
+
+// Creates the convolution task used by the PFB
+static void createConvolutionTask(VSLConvTaskPtr& convolutionTask,
+                                  unsigned const numOfBlocks,
+                                  unsigned const coefficantBlockSize) {
+    handleVSLError(vslcConvNewTask1D(&convolutionTask,
+                      VSL_CORR_MODE_AUTO,
+                      numOfBlocks,
+                      coefficantBlockSize,
+                      (numOfBlocks + coefficantBlockSize) - 1));
+}
+
+// Performs the PFB over the remapped channels with a convolution task from createConvolutionTask().
+// convolutionResult must hold (numOfBlocks + coefficantBlockSize) - 1 samples.
+static void executePFB(VSLConvTaskPtr const convolutionTask,
+                       std::complex<float>* const signalData,
+                       CoefficientSpan const coefficantPFB,
+                       std::vector<ProcessingPlan::Channel> const& channels,
+                       unsigned const numOfBlocks,
+                       unsigned const numOfChannels,
+                       std::complex<float>* const convolutionResult) {
+    unsigned const coefficantBlockSize = coefficantPFB.size() / PFB_COE_CHANNELS;
+
+    // Only work over the channels that actually have something in them
+    for (auto const& channel : channels) {
+        // NOTE: Stride over coefficantPFB data is using the original channel data as it didn't get remapped
+        handleVSLError(vslcConvExec1D(convolutionTask,
+                       reinterpret_cast<const MKL_Complex8*>(signalData + channel.newChannel), numOfChannels,
+                       reinterpret_cast<const MKL_Complex8*>(coefficantPFB.data() + channel.oldChannel), PFB_COE_CHANNELS,
+                       reinterpret_cast<MKL_Complex8*>(convolutionResult), 1));
+
+        // Copy the middle part of the convolution back to the orginal array
+        cblas_ccopy(numOfBlocks,
+                    convolutionResult + coefficantBlockSize/2, 1,
+                    signalData + channel.newChannel, numOfChannels);
+    }
+}
+
+// Gathers the PFB coefficients of each remapped channel into filter taps, laid out [tap][new channel].
+// Channels which aren't remapped get an identity filter so they are left as they are, like the convolution engine.
+static std::vector<std::complex<float>> makeChannelTaps(CoefficientSpan const coefficantPFB,
+                                                        std::vector<ProcessingPlan::Channel> const& channels,
+                                                        unsigned const numOfChannels) {
+    unsigned const coefficantBlockSize = coefficantPFB.size() / PFB_COE_CHANNELS;
+    std::vector<std::complex<float>> taps(static_cast<std::size_t>(coefficantBlockSize) * numOfChannels);
+    for (unsigned channel = 0; channel < numOfChannels; ++channel) {
+        taps[(coefficantBlockSize / 2) * numOfChannels + channel] = 1.0f;
+    }
+    for (auto const& channel : channels) {
+        for (unsigned tap = 0; tap < coefficantBlockSize; ++tap) {
+            taps[tap * numOfChannels + channel.newChannel] = coefficantPFB[tap * PFB_COE_CHANNELS + channel.oldChannel];
+        }
+    }
+    return taps;
+}
+
+// Gets the real parts of taps from makeChannelTaps() for ChannelFIRFilter.
+// Returns an empty optional if any of the taps are complex.
+static std::optional<std::vector<float>> getRealTaps(std::vector<std::complex<float>> const& taps) {
+    std::vector<float> realTaps;
+    realTaps.reserve(taps.size());
+    for (auto const tap : taps) {
+        if (tap.imag() != 0.0f) {
+            return std::nullopt;
+        }
+        realTaps.push_back(tap.real());
+    }
+    return realTaps;
+}
+
+// Repeats the filter taps from makeChannelTaps() for each of numInputs interleaved input signals, laid out
+// [tap][input][channel]
+template<typename Tap>
+static std::vector<Tap> repeatTaps(std::vector<Tap> const& taps, unsigned const numOfChannels,
+                                   std::size_t const numInputs) {
+    std::vector<Tap> repeatedTaps;
+    repeatedTaps.reserve(taps.size() * numInputs);
+    for (auto tap = taps.begin(); tap != taps.end(); tap += numOfChannels) {
+        for (std::size_t input = 0; input < numInputs; ++input) {
+            repeatedTaps.insert(repeatedTaps.end(), tap, tap + numOfChannels);
+        }
+    }
+    return repeatedTaps;
+}
+
+PFBEngine choosePFBEngine(unsigned const numTaps, unsigned const numBlocks, bool const realCoefficients,
+                          bool const overlapSave) {
+    if (overlapSave && numBlocks >= chooseOverlapSaveSegmentLength(numTaps)) {
+        return PFBEngine::overlapSave;
+    }
+    return realCoefficients ? PFBEngine::channelFIR : PFBEngine::convolution;
+}
+
+// Creates and commits the DFT descriptor used to go from the remapped channels to the time domain.
+// threadLimit limits the threads MKL uses for each transform, 0 for no limit.
+static void createDFTDescriptor(DFTI_DESCRIPTOR_HANDLE& hand,
+                                unsigned const samplingFreq,
+                                unsigned const numOfBlocks,
+                                unsigned const numOfChannels,
+                                unsigned const threadLimit = 0) {
+    handleMKLError(DftiCreateDescriptor(&hand, DFTI_SINGLE, DFTI_REAL, 1, samplingFreq));
+    if ( threadLimit > 0 ) {
+        handleMKLError(DftiSetValue(hand, DFTI_THREAD_LIMIT, static_cast<MKL_LONG>(threadLimit)));
+    }
+    handleMKLError(DftiSetValue(hand, DFTI_PACKED_FORMAT, DFTI_CCE_FORMAT));
+    handleMKLError(DftiSetValue(hand, DFTI_PLACEMENT, DFTI_NOT_INPLACE));
+    handleMKLError(DftiSetValue(hand, DFTI_CONJUGATE_EVEN_STORAGE,  DFTI_COMPLEX_COMPLEX));
+    handleMKLError(DftiSetValue(hand, DFTI_NUMBER_OF_TRANSFORMS, static_cast<MKL_LONG>(numOfBlocks)));
+    handleMKLError(DftiSetValue(hand, DFTI_INPUT_DISTANCE, numOfChannels));
+    handleMKLError(DftiSetValue(hand, DFTI_OUTPUT_DISTANCE, samplingFreq));
+    handleMKLError(DftiCommitDescriptor(hand));
+}
+
+// Chooses the number of blocks in each tile the inverse DFT of a batch of numInputs signals is done in, so the time
+// domain signal of a tile (of every signal) is about DFT_TILE_BYTES
+static std::size_t chooseTileBlocks(unsigned const samplingFreq, unsigned const numBlocks, std::size_t const numInputs) {
+    return std::clamp<std::size_t>(DFT_TILE_BYTES / (numInputs * samplingFreq * sizeof(float)), 1,
+                                   std::max(numBlocks, 1u));
+}
+
+ProcessingPlan::ProcessingPlan(ChannelRemapping const& remappingData,
+                               CoefficientSpan const coefficiantPFB,
+                               unsigned const numBlocks,
+                               unsigned const batchSize,
+                               bool const overlapSave) :
+    _numBlocks{numBlocks},
+    _batchSize{batchSize},
+    _samplingFreq{remappingData.newSamplingFreq},
+    _nyquistChannel{(remappingData.newSamplingFreq / 2) + 1},
+    _coefficients{coefficiantPFB},
+    _coefficientBlockSize{},
+    _channels{},
+    _channelIndex{},
+    _pfbEngine{PFBEngine::convolution},
+    _mklTasks{},
+    _batchTasks{},
+    _remappedData{},
+    _convolutionResult{},
+    _timeDomain{},
+    _stageMeasurements{}
+{
+    validatePlanArguments(numBlocks, coefficiantPFB, remappingData);
+    if ( batchSize == 0 ) {
+        throw std::invalid_argument("Processing plan batch size must be positive");
+    }
+
+    _coefficientBlockSize = coefficiantPFB.size() / PFB_COE_CHANNELS;
+    _channels = flattenChannelMap(remappingData.channelMap, _nyquistChannel);
+    _channelIndex = indexChannels(_channels);
+
+    _mklTasks = std::make_unique<MKLTasks>();
+    auto const realTaps = getRealTaps(makeChannelTaps(_coefficients, _channels, _nyquistChannel));
+    _pfbEngine = choosePFBEngine(_coefficientBlockSize, _numBlocks, realTaps.has_value(), overlapSave);
+    if ( _pfbEngine == PFBEngine::convolution ) {
+        createConvolutionTask(_mklTasks->convolution, _numBlocks, _coefficientBlockSize);
+        _convolutionResult.resize((_numBlocks + _coefficientBlockSize) - 1);
+    }
+    // The tasks for a full batch are created now, others only if a smaller batch is processed
+    _batchTasks.resize(_batchSize);
+    _getBatchTasks(_batchSize);
+
+    // Each thread's tile buffer is made big enough for a tile of any batch the first time the thread uses it
+    std::size_t maxTileSize = 0;
+    for (std::size_t numInputs = 1; numInputs <= _batchSize; ++numInputs) {
+        maxTileSize = std::max(maxTileSize,
+                               chooseTileBlocks(_samplingFreq, _numBlocks, numInputs) * numInputs * _samplingFreq);
+    }
+    _timeDomain = tbb::enumerable_thread_specific<std::vector<float>>{std::vector<float>(maxTileSize)};
+
+    // Channels which aren't remapped stay zero for every signal processed with the plan. Every block of a batch has
+    // nyquistChannel channels for each signal whatever the number of signals, so that holds for any batch.
+    _remappedData.resize(static_cast<std::size_t>(_nyquistChannel) * _numBlocks * _batchSize);
+    _stageMeasurements.resize(_batchSize);
+}
+
+ProcessingPlan::~ProcessingPlan() = default;
+
+unsigned ProcessingPlan::getNumBlocks() const {
+    return _numBlocks;
+}
+
+unsigned ProcessingPlan::getBatchSize() const {
+    return _batchSize;
+}
+
+unsigned ProcessingPlan::getTileBlocks() const {
+    return _batchTasks.back()->tileBlocks;
+}
+
+unsigned ProcessingPlan::getSamplingFreq() const {
+    return _samplingFreq;
+}
+
+unsigned ProcessingPlan::getNyquistChannel() const {
+    return _nyquistChannel;
+}
+
+std::vector<ProcessingPlan::Channel> const& ProcessingPlan::getChannels() const {
+    return _channels;
+}
+
+PFBEngine ProcessingPlan::getPFBEngine() const {
+    return _pfbEngine;
+}
+
+StageMeasurements const& ProcessingPlan::getStageMeasurements(std::size_t const input) const {
+    return _stageMeasurements.at(input);
+}
+
+ProcessingPlan::BatchTasks& ProcessingPlan::_getBatchTasks(std::size_t const numInputs) {
+    auto& batchTasks = _batchTasks.at(numInputs - 1);
+    if (batchTasks != nullptr) {
+        return *batchTasks;
+    }
+
+    auto tasks = std::make_unique<BatchTasks>();
+    // The filters see the batch as one signal with the channels of every input signal, so they each get the taps
+    unsigned const numBatchChannels = static_cast<unsigned>(_nyquistChannel * numInputs);
+    switch (_pfbEngine) {
+        case PFBEngine::overlapSave:
+            tasks->overlapSaveFilter.emplace(
+                repeatTaps(makeChannelTaps(_coefficients, _channels, _nyquistChannel), _nyquistChannel, numInputs),
+                numBatchChannels);
+            break;
+        case PFBEngine::channelFIR:
+            tasks->firFilter.emplace(
+                repeatTaps(getRealTaps(makeChannelTaps(_coefficients, _channels, _nyquistChannel)).value(),
+                           _nyquistChannel, numInputs),
+                numBatchChannels);
+            break;
+        case PFBEngine::convolution:
+            break;
+    }
+    // Each tile covers the same blocks of every signal, which are next to each other, so a tile is one MKL call. The
+    // tiles are transformed in parallel, so each transform is kept to one thread.
+    tasks->tileBlocks = static_cast<unsigned>(chooseTileBlocks(_samplingFreq, _numBlocks, numInputs));
+    createDFTDescriptor(tasks->tileDFT, _samplingFreq, tasks->tileBlocks * numInputs, _nyquistChannel, 1);
+    if ( _numBlocks % tasks->tileBlocks != 0 ) {
+        createDFTDescriptor(tasks->lastTileDFT, _samplingFreq, (_numBlocks % tasks->tileBlocks) * numInputs,
+                            _nyquistChannel, 1);
+    }
+
+    batchTasks = std::move(tasks);
+    return *batchTasks;
+}
+
+template<typename Signal>
+void ProcessingPlan::_remap(Signal const& signalDataIn, std::vector<unsigned> const& signalDataInMapping,
+                            std::size_t const input, std::size_t const numInputs) {
+    std::size_t const remappedSize = static_cast<std::size_t>(_nyquistChannel) * _numBlocks;
+    _stageMeasurements.at(input) = {};
+    StageTimer const timer;
+    // Every remapped channel is overwritten, so the scratch buffer doesn't need clearing between signals
+    remapChannels(signalDataIn, signalDataInMapping, _remappedData.data() + input * _nyquistChannel, _channels,
+                  _channelIndex, _nyquistChannel, numInputs * _nyquistChannel);
+    addStageMeasurement(_stageMeasurements.at(input), ProcessingStage::remap, timer.getElapsedSeconds(),
+                        remappedSize * sizeof(std::complex<float>), remappedSize);
+}
+
+void ProcessingPlan::_processRemapped(std::size_t const numInputs, std::vector<std::int16_t>* const signalDataOut) {
+    std::size_t const remappedSize = static_cast<std::size_t>(_nyquistChannel) * _numBlocks;
+    std::size_t const timeDomainSize = static_cast<std::size_t>(_samplingFreq) * _numBlocks;
+    std::size_t const numBatchChannels = numInputs * _nyquistChannel;
+    auto& tasks = _getBatchTasks(numInputs);
+
+    // The filters run along each channel, so filtering the interleaved signals together never runs from one signal
+    // into the next. The time is split evenly between the signals.
+    StageTimer const pfbTimer;
+    switch (_pfbEngine) {
+        case PFBEngine::overlapSave:
+            tasks.overlapSaveFilter->apply(_remappedData.data(), _numBlocks);
+            break;
+        case PFBEngine::channelFIR:
+            tasks.firFilter->apply(_remappedData.data(), _numBlocks);
+            break;
+        case PFBEngine::convolution:
+            for (std::size_t input = 0; input < numInputs; ++input) {
+                executePFB(_mklTasks->convolution, _remappedData.data() + input * _nyquistChannel, _coefficients,
+                           _channels, _numBlocks, numBatchChannels, _convolutionResult.data());
+            }
+            break;
+    }
+    double const pfbSeconds = pfbTimer.getElapsedSeconds() / numInputs;
+    for (std::size_t input = 0; input < numInputs; ++input) {
+        addStageMeasurement(_stageMeasurements.at(input), ProcessingStage::pfb, pfbSeconds,
+                            remappedSize * sizeof(std::complex<float>), remappedSize);
+        signalDataOut[input].resize(timeDomainSize);
+    }
+
+    // The tiles are transformed in one parallel loop. Each tile's time domain signal is converted straight into the
+    // outputs while it is still in the cache, so the whole signal is never held as floats.
+    std::size_t const numTiles = (_numBlocks + tasks.tileBlocks - 1) / tasks.tileBlocks;
+    // Time each tile spent in the inverse DFT and the conversion, written only by the task doing the tile
+    std::vector<double> tileDFTSeconds(numTiles);
+    std::vector<double> tilePostProcessingSeconds(numTiles);
+    StageTimer const timer;
+    tbb::parallel_for(tbb::blocked_range<std::size_t>{0, numTiles},
+                      [this, signalDataOut, numInputs, numBatchChannels, &tasks, &tileDFTSeconds,
+                       &tilePostProcessingSeconds](auto const& range) {
+        auto& timeDomain = _timeDomain.local();
+        for (auto tile = range.begin(); tile != range.end(); ++tile) {
+            std::size_t const firstBlock = tile * tasks.tileBlocks;
+            std::size_t const numTileBlocks = std::min<std::size_t>(tasks.tileBlocks, _numBlocks - firstBlock);
+            auto const dft = numTileBlocks == tasks.tileBlocks ? tasks.tileDFT : tasks.lastTileDFT;
+            StageTimer const dftTimer;
+            handleMKLError(DftiComputeBackward(dft, _remappedData.data() + firstBlock * numBatchChannels,
+                                               timeDomain.data()));
+            tileDFTSeconds[tile] = dftTimer.getElapsedSeconds();
+            StageTimer const postProcessingTimer;
+            // The tile's time domain signal is laid out [block][input][sample]
+            for (std::size_t block = 0; block < numTileBlocks; ++block) {
+                for (std::size_t input = 0; input < numInputs; ++input) {
+                    convertToInt16(timeDomain.data() + (block * numInputs + input) * _samplingFreq, _samplingFreq,
+                                   signalDataOut[input].data() + (firstBlock + block) * _samplingFreq);
+                }
+            }
+            tilePostProcessingSeconds[tile] = postProcessingTimer.getElapsedSeconds();
+        }
+    });
+    double const wallSeconds = timer.getElapsedSeconds();
+
+    // Split the wall time of the loop in proportion to the time spent on each stage, and evenly between the signals
+    double const dftSeconds = std::accumulate(tileDFTSeconds.begin(), tileDFTSeconds.end(), 0.0);
+    double const postProcessingSeconds =
+        std::accumulate(tilePostProcessingSeconds.begin(), tilePostProcessingSeconds.end(), 0.0);
+    double const scale = dftSeconds + postProcessingSeconds > 0.0 ?
+        wallSeconds / ((dftSeconds + postProcessingSeconds) * numInputs) : 0.0;
+    for (std::size_t input = 0; input < numInputs; ++input) {
+        addStageMeasurement(_stageMeasurements.at(input), ProcessingStage::dft, scale * dftSeconds,
+                            timeDomainSize * sizeof(float), timeDomainSize);
+        addStageMeasurement(_stageMeasurements.at(input), ProcessingStage::postProcessing,
+                            scale * postProcessingSeconds, timeDomainSize * sizeof(std::int16_t), timeDomainSize);
+    }
+}
+
+std::size_t estimateProcessingMemory(ChannelRemapping const& remappingData, std::size_t const numBlocks) {
+    std::size_t const samplingFreq = remappingData.newSamplingFreq;
+    std::size_t const nyquistChannel = (samplingFreq / 2) + 1;
+    // Remapped channels and the 16 bit output. The time domain signal is only held a tile at a time.
+    return numBlocks * (nyquistChannel * sizeof(std::complex<float>) + samplingFreq * sizeof(std::int16_t));
+}
+
 void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
                                std::vector<unsigned> const& signalDataInMapping,
                                std::vector<std::int16_t>& signalDataOut,
@@ -112,11 +687,28 @@ void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDa
         throw std::invalid_argument("ChannelRemapping cannot be empty ");
     }
 
-    if ( remappingData.channelMap.size() != signalDataInMapping.size() ) {
-        throw std::invalid_argument("Different number of remapped channels and input channels");
+    if ( signalDataIn.empty() ) {
+        throw std::invalid_argument("Number of channels present in input signal do not equal number of channels in mapping");
     }
 
-    if ( signalDataInMapping.size() != signalDataIn.size() ) {
+    ProcessingPlan plan{remappingData, coefficiantPFB, static_cast<unsigned>(signalDataIn.at(0).size())};
+    processSignal(signalDataIn, signalDataInMapping, signalDataOut, plan);
+}
+
+void processSignal(AntennaInputSamples const& signalDataIn,
+                               std::vector<unsigned> const& signalDataInMapping,
+                               std::vector<std::int16_t>& signalDataOut,
+                               std::vector<std::complex<float>> const& coefficiantPFB,
+                               ChannelRemapping const& remappingData) {
+    ProcessingPlan plan{remappingData, coefficiantPFB, static_cast<unsigned>(signalDataIn.getNumSamples())};
+    processSignal(signalDataIn, signalDataInMapping, signalDataOut, plan);
+}
+
+void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
+                               std::vector<unsigned> const& signalDataInMapping,
+                               std::vector<std::int16_t>& signalDataOut,
+                               ProcessingPlan& plan) {
+    if ( signalDataIn.empty() ) {
         throw std::invalid_argument("Number of channels present in input signal do not equal number of channels in mapping");
     }
 
@@ -128,33 +720,38 @@ void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDa
         }
     }
 
-    if ( IN_NUM_BLOCKS % 2 != 0 && IN_NUM_BLOCKS != 1 ) {
-        throw std::invalid_argument("Number of samples in the input data is not a multiple of 2 or size of 1");
-    }
+    validateSignalArguments(signalDataIn.size(), IN_NUM_BLOCKS, signalDataInMapping, plan);
 
-    if ( coefficiantPFB.size() == 0 ) {
-        throw std::invalid_argument("PFB coefficiant array cannot be empty");
-    }
+    plan._remap(signalDataIn, signalDataInMapping, 0, 1);
+    plan._processRemapped(1, &signalDataOut);
+}
 
-    if ( coefficiantPFB.size() % PFB_COE_CHANNELS != 0 ) {
-        throw std::invalid_argument("PFB coefficant data is not a multiple of number of PFB channels "
-                + std::to_string(PFB_COE_CHANNELS));
-    }
+void processSignal(AntennaInputSamples const& signalDataIn,
+                               std::vector<unsigned> const& signalDataInMapping,
+                               std::vector<std::int16_t>& signalDataOut,
+                               ProcessingPlan& plan) {
+    validateSignalArguments(signalDataIn.getNumChannels(), signalDataIn.getNumSamples(), signalDataInMapping, plan);
 
-    if ( (coefficiantPFB.size() / PFB_COE_CHANNELS) > signalDataIn.at(0).size() ) {
-        throw std::invalid_argument("The PFB Array must contain the same number or less blocks as the signal data");
-    }
+    plan._remap(signalDataIn, signalDataInMapping, 0, 1);
+    plan._processRemapped(1, &signalDataOut);
+}
 
-    unsigned const NYQUIST_CHANNEL = (remappingData.newSamplingFreq / 2) + 1;
+void processSignalBatch(std::vector<AntennaInputSamples const*> const& signalDataIn,
+                        std::vector<unsigned> const& signalDataInMapping,
+                        std::vector<std::vector<std::int16_t>>& signalDataOut,
+                        ProcessingPlan& plan) {
+    if ( signalDataIn.empty() || signalDataIn.size() > plan._batchSize ) {
+        throw std::invalid_argument("Number of input signals must be between 1 and the batch size of the processing plan");
+    }
+    for (auto const signal : signalDataIn) {
+        validateSignalArguments(signal->getNumChannels(), signal->getNumSamples(), signalDataInMapping, plan);
+    }
 
-    std::vector<float> timeDomain{};
-    std::vector<std::complex<float>> remappedData{};
-    {
-        remapChannels(signalDataIn, signalDataInMapping, remappedData, remappingData.channelMap, NYQUIST_CHANNEL);
-        performPFB(remappedData, coefficiantPFB, remappingData.channelMap, IN_NUM_BLOCKS, NYQUIST_CHANNEL);
+    for (std::size_t input = 0; input < signalDataIn.size(); ++input) {
+        plan._remap(*signalDataIn[input], signalDataInMapping, input, signalDataIn.size());
     }
-    performDFT(remappedData, timeDomain, remappingData.newSamplingFreq, IN_NUM_BLOCKS, NYQUIST_CHANNEL);
-    doPostProcessing(timeDomain, signalDataOut);
+    signalDataOut.resize(signalDataIn.size());
+    plan._processRemapped(signalDataIn.size(), signalDataOut.data());
 }
 
 void remapChannels(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
@@ -167,50 +764,24 @@ void remapChannels(std::vector<std::vector<std::complex<float>>> const& signalDa
     // Tell the vector it's size and fill with zeros
     signalDataOut.resize(nyquistChannel * NUM_OF_BLOCKS);
 
-    // Work over each element of the mapping
-    for (unsigned unmappedChannel = 0; unmappedChannel < signalDataInMapping.size(); ++unmappedChannel) {
-        // Get the variables
-        unsigned const oldChannel = signalDataInMapping.at(unmappedChannel);
-
-        try {
-            auto const mappingIterator = channelRemapping.at(oldChannel);
-            unsigned const newChannel = mappingIterator.newChannel;
-            bool const flipped = mappingIterator.flipped;
-
-            if (newChannel > nyquistChannel) {
-                throw std::invalid_argument("Channel mapping values greater than the nyquist channel");
-            }
-
-            // Grab the correct channel vector based on the mapping
-            std::vector<std::complex<float>> const& channelVector = signalDataIn.at(unmappedChannel);
+    auto const channels = flattenChannelMap(channelRemapping, nyquistChannel);
+    remapChannels(signalDataIn, signalDataInMapping, signalDataOut.data(), channels, indexChannels(channels),
+                  nyquistChannel, nyquistChannel);
+}
 
-            if (flipped) {
-                // Do a strided conjugated copy over it
-                vcConjI(NUM_OF_BLOCKS,
-                        reinterpret_cast<const MKL_Complex8*>(channelVector.data()), 1,
-                        reinterpret_cast<MKL_Complex8*>(signalDataOut.data() + newChannel), nyquistChannel);
-            }
-            else {
-                // Do a strided copy over it
-                cblas_ccopy(NUM_OF_BLOCKS,
-                            channelVector.data(), 1,
-                            signalDataOut.data() + newChannel, nyquistChannel);
-            }
+void remapChannels(AntennaInputSamples const& signalDataIn,
+                   std::vector<unsigned> const& signalDataInMapping,
+                   std::vector<std::complex<float>>& signalDataOut,
+                   std::map<unsigned, ChannelRemapping::RemappedChannel> const& channelRemapping,
+                   unsigned const nyquistChannel) {
 
-            // I would've liked to do this outside of the loop so it only needs to be done once but due
-            // to the fact that the mapping is indexed by the original channel this is not possible!
-            // Scale by two for these edge cases
-            if ( (newChannel == nyquistChannel - 1) || // If nyquist frequency
-               (newChannel == 0 && oldChannel != 0) // If something was remapped to zero
-                ) {
-                cblas_csscal(NUM_OF_BLOCKS, 2, signalDataOut.data() + newChannel, nyquistChannel);
+    std::size_t const NUM_OF_BLOCKS = signalDataIn.getNumSamples();
+    // Tell the vector it's size and fill with zeros
+    signalDataOut.resize(nyquistChannel * NUM_OF_BLOCKS);
 
-            }
-        }
-        catch ( std::out_of_range& e) {
-            throw std::invalid_argument("Signal mapping and Channel mapping do not match");
-        }
-    }
+    auto const channels = flattenChannelMap(channelRemapping, nyquistChannel);
+    remapChannels(signalDataIn, signalDataInMapping, signalDataOut.data(), channels, indexChannels(channels),
+                  nyquistChannel, nyquistChannel);
 }
 
 void performPFB(std::vector<std::complex<float>>& signalData,
@@ -218,35 +789,45 @@ void performPFB(std::vector<std::complex<float>>& signalData,
                        std::map<unsigned, ChannelRemapping::RemappedChannel> const& mapping,
                        unsigned const numOfBlocks,
                        unsigned const numOfChannels) {
+    auto const taps = makeChannelTaps(coefficantPFB, flattenChannelMap(mapping, numOfChannels), numOfChannels);
+    performPFB(signalData, coefficantPFB, mapping, numOfBlocks, numOfChannels,
+               choosePFBEngine(coefficantPFB.size() / PFB_COE_CHANNELS, numOfBlocks, getRealTaps(taps).has_value(),
+                               false));
+}
+
+void performPFB(std::vector<std::complex<float>>& signalData,
+                std::vector<std::complex<float>> const& coefficantPFB,
+                std::map<unsigned, ChannelRemapping::RemappedChannel> const& mapping,
+                unsigned const numOfBlocks,
+                unsigned const numOfChannels,
+                PFBEngine const engine) {
+    auto const channels = flattenChannelMap(mapping, numOfChannels);
+
+    if (engine == PFBEngine::overlapSave) {
+        OverlapSaveFilter{makeChannelTaps(coefficantPFB, channels, numOfChannels), numOfChannels}.apply(
+            signalData.data(), numOfBlocks);
+        return;
+    }
+
+    if (engine == PFBEngine::channelFIR) {
+        auto const taps = getRealTaps(makeChannelTaps(coefficantPFB, channels, numOfChannels));
+        if (!taps.has_value()) {
+            throw std::invalid_argument("The channel FIR PFB engine requires real coefficients");
+        }
+        ChannelFIRFilter{taps.value(), numOfChannels}.apply(signalData.data(), numOfBlocks);
+        return;
+    }
+
     unsigned const coefficantBlockSize = coefficantPFB.size() / PFB_COE_CHANNELS;
 
     VSLConvTaskPtr convolutionTask = nullptr;
-    handleVSLError(vslcConvNewTask1D(&convolutionTask,
-                      VSL_CORR_MODE_AUTO,
-                      numOfBlocks,
-                      coefficantBlockSize,
-                      (numOfBlocks + coefficantBlockSize) - 1));
+    createConvolutionTask(convolutionTask, numOfBlocks, coefficantBlockSize);
 
     // Temporary Location to do the convolution in
     std::vector<std::complex<float>> convolutionResult((numOfBlocks + coefficantBlockSize) - 1, { 0.0f, 0.0f });
 
-
-    // Only work over the channels that actually have something in them
-    for(auto map : mapping) {
-        unsigned const oldChannel = map.first;
-        unsigned const newChannel = map.second.newChannel;
-
-        // NOTE: Stride over coefficantPFB data is using the original channel data as it didn't get remapped
-        handleVSLError(vslcConvExec1D(convolutionTask,
-                       reinterpret_cast<const MKL_Complex8*>(signalData.data() + newChannel), numOfChannels,
-                       reinterpret_cast<const MKL_Complex8*>(coefficantPFB.data() + oldChannel), PFB_COE_CHANNELS,
-                       reinterpret_cast<MKL_Complex8*>(convolutionResult.data()), 1));
-
-        // Copy the middle part of the convolution back to the orginal array
-        cblas_ccopy(numOfBlocks,
-                    convolutionResult.data() + coefficantBlockSize/2, 1,
-                    signalData.data() + newChannel, numOfChannels);
-    }
+    executePFB(convolutionTask, signalData.data(), coefficantPFB, channels, numOfBlocks, numOfChannels,
+               convolutionResult.data());
     vslConvDeleteTask(&convolutionTask);
 }
 
@@ -257,29 +838,15 @@ void performDFT(std::vector<std::complex<float>>& signalData,
                 unsigned const numOfChannels) {
     DFTI_DESCRIPTOR_HANDLE hand;
     outData.resize(samplingFreq * numOfBlocks);
-    handleMKLError(DftiCreateDescriptor(&hand, DFTI_SINGLE, DFTI_REAL, 1, samplingFreq));
-    handleMKLError(DftiSetValue(hand, DFTI_PACKED_FORMAT, DFTI_CCE_FORMAT));
-    handleMKLError(DftiSetValue(hand, DFTI_PLACEMENT, DFTI_NOT_INPLACE));
-    handleMKLError(DftiSetValue(hand, DFTI_CONJUGATE_EVEN_STORAGE,  DFTI_COMPLEX_COMPLEX));
-    handleMKLError(DftiSetValue(hand, DFTI_NUMBER_OF_TRANSFORMS, static_cast<MKL_LONG>(numOfBlocks)));
-    handleMKLError(DftiSetValue(hand, DFTI_INPUT_DISTANCE, numOfChannels));
-    handleMKLError(DftiSetValue(hand, DFTI_OUTPUT_DISTANCE, samplingFreq));
-    handleMKLError(DftiCommitDescriptor(hand));
+    createDFTDescriptor(hand, samplingFreq, numOfBlocks, numOfChannels);
     handleMKLError(DftiComputeBackward(hand, signalData.data(), outData.data()));
     handleMKLError(DftiFreeDescriptor(&hand));
 }
 
-constexpr std::int16_t clamp(float n) {
-    if (n > std::numeric_limits<std::int16_t>::max()) { return std::numeric_limits<std::int16_t>::max(); }
-    if (n < std::numeric_limits<std::int16_t>::min()) { return std::numeric_limits<std::int16_t>::min(); }
-    return static_cast<std::int16_t>(n);
-}
-
 void doPostProcessing(std::vector<float> const& signalData,
                              std::vector<std::int16_t>& signalDataOut) {
     signalDataOut.resize(signalData.size());
-
-    tbb::parallel_for(size_t{0}, signalData.size(), [&signalData, &signalDataOut](size_t ii) {
-        signalDataOut.at(ii) = clamp(signalData.at(ii));
+    tbb::parallel_for(tbb::blocked_range<std::size_t>{0, signalData.size()}, [&signalData, &signalDataOut](auto const& range) {
+        convertToInt16(signalData.data() + range.begin(), range.size(), signalDataOut.data() + range.begin());
     });
 }
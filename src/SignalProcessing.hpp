@@ -1,17 +1,179 @@
 #pragma once
+#include"ChannelFIRFilter.hpp"
+#include"Common.hpp"
+#include"OverlapSaveFilter.hpp"
 #include<complex>
+#include<cstddef>
 #include<vector>
 #include<cstdint>
 #include<map>
+#include<memory>
+#include<optional>
+#include<stdexcept>
+#include<tbb/enumerable_thread_specific.h>
 
 // Forward declaration of ChannelRemapping struct "ChannelRemapping.hpp"
 struct ChannelRemapping;
+// Forward declaration of AntennaInputSamples class "AntennaInputSamples.hpp"
+class AntennaInputSamples;
 
 class SignalProcessingMKLError : public std::runtime_error {
 public:
     using runtime_error::runtime_error;
 };
 
+// Non-owning view of the PFB filter coefficients, wherever they are held (e.g. a std::vector, or memory shared between
+// processes, see HostSharedCoefficients). Behaves like std::span<std::complex<float> const>, which isn't available in
+// C++17.
+class CoefficientSpan {
+public:
+    CoefficientSpan(std::complex<float> const* data, std::size_t size);
+    // Views all of a vector's coefficients. The vector must outlive the view.
+    CoefficientSpan(std::vector<std::complex<float>> const& coefficients);
+
+    std::complex<float> const* data() const;
+    std::size_t size() const;
+
+    std::complex<float> const* begin() const;
+    std::complex<float> const* end() const;
+    std::complex<float> const& operator[](std::size_t index) const;
+
+private:
+    std::complex<float> const* _data;
+    std::size_t _size;
+};
+
+// How the inverse polyphase filter bank (PFB) filters each channel
+enum class PFBEngine {
+    // One MKL convolution per channel, for complex coefficients
+    convolution,
+    // Real FIR filters applied across all channels at once, see ChannelFIRFilter
+    channelFIR,
+    // FFT convolution of all channels at once, for long filters, see OverlapSaveFilter
+    overlapSave
+};
+
+// Chooses the PFB engine for filters of numTaps taps over signals of numBlocks samples per channel: overlapSave if it
+// is enabled and the signal fills at least one of its FFT segments, otherwise channelFIR for real coefficients or
+// convolution for complex ones.
+// overlapSave is only used when enabled, since the filter length from which it's faster than the direct engines
+// depends on the machine (see the PFB benchmark).
+PFBEngine choosePFBEngine(unsigned numTaps, unsigned numBlocks, bool realCoefficients, bool overlapSave);
+
+// Everything processSignal() needs which stays the same for every antenna input in a run: the channel remapping in a
+// flat form, the filter coefficients, the committed MKL DFT descriptors and convolution task, and the scratch buffers
+// the signal is processed in. Building it once avoids planning the DFT and convolution for every antenna input.
+// A plan can process a batch of up to batchSize antenna inputs at once, see processSignalBatch(). The signals of a batch
+// are interleaved a block at a time, so they are filtered as one signal with the channels of all of them, and each
+// tile of the inverse DFT is one MKL call covering the tile's blocks of every signal.
+// A plan's scratch buffers are reused by each call to processSignal(), so a plan may only be used by one thread at
+// a time.
+class ProcessingPlan {
+public:
+    // One channel of the remapping, see ChannelRemapping::RemappedChannel
+    struct Channel {
+        unsigned oldChannel;
+        unsigned newChannel;
+        bool flipped;
+        // Scale applied while remapping, 2 for the nyquist channel and channels remapped to channel 0, otherwise 1
+        float scale;
+    };
+
+    // Plans processing for batches of up to batchSize input signals with numBlocks samples per channel.
+    // overlapSave enables the overlapSave PFB engine, see choosePFBEngine().
+    // Throws std::invalid_argument if the remapping or coefficients are invalid (see processSignal()) or batchSize is
+    // 0, or SignalProcessingMKLError if MKL fails to create the DFT descriptor or convolution task.
+    // The coefficients are used in place rather than copied, so they must outlive the plan.
+    ProcessingPlan(ChannelRemapping const& remappingData,
+                   CoefficientSpan coefficiantPFB,
+                   unsigned numBlocks,
+                   unsigned batchSize = 1,
+                   bool overlapSave = false);
+    ProcessingPlan(ProcessingPlan const&) = delete;
+    ProcessingPlan(ProcessingPlan&&) = delete;
+    ~ProcessingPlan();
+
+    ProcessingPlan& operator=(ProcessingPlan const&) = delete;
+    ProcessingPlan& operator=(ProcessingPlan&&) = delete;
+
+    // Number of samples per channel of the input signals
+    unsigned getNumBlocks() const;
+    // Largest number of input signals processed together
+    unsigned getBatchSize() const;
+    // Number of blocks (of every input signal) in each tile the inverse DFT of a full batch is done in
+    unsigned getTileBlocks() const;
+    // Sampling frequency of the output signal
+    unsigned getSamplingFreq() const;
+    // Number of channels in the remapped signal
+    unsigned getNyquistChannel() const;
+    // Channels of the remapping, in order of the original channel
+    std::vector<Channel> const& getChannels() const;
+    // PFB engine used, see choosePFBEngine()
+    PFBEngine getPFBEngine() const;
+    // Time and output of the remap, PFB, inverse DFT and post-processing stages for each input signal of the last
+    // batch (or single signal) processed. The inverse DFT and post-processing are done together, so the wall time of
+    // both is split between them, and between the signals, in proportion to the time the threads spent in each.
+    StageMeasurements const& getStageMeasurements(std::size_t input) const;
+
+private:
+    // MKL handles, defined in SignalProcessing.cpp so MKL isn't needed to use this header
+    struct MKLTasks;
+    // Filters and MKL handles for processing a given number of input signals together, defined in SignalProcessing.cpp
+    struct BatchTasks;
+
+    // Gets the BatchTasks for numInputs input signals, creating them if they haven't been needed before
+    BatchTasks& _getBatchTasks(std::size_t numInputs);
+
+    // Remaps an input signal into the given position of _remappedData, laid out for a batch of numInputs signals,
+    // measuring the time it takes
+    template<typename Signal>
+    void _remap(Signal const& signalDataIn, std::vector<unsigned> const& signalDataInMapping, std::size_t input,
+                std::size_t numInputs);
+
+    // Performs the PFB, inverse DFT and post-processing of the first numInputs input signals remapped into
+    // _remappedData, into numInputs consecutive output vectors
+    void _processRemapped(std::size_t numInputs, std::vector<std::int16_t>* signalDataOut);
+
+    friend void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
+                              std::vector<unsigned> const& signalDataInMapping,
+                              std::vector<std::int16_t>& signalDataOut,
+                              ProcessingPlan& plan);
+    friend void processSignal(AntennaInputSamples const& signalDataIn,
+                              std::vector<unsigned> const& signalDataInMapping,
+                              std::vector<std::int16_t>& signalDataOut,
+                              ProcessingPlan& plan);
+    friend void processSignalBatch(std::vector<AntennaInputSamples const*> const& signalDataIn,
+                                   std::vector<unsigned> const& signalDataInMapping,
+                                   std::vector<std::vector<std::int16_t>>& signalDataOut,
+                                   ProcessingPlan& plan);
+
+    unsigned _numBlocks;
+    unsigned _batchSize;
+    unsigned _samplingFreq;
+    unsigned _nyquistChannel;
+    CoefficientSpan _coefficients;
+    unsigned _coefficientBlockSize;
+    std::vector<Channel> _channels;
+    // Index into _channels of each original channel, -1 for channels not in the remapping
+    std::vector<int> _channelIndex;
+    PFBEngine _pfbEngine;
+    std::unique_ptr<MKLTasks> _mklTasks;
+    // BatchTasks for each number of input signals in a batch (element 0 for 1 signal), created when first needed
+    std::vector<std::unique_ptr<BatchTasks>> _batchTasks;
+    // Scratch buffers, kept between antenna inputs. _remappedData holds the input signals of a batch laid out
+    // [block][input][channel].
+    std::vector<std::complex<float>> _remappedData;
+    std::vector<std::complex<float>> _convolutionResult;
+    // Time domain signal of the tile of the inverse DFT each thread is working on
+    tbb::enumerable_thread_specific<std::vector<float>> _timeDomain;
+    // Measurements of each input signal of the last batch processed
+    std::vector<StageMeasurements> _stageMeasurements;
+};
+
+// Estimates the memory (in bytes) used processing one antenna input with numBlocks samples per channel: the scratch
+// buffers of its ProcessingPlan and the processed signal.
+std::size_t estimateProcessingMemory(ChannelRemapping const& remappingData, std::size_t numBlocks);
+
 // Function responsible for all the transoformations, filters and downsampling
 // the signal data.
 void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
@@ -19,3 +181,33 @@ void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDa
                                std::vector<std::int16_t>& signalDataOut,
                                std::vector<std::complex<float>> const& coefficiantPFB,
                                ChannelRemapping const& remappingData);
+
+// Same as above, but takes the raw 8 bit samples of each channel. These are converted to floating point a cache sized
+// tile at a time as they are remapped, so a full floating point copy of the input signal is never held in memory.
+void processSignal(AntennaInputSamples const& signalDataIn,
+                               std::vector<unsigned> const& signalDataInMapping,
+                               std::vector<std::int16_t>& signalDataOut,
+                               std::vector<std::complex<float>> const& coefficiantPFB,
+                               ChannelRemapping const& remappingData);
+
+// Same as the above overloads, but using a plan built beforehand rather than planning for this signal alone.
+// Throws std::invalid_argument if the signal doesn't match the plan.
+void processSignal(std::vector<std::vector<std::complex<float>>> const& signalDataIn,
+                               std::vector<unsigned> const& signalDataInMapping,
+                               std::vector<std::int16_t>& signalDataOut,
+                               ProcessingPlan& plan);
+
+void processSignal(AntennaInputSamples const& signalDataIn,
+                               std::vector<unsigned> const& signalDataInMapping,
+                               std::vector<std::int16_t>& signalDataOut,
+                               ProcessingPlan& plan);
+
+// Processes a batch of input signals together, each as processSignal() does, into an output signal for each. The
+// signals are remapped and filtered one at a time, then the inverse DFT of all of them is done in one parallel loop
+// over tiles of blocks, so there is one loop to start and finish for the batch rather than for each signal.
+// All the signals must have the same channels (given by signalDataInMapping) and match the plan, and there can be no
+// more than plan.getBatchSize() of them. Throws std::invalid_argument otherwise.
+void processSignalBatch(std::vector<AntennaInputSamples const*> const& signalDataIn,
+                        std::vector<unsigned> const& signalDataInMapping,
+                        std::vector<std::vector<std::int16_t>>& signalDataOut,
+                        ProcessingPlan& plan);
@@ -0,0 +1,98 @@
+#include "SignalWriteBehind.hpp"
+
+#include "StageTiming.hpp"
+
+#include <utility>
+
+
+SignalWriteBehind::SignalWriteBehind(SignalWriter writeSignal, unsigned queueDepth, unsigned maxFreeBuffers) :
+    _writeSignal{std::move(writeSignal)},
+    _queueDepth{queueDepth},
+    _maxFreeBuffers{maxFreeBuffers},
+    _mutex{},
+    _condition{},
+    _queue{},
+    _writing{false},
+    _freeBuffers{},
+    _results{},
+    _stopping{false},
+    _writerThread{&SignalWriteBehind::_writeSignals, this}
+{}
+
+SignalWriteBehind::~SignalWriteBehind() {
+    {
+        std::lock_guard<std::mutex> const lock{_mutex};
+        _stopping = true;
+    }
+    _condition.notify_all();
+    _writerThread.join();
+}
+
+void SignalWriteBehind::write(PendingSignalWrite pendingWrite) {
+    {
+        std::unique_lock<std::mutex> lock{_mutex};
+        _condition.wait(lock, [this]() { return _queue.size() < _queueDepth; });
+        _queue.push_back(std::move(pendingWrite));
+    }
+    _condition.notify_all();
+}
+
+std::vector<std::int16_t> SignalWriteBehind::takeBuffer() {
+    std::lock_guard<std::mutex> const lock{_mutex};
+    if (_freeBuffers.empty()) {
+        return {};
+    }
+    auto buffer = std::move(_freeBuffers.back());
+    _freeBuffers.pop_back();
+    return buffer;
+}
+
+ObservationProcessingResults SignalWriteBehind::finish() {
+    std::unique_lock<std::mutex> lock{_mutex};
+    _condition.wait(lock, [this]() { return _queue.empty() && !_writing; });
+    _freeBuffers.clear();
+    _freeBuffers.shrink_to_fit();
+    return std::exchange(_results, {});
+}
+
+void SignalWriteBehind::_writeSignals() {
+    while (true) {
+        PendingSignalWrite pendingWrite;
+        {
+            std::unique_lock<std::mutex> lock{_mutex};
+            _condition.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+            if (_stopping) {
+                return;
+            }
+            pendingWrite = std::move(_queue.front());
+            _queue.pop_front();
+            _writing = true;
+        }
+        // Let write() know there's room for another signal
+        _condition.notify_all();
+
+        // Write without holding the lock so signals can be handed off meanwhile
+        auto const& signal = pendingWrite.signal;
+        StageTimer const writeTimer;
+        bool success = false;
+        try {
+            success = _writeSignal(pendingWrite.index, signal);
+        }
+        catch (...) {}
+        if (success) {
+            addStageMeasurement(pendingWrite.measurements, ProcessingStage::write, writeTimer.getElapsedSeconds(),
+                                signal.size() * sizeof(std::int16_t), signal.size());
+        }
+
+        {
+            std::lock_guard<std::mutex> const lock{_mutex};
+            _results.results.insert({pendingWrite.index,
+                                     {success, std::move(pendingWrite.usedChannels), pendingWrite.measurements}});
+            if (_freeBuffers.size() < _maxFreeBuffers) {
+                _freeBuffers.push_back(std::move(pendingWrite.signal));
+            }
+            _writing = false;
+        }
+        _condition.notify_all();
+    }
+}
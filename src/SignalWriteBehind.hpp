@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+// Processed signal of an antenna input waiting to be written, with what's needed to record the result of writing it.
+struct PendingSignalWrite {
+    // Index of the antenna input in the antenna configuration.
+    unsigned index;
+    std::vector<std::int16_t> signal;
+    std::set<unsigned> usedChannels;
+    // Measurements of the stages the antenna input has been through, to which the write is added.
+    StageMeasurements measurements;
+};
+
+
+// Writes processed signals on a dedicated writer thread, so the processing threads hand each signal off and move
+// straight on to the next antenna inputs rather than waiting for it to be written. At most queueDepth signals wait to
+// be written at once, since each is held in memory; handing off another waits until there's room.
+// Up to maxFreeBuffers of the buffers of written signals are kept for processing later signals into, so they aren't
+// allocated again for every antenna input.
+class SignalWriteBehind {
+public:
+    // Writes the signal of an antenna input, returning whether it was written successfully (an exception counts as
+    // a failure). Only ever called from the writer thread.
+    using SignalWriter = std::function<bool(unsigned index, std::vector<std::int16_t> const& signal)>;
+
+    // Starts the writer thread, writing the signals with writeSignal. queueDepth must be at least 1.
+    SignalWriteBehind(SignalWriter writeSignal, unsigned queueDepth, unsigned maxFreeBuffers);
+    SignalWriteBehind(SignalWriteBehind const&) = delete;
+    SignalWriteBehind(SignalWriteBehind&&) = delete;
+
+    // Stops the writer thread, waiting for the signal being written (if any) to finish. Signals still waiting to be
+    // written are discarded.
+    ~SignalWriteBehind();
+
+    // Hands a signal off to the writer thread, waiting for room if queueDepth signals are already waiting.
+    // May be called from multiple threads at once.
+    void write(PendingSignalWrite pendingWrite);
+
+    // Gets a buffer to process a signal into: the buffer of a signal already written if there is one (with its old
+    // contents), otherwise an empty one.
+    // May be called from multiple threads at once.
+    std::vector<std::int16_t> takeBuffer();
+
+    // Waits for all the signals handed off so far to be written, then returns the results of writing them (except
+    // those returned by an earlier call), including the time taken to write them. The kept buffers are released.
+    ObservationProcessingResults finish();
+
+    SignalWriteBehind& operator=(SignalWriteBehind const&) = delete;
+    SignalWriteBehind& operator=(SignalWriteBehind&&) = delete;
+
+private:
+    // Run by the writer thread.
+    void _writeSignals();
+
+    SignalWriter _writeSignal;
+    unsigned const _queueDepth;
+    unsigned const _maxFreeBuffers;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    // Signals handed off but not yet being written.
+    std::deque<PendingSignalWrite> _queue;
+    // Set while the writer thread is writing a signal.
+    bool _writing;
+    // Buffers of written signals, at most _maxFreeBuffers of them.
+    std::vector<std::vector<std::int16_t>> _freeBuffers;
+    // Results of the signals written since the last call to finish().
+    ObservationProcessingResults _results;
+    // Set to stop the writer thread.
+    bool _stopping;
+    // Declared last so the thread is started after everything it uses is initialised.
+    std::thread _writerThread;
+};
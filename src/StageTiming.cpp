@@ -0,0 +1,78 @@
+#include "StageTiming.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+
+StageTimer::StageTimer() :
+    _start{std::chrono::steady_clock::now()}
+{}
+
+double StageTimer::getElapsedSeconds() const {
+    return std::chrono::duration<double>{std::chrono::steady_clock::now() - _start}.count();
+}
+
+
+std::string getStageName(ProcessingStage stage) {
+    switch (stage) {
+        case ProcessingStage::read:
+            return "Read";
+        case ProcessingStage::remap:
+            return "Remap";
+        case ProcessingStage::pfb:
+            return "Inverse PFB";
+        case ProcessingStage::dft:
+            return "Inverse DFT";
+        case ProcessingStage::postProcessing:
+            return "Post-processing";
+        case ProcessingStage::write:
+            return "Write";
+        default:
+            return "Unknown";
+    }
+}
+
+void addStageMeasurement(StageMeasurements& measurements, ProcessingStage stage, double seconds,
+                         unsigned long long bytes, unsigned long long samples) {
+    auto& measurement = measurements.at(static_cast<std::size_t>(stage));
+    measurement.seconds += seconds;
+    measurement.bytes += bytes;
+    measurement.samples += samples;
+}
+
+StageSummary summariseStage(ObservationProcessingResults const& results, ProcessingStage stage,
+                            std::optional<unsigned> node) {
+    StageSummary summary{0, 0.0, 0.0, 0.0, 0.0, 0, 0};
+    std::vector<double> seconds;
+    for (auto const& [antennaInput, antennaInputResults] : results.results) {
+        auto const& measurement = antennaInputResults.stageMeasurements.at(static_cast<std::size_t>(stage));
+        if ((node.has_value() && antennaInputResults.node != node.value()) ||
+            (measurement.seconds == 0.0 && measurement.bytes == 0 && measurement.samples == 0)) {
+            continue;
+        }
+        seconds.push_back(measurement.seconds);
+        summary.totalSeconds += measurement.seconds;
+        summary.totalBytes += measurement.bytes;
+        summary.totalSamples += measurement.samples;
+    }
+
+    if (!seconds.empty()) {
+        std::sort(seconds.begin(), seconds.end());
+        auto const middle = seconds.size() / 2;
+        summary.numAntennaInputs = static_cast<unsigned>(seconds.size());
+        summary.minSeconds = seconds.front();
+        summary.maxSeconds = seconds.back();
+        summary.medianSeconds = seconds.size() % 2 == 1 ? seconds.at(middle) :
+                                                          (seconds.at(middle - 1) + seconds.at(middle)) / 2.0;
+    }
+    return summary;
+}
+
+double getBytesPerSecond(StageSummary const& summary) {
+    return summary.totalSeconds > 0.0 ? summary.totalBytes / summary.totalSeconds : 0.0;
+}
+
+double getSamplesPerSecond(StageSummary const& summary) {
+    return summary.totalSeconds > 0.0 ? summary.totalSamples / summary.totalSeconds : 0.0;
+}
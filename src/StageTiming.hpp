@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Common.hpp"
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+
+// Measures the wall time since it was started, for timing the processing stages of antenna inputs.
+// Only reads a steady clock, so it's cheap enough to use around every stage of every antenna input.
+class StageTimer {
+public:
+    // Starts timing.
+    StageTimer();
+
+    // Gets the time since the timer was started, in seconds.
+    double getElapsedSeconds() const;
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+
+
+// Statistics of one processing stage over a set of antenna inputs.
+struct StageSummary {
+    // Number of antenna inputs which went through the stage.
+    unsigned numAntennaInputs;
+    double totalSeconds;
+    // Time of the stage for one antenna input.
+    double minSeconds;
+    double medianSeconds;
+    double maxSeconds;
+    unsigned long long totalBytes;
+    unsigned long long totalSamples;
+};
+
+
+// Gets the name of a processing stage as written in the output log.
+std::string getStageName(ProcessingStage stage);
+
+// Adds to the measurement of one stage of an antenna input.
+void addStageMeasurement(StageMeasurements& measurements, ProcessingStage stage, double seconds,
+                         unsigned long long bytes, unsigned long long samples);
+
+// Summarises a stage over the antenna inputs processed by node, or by all nodes if node is empty. Antenna inputs
+// which didn't go through the stage (no time or data measured) are left out.
+StageSummary summariseStage(ObservationProcessingResults const& results, ProcessingStage stage,
+                            std::optional<unsigned> node = {});
+
+// Gets the throughput of a stage in bytes and samples per second of time spent in it, 0 if no time was spent.
+double getBytesPerSecond(StageSummary const& summary);
+double getSamplesPerSecond(StageSummary const& summary);
@@ -0,0 +1,147 @@
+#include "SubfileIndex.hpp"
+
+#include "ReadInputFile.hpp"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <variant>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+SubfileIndex::SubfileIndex(std::string const& fileName) :
+    _fileSize{0}, _headerSize{0}, _numSamples{0}, _numInputs{0}, _numPolarisations{0}, _offsets{}
+{
+    int const fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ReadInputDataException("Error Reading meta data from file");
+    }
+    struct stat fileStatus{};
+    std::string metadata(SUBFILE_HEADER_READ_SIZE, ' ');
+    bool const readOk = ::fstat(fd, &fileStatus) == 0 &&
+        ::pread(fd, metadata.data(), metadata.size(), 0) == static_cast<ssize_t>(metadata.size());
+    ::close(fd);
+    if (!readOk) {
+        throw ReadInputDataException("Error Reading meta data from file");
+    }
+    _fileSize = fileStatus.st_size;
+
+    try {
+        int const headerSize = getMetaDataSize(metadata);
+        int const numSamples = getNSamples(metadata);
+        int const numInputs = getNInputs(metadata);
+        int const numPolarisations = getNPols(metadata);
+        if (headerSize <= 0 || numSamples <= 0 || numInputs <= 0 || numPolarisations <= 0) {
+            throw ReadInputDataException("Error Reading meta data from file");
+        }
+        _headerSize = headerSize;
+        _numSamples = numSamples;
+        _numInputs = numInputs;
+        _numPolarisations = numPolarisations;
+    }
+    catch (std::logic_error const&) {
+        // std::stoi() failures from a malformed header.
+        throw ReadInputDataException("Error Reading meta data from file");
+    }
+
+    // Antenna inputs are stored one after another within a block, and blocks one after another after the delay block.
+    std::size_t const inputSize = static_cast<std::size_t>(_numSamples) * 2;
+    std::size_t const blockSize = inputSize * getNumAntennaInputs();
+    _offsets.reserve(static_cast<std::size_t>(SUBFILE_NUM_DATA_BLOCKS) * getNumAntennaInputs());
+    for (unsigned block = 0; block < SUBFILE_NUM_DATA_BLOCKS; ++block) {
+        for (unsigned antennaInput = 0; antennaInput < getNumAntennaInputs(); ++antennaInput) {
+            _offsets.push_back(_headerSize + (block + 1) * blockSize + antennaInput * inputSize);
+        }
+    }
+}
+
+std::size_t SubfileIndex::getFileSize() const {
+    return _fileSize;
+}
+
+std::size_t SubfileIndex::getHeaderSize() const {
+    return _headerSize;
+}
+
+unsigned SubfileIndex::getNumSamples() const {
+    return _numSamples;
+}
+
+unsigned SubfileIndex::getNumInputs() const {
+    return _numInputs;
+}
+
+unsigned SubfileIndex::getNumPolarisations() const {
+    return _numPolarisations;
+}
+
+unsigned SubfileIndex::getNumAntennaInputs() const {
+    return _numInputs * _numPolarisations;
+}
+
+unsigned SubfileIndex::getNumBlocks() const {
+    return SUBFILE_NUM_DATA_BLOCKS;
+}
+
+std::size_t SubfileIndex::getOffset(unsigned block, unsigned antennaInput) const {
+    if (block >= SUBFILE_NUM_DATA_BLOCKS || antennaInput >= getNumAntennaInputs()) {
+        throw std::out_of_range{"Data block or antenna input outside of the signal file"};
+    }
+    return _offsets[static_cast<std::size_t>(block) * getNumAntennaInputs() + antennaInput];
+}
+
+bool SubfileIndex::isValid(unsigned expectedNInputs) const {
+    // Header, then the delay block, then the data blocks, all blocks being the same size.
+    std::size_t const blockSize = static_cast<std::size_t>(_numSamples) * 2 * getNumAntennaInputs();
+    return getNumAntennaInputs() == expectedNInputs &&
+        _fileSize == _headerSize + blockSize * (SUBFILE_NUM_DATA_BLOCKS + 1);
+}
+
+
+// Either a successfully built index, or the message of the exception thrown while building it.
+using CachedSubfileIndex = std::variant<std::shared_ptr<SubfileIndex const>, std::string>;
+
+static std::mutex subfileIndexCacheMutex;
+static std::map<std::string, CachedSubfileIndex> subfileIndexCache;
+
+std::shared_ptr<SubfileIndex const> getSubfileIndex(std::string const& fileName) {
+    {
+        std::lock_guard<std::mutex> const lock{subfileIndexCacheMutex};
+        auto const it = subfileIndexCache.find(fileName);
+        if (it != subfileIndexCache.end()) {
+            if (auto const index = std::get_if<std::shared_ptr<SubfileIndex const>>(&it->second)) {
+                return *index;
+            }
+            throw ReadInputDataException(std::get<std::string>(it->second));
+        }
+    }
+
+    // Build without holding the lock so other files can be indexed at the same time. If two threads race on the same
+    // file, both build an identical index and the first one stored is kept.
+    CachedSubfileIndex entry;
+    try {
+        entry = std::make_shared<SubfileIndex const>(fileName);
+    }
+    catch (ReadInputDataException const& e) {
+        entry = std::string{e.what()};
+    }
+
+    std::lock_guard<std::mutex> const lock{subfileIndexCacheMutex};
+    auto const& stored = subfileIndexCache.emplace(fileName, std::move(entry)).first->second;
+    if (auto const index = std::get_if<std::shared_ptr<SubfileIndex const>>(&stored)) {
+        return *index;
+    }
+    throw ReadInputDataException(std::get<std::string>(stored));
+}
+
+void clearSubfileIndexCache() {
+    std::lock_guard<std::mutex> const lock{subfileIndexCacheMutex};
+    subfileIndexCache.clear();
+}
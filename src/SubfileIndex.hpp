@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// Number of data blocks in a signal file (8 seconds of voltage data in 50ms blocks), following the delay block.
+constexpr unsigned SUBFILE_NUM_DATA_BLOCKS = 160;
+
+
+// Layout of a signal (.sub) file, parsed from its header once and then reused by every reader of the file.
+// Data blocks are numbered from 0, starting with the first block after the delay block.
+class SubfileIndex {
+public:
+    // Reads and parses the header of a signal file.
+    // Throws ReadInputDataException if the file can't be read or its header can't be parsed.
+    explicit SubfileIndex(std::string const& fileName);
+
+    // Size of the file in bytes, when the index was built.
+    std::size_t getFileSize() const;
+    // Size of the header in bytes (HDR_SIZE).
+    std::size_t getHeaderSize() const;
+    // Number of complex samples per antenna input per data block (NTIMESAMPLES).
+    unsigned getNumSamples() const;
+    // Number of inputs per polarisation, as given by the header (NFINE_CHAN).
+    unsigned getNumInputs() const;
+    // Number of polarisations (NPOL).
+    unsigned getNumPolarisations() const;
+    // Number of antenna inputs (inputs * polarisations) in each data block.
+    unsigned getNumAntennaInputs() const;
+    // Number of data blocks in the file.
+    unsigned getNumBlocks() const;
+
+    // Byte offset of the start of an antenna input's samples within a data block.
+    // Throws std::out_of_range if the block or antenna input isn't in the file.
+    std::size_t getOffset(unsigned block, unsigned antennaInput) const;
+
+    // Checks if the file size is consistent with its header, and it has the expected number of antenna inputs.
+    bool isValid(unsigned expectedNInputs) const;
+
+private:
+    std::size_t _fileSize;
+    std::size_t _headerSize;
+    unsigned _numSamples;
+    unsigned _numInputs;
+    unsigned _numPolarisations;
+    // Offset of each antenna input in each data block, indexed by block * getNumAntennaInputs() + antennaInput.
+    std::vector<std::size_t> _offsets;
+};
+
+
+// Gets the index of a signal file, building it on first use.
+// Indices are cached for the rest of the run and shared by all threads, so each file's header is only read once.
+// Files that couldn't be read are also remembered, and throw the same ReadInputDataException on every call.
+std::shared_ptr<SubfileIndex const> getSubfileIndex(std::string const& fileName);
+
+// Discards all cached indices (for when signal files are rewritten, e.g. in testing).
+void clearSubfileIndexCache();
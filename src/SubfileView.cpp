@@ -0,0 +1,140 @@
+#include "SubfileView.hpp"
+
+#include "ReadInputFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+RawSampleSpan::RawSampleSpan(std::int8_t const* data, std::size_t size) :
+    _data{data}, _size{size}
+{}
+
+std::int8_t const* RawSampleSpan::data() const {
+    return _data;
+}
+
+std::size_t RawSampleSpan::size() const {
+    return _size;
+}
+
+std::size_t RawSampleSpan::numSamples() const {
+    return _size / 2;
+}
+
+std::int8_t const* RawSampleSpan::begin() const {
+    return _data;
+}
+
+std::int8_t const* RawSampleSpan::end() const {
+    return _data + _size;
+}
+
+std::int8_t RawSampleSpan::operator[](std::size_t index) const {
+    return _data[index];
+}
+
+
+SubfileView::SubfileView(std::string const& fileName, unsigned expectedNInputs) :
+    _index{getSubfileIndex(fileName)}, _mapping{nullptr}, _mappingSize{0}
+{
+    if (!_index->isValid(expectedNInputs)) {
+        throw ReadInputDataException("Data file faild validation");
+    }
+
+    int const fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ReadInputDataException("Failed to open the file");
+    }
+    // The index is cached for the whole run, so check the file hasn't changed size since (e.g. been rewritten), otherwise
+    // reading past the end of the mapping would crash rather than throw.
+    struct stat fileStatus{};
+    if (::fstat(fd, &fileStatus) != 0 || static_cast<std::size_t>(fileStatus.st_size) != _index->getFileSize()) {
+        ::close(fd);
+        throw ReadInputDataException("Data file faild validation");
+    }
+    _mappingSize = _index->getFileSize();
+    void* const mapping = ::mmap(nullptr, _mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps its own reference to the file.
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw ReadInputDataException("Failed to map the file");
+    }
+    _mapping = static_cast<std::int8_t*>(mapping);
+
+    // Each antenna input only reads a small slice out of every data block, so the kernel's usual sequential readahead
+    // mostly pulls in data nobody asked for. Turn it off and rely on adviseWillNeed() for the slices actually used.
+    ::madvise(_mapping, _mappingSize, MADV_RANDOM);
+}
+
+SubfileView::SubfileView(SubfileView&& other) noexcept :
+    _index{std::move(other._index)},
+    _mapping{std::exchange(other._mapping, nullptr)},
+    _mappingSize{std::exchange(other._mappingSize, 0)}
+{}
+
+SubfileView::~SubfileView() {
+    if (_mapping != nullptr) {
+        ::munmap(_mapping, _mappingSize);
+    }
+}
+
+SubfileView& SubfileView::operator=(SubfileView&& other) noexcept {
+    std::swap(_index, other._index);
+    std::swap(_mapping, other._mapping);
+    std::swap(_mappingSize, other._mappingSize);
+    return *this;
+}
+
+SubfileIndex const& SubfileView::getIndex() const {
+    return *_index;
+}
+
+unsigned SubfileView::getNumAntennaInputs() const {
+    return _index->getNumAntennaInputs();
+}
+
+unsigned SubfileView::getNumSamples() const {
+    return _index->getNumSamples();
+}
+
+unsigned SubfileView::getNumBlocks() const {
+    return _index->getNumBlocks();
+}
+
+RawSampleSpan SubfileView::getSamples(unsigned block, unsigned antennaInput) const {
+    return getSamples(block, AntennaInputRange{antennaInput, antennaInput});
+}
+
+RawSampleSpan SubfileView::getSamples(unsigned block, AntennaInputRange const& antennaInputs) const {
+    if (antennaInputs.begin > antennaInputs.end || antennaInputs.end >= getNumAntennaInputs()) {
+        throw std::out_of_range{"Data block or antenna input outside of the signal file"};
+    }
+    std::size_t const numInputs = antennaInputs.end - antennaInputs.begin + 1;
+    return {_mapping + _index->getOffset(block, antennaInputs.begin), numInputs * getNumSamples() * 2};
+}
+
+void SubfileView::adviseWillNeed(unsigned block, AntennaInputRange const& antennaInputs) const {
+    _advise(block, antennaInputs, MADV_WILLNEED);
+}
+
+void SubfileView::adviseDontNeed(unsigned block, AntennaInputRange const& antennaInputs) const {
+    _advise(block, antennaInputs, MADV_DONTNEED);
+}
+
+void SubfileView::_advise(unsigned block, AntennaInputRange const& antennaInputs, int advice) const {
+    // madvise() needs a page aligned address, so widen the range out to whole pages.
+    std::size_t const pageSize = ::sysconf(_SC_PAGESIZE);
+    auto const samples = getSamples(block, antennaInputs);
+    std::size_t const begin = samples.data() - _mapping;
+    std::size_t const alignedBegin = begin - (begin % pageSize);
+    ::madvise(_mapping + alignedBegin, begin + samples.size() - alignedBegin, advice);
+}
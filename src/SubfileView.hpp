@@ -0,0 +1,82 @@
+#pragma once
+
+#include "NodeAntennaInputAssigner.hpp"
+#include "SubfileIndex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+// Non-owning view of a contiguous run of raw signal data, as stored in the signal files.
+// Each sample is an interleaved pair of 8-bit signed integers (real, then imaginary).
+// Behaves like std::span<std::int8_t const>, which isn't available in C++17.
+class RawSampleSpan {
+public:
+    RawSampleSpan(std::int8_t const* data, std::size_t size);
+
+    // Pointer to the first value.
+    std::int8_t const* data() const;
+    // Number of int8 values (i.e. 2 * the number of complex samples).
+    std::size_t size() const;
+    // Number of complex samples.
+    std::size_t numSamples() const;
+
+    std::int8_t const* begin() const;
+    std::int8_t const* end() const;
+    std::int8_t operator[](std::size_t index) const;
+
+private:
+    std::int8_t const* _data;
+    std::size_t _size;
+};
+
+
+// Read-only memory mapping of a signal (.sub) file, giving zero-copy access to its voltage data.
+// The mapping is shared, so all processes on a host that map the same file read the same page cache pages.
+// Data blocks are numbered from 0, starting with the first block after the delay block.
+class SubfileView {
+public:
+    // Maps the file and validates it against the expected number of antenna inputs, using its cached index.
+    // Throws ReadInputDataException if the file can't be mapped or fails validation.
+    SubfileView(std::string const& fileName, unsigned expectedNInputs);
+
+    // The parsed layout of the file.
+    SubfileIndex const& getIndex() const;
+    SubfileView(SubfileView const&) = delete;
+    SubfileView(SubfileView&& other) noexcept;
+
+    ~SubfileView();
+
+    // Number of antenna inputs (inputs * polarisations) in each data block.
+    unsigned getNumAntennaInputs() const;
+    // Number of complex samples per antenna input per data block.
+    unsigned getNumSamples() const;
+    // Number of data blocks in the file.
+    unsigned getNumBlocks() const;
+
+    // Gets the raw samples of one antenna input within one data block.
+    RawSampleSpan getSamples(unsigned block, unsigned antennaInput) const;
+    // Gets the raw samples of a range of antenna inputs within one data block. The inputs are stored one after another,
+    // so this is a single contiguous run of getNumSamples() samples per antenna input.
+    RawSampleSpan getSamples(unsigned block, AntennaInputRange const& antennaInputs) const;
+
+    // Tells the OS that a range of antenna inputs within a data block will be read soon, so it can start reading it in.
+    void adviseWillNeed(unsigned block, AntennaInputRange const& antennaInputs) const;
+    // Tells the OS that a range of antenna inputs within a data block won't be read again by this process.
+    void adviseDontNeed(unsigned block, AntennaInputRange const& antennaInputs) const;
+
+    SubfileView& operator=(SubfileView const&) = delete;
+    SubfileView& operator=(SubfileView&& other) noexcept;
+
+private:
+    std::shared_ptr<SubfileIndex const> _index;
+    // Start of the mapped file.
+    std::int8_t* _mapping;
+    // Size of the mapped file in bytes.
+    std::size_t _mappingSize;
+
+    // Applies madvise() to the pages covering a range of antenna inputs within a data block.
+    void _advise(unsigned block, AntennaInputRange const& antennaInputs, int advice) const;
+};
@@ -0,0 +1,28 @@
+#include "BenchmarkHelper.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+
+double timeFastestRun(std::function<void()> const& function, unsigned runs) {
+    double fastest = std::numeric_limits<double>::infinity();
+    for (unsigned i = 0; i < runs; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        function();
+        auto const end = std::chrono::steady_clock::now();
+        fastest = std::min(fastest, std::chrono::duration<double>(end - start).count());
+    }
+    return fastest;
+}
+
+void printBenchmarkResult(std::string const& name, double seconds, double items, double baselineSeconds) {
+    std::cout << "  " << std::left << std::setw(32) << name << std::right << std::fixed
+        << std::setw(10) << std::setprecision(3) << seconds * 1e3 << " ms"
+        << std::setw(12) << std::setprecision(1) << items / seconds / 1e6 << " M/s"
+        << std::setw(9) << std::setprecision(2) << baselineSeconds / seconds << "x" << std::endl;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+
+// Runs a function a number of times and gets the fastest run time, in seconds.
+// The fastest run is the one least disturbed by other activity on the system.
+double timeFastestRun(std::function<void()> const& function, unsigned runs = 5);
+
+// Outputs the result of one benchmark variant to stdout: its run time, throughput of items per second, and speedup
+// relative to a baseline run time.
+void printBenchmarkResult(std::string const& name, double seconds, double items, double baselineSeconds);
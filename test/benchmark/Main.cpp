@@ -0,0 +1,10 @@
+#include "OutputWriterBenchmark.hpp"
+#include "PFBBenchmark.hpp"
+#include "SampleConversionBenchmark.hpp"
+
+
+int main() {
+    sampleConversionBenchmark();
+    pfbBenchmark();
+    outputWriterBenchmark();
+}
@@ -0,0 +1,121 @@
+#include "OutputWriterBenchmark.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "BenchmarkHelper.hpp"
+#include "Common.hpp"
+#include "OutSignalWriter.hpp"
+
+
+// Samples in each signal written, about as many as a few seconds of a typical observation's output signal.
+static constexpr std::size_t NUM_SAMPLES = 64 * 1024 * 1024;
+// Runs of each variant, fewer than usual since each writes a large file.
+static constexpr unsigned RUNS = 3;
+
+
+// Path of the output signal file of a tile's X signal chain.
+static std::filesystem::path getSignalPath(std::string const& directory, unsigned tile) {
+    return directory + "1234567890_1234567898_" + std::to_string(tile) + "_X.bin";
+}
+
+// Flushes a file to the storage device, so the time taken includes getting the data out of the page cache.
+static void syncFile(std::filesystem::path const& path) {
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+
+void outputWriterBenchmark() {
+    std::default_random_engine randomEngine{1};
+    std::uniform_int_distribution<int> distribution{-32768, 32767};
+    std::vector<std::int16_t> signal(NUM_SAMPLES);
+    for (auto& sample : signal) {
+        sample = static_cast<std::int16_t>(distribution(randomEngine));
+    }
+    double const totalSamples = static_cast<double>(NUM_SAMPLES);
+
+    std::cout << "Output signal file writing (" << NUM_SAMPLES << " samples)" << std::endl;
+
+    // A local disk, and tmpfs (which has no device to bypass the page cache to)
+    std::vector<std::pair<std::string, std::string>> const directories{{"Disk", "/tmp/"}, {"tmpfs", "/dev/shm/"}};
+    for (auto const& [directoryName, directory] : directories) {
+        if (!std::filesystem::is_directory(directory)) {
+            std::cout << " " << directoryName << " (" << directory << ") not available" << std::endl;
+            continue;
+        }
+        std::cout << " " << directoryName << " (" << directory << ")" << std::endl;
+
+        AppConfig appConfig{"", 1234567890, 1234567898, "", directory, false};
+
+        std::vector<std::pair<std::string, OutputBackend>> const backends{
+            {"Stream", OutputBackend::stream},
+            {"Direct", OutputBackend::direct}
+        };
+        for (bool const sync : {false, true}) {
+            // Each backend is compared with the stream backend written the same way, with or without fsync
+            double baselineSeconds = 0.0;
+            for (auto const& [backendName, backend] : backends) {
+                appConfig.outputBackend = backend;
+                for (unsigned tile = 0; tile < RUNS; tile++) {
+                    std::filesystem::remove(getSignalPath(directory, tile));
+                }
+                // Each run writes a new file, for the next tile, so removing the old ones isn't timed
+                unsigned tile = 0;
+                bool failed = false;
+                double const seconds = timeFastestRun([&]() {
+                    try {
+                        outSignalWriter(signal, appConfig, {tile, 'X', false});
+                    }
+                    catch (OutSignalException const&) {
+                        failed = true;
+                    }
+                    if (sync) {
+                        syncFile(getSignalPath(directory, tile));
+                    }
+                    tile++;
+                }, RUNS);
+                for (unsigned tile = 0; tile < RUNS; tile++) {
+                    std::filesystem::remove(getSignalPath(directory, tile));
+                }
+                std::string const variant = backendName + (sync ? " + fsync" : "");
+                if (failed) {
+                    std::cout << "  " << variant << " failed to write the file" << std::endl;
+                    continue;
+                }
+                if (backend == OutputBackend::stream) {
+                    baselineSeconds = seconds;
+                }
+                printBenchmarkResult(variant, seconds, totalSamples, baselineSeconds);
+            }
+        }
+
+        // Sanity check of the direct backend's output, which also reports whether O_DIRECT was used at all
+        auto const path = getSignalPath(directory, 0);
+        bool direct = false;
+        try {
+            direct = writeAlignedSignalFile(path, signal);
+        }
+        catch (OutSignalException const&) {}
+        std::error_code error;
+        if (std::filesystem::file_size(path, error) != NUM_SAMPLES * sizeof(std::int16_t)) {
+            std::cout << "  Direct output file is the wrong size!" << std::endl;
+        }
+        std::cout << "  O_DIRECT " << (direct ? "used" : "not supported, fell back to buffered writes") << std::endl;
+        std::filesystem::remove(path);
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+
+// Benchmark of the output signal file backends (OutSignalWriter.hpp and OutSignalWriter.cpp): the original file stream
+// writer against the preallocated, aligned, O_DIRECT writer, on a local disk and on tmpfs.
+void outputWriterBenchmark();
@@ -0,0 +1,85 @@
+#include "PFBBenchmark.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "ChannelFIRFilter.hpp"
+#include "OverlapSaveFilter.hpp"
+#include "SignalProcessing.hpp"
+
+
+// Remapped channels in the signal, about as many as a typical remapping of 24 coarse channels has.
+static constexpr unsigned NUM_CHANNELS = 129;
+// Samples per channel of the signals filtered, from a few overlap-save segments of the longest filter up to many.
+static constexpr std::size_t NUM_BLOCKS[] = {4096, 16384, 65536};
+// Filter lengths (taps per channel) filtered with.
+static constexpr unsigned NUM_TAPS[] = {8, 12, 16, 24, 32, 48, 64, 96, 128};
+
+
+void pfbBenchmark() {
+    std::default_random_engine randomEngine{1};
+    std::uniform_real_distribution<float> distribution{-100.0f, 100.0f};
+    std::vector<std::complex<float>> data;
+
+    for (std::size_t const numBlocks : NUM_BLOCKS) {
+        std::vector<std::complex<float>> signal(numBlocks * NUM_CHANNELS);
+        for (auto& sample : signal) {
+            sample = {distribution(randomEngine), distribution(randomEngine)};
+        }
+        double const totalSamples = static_cast<double>(numBlocks) * NUM_CHANNELS;
+
+        std::cout << "Inverse PFB filter (" << NUM_CHANNELS << " channels x " << numBlocks << " samples)" << std::endl;
+
+        std::optional<unsigned> crossover;
+        for (unsigned const numTaps : NUM_TAPS) {
+            std::vector<float> taps(std::size_t{numTaps} * NUM_CHANNELS);
+            for (auto& tap : taps) {
+                tap = distribution(randomEngine) / 100.0f;
+            }
+            std::vector<std::complex<float>> const complexTaps(taps.begin(), taps.end());
+            std::cout << " " << numTaps << " taps" << std::endl;
+
+            // Each run filters a fresh copy, since the filters work in place.
+            ChannelFIRFilter const firFilter{taps, NUM_CHANNELS};
+            double const firSeconds = timeFastestRun([&]() {
+                data = signal;
+                firFilter.apply(data.data(), numBlocks);
+            });
+            printBenchmarkResult("Channel FIR", firSeconds, totalSamples, firSeconds);
+            auto const firResult = data;
+
+            OverlapSaveFilter overlapSaveFilter{complexTaps, NUM_CHANNELS};
+            double const overlapSaveSeconds = timeFastestRun([&]() {
+                data = signal;
+                overlapSaveFilter.apply(data.data(), numBlocks);
+            });
+            printBenchmarkResult("Overlap-save (segment " + std::to_string(overlapSaveFilter.getSegmentLength()) + ")",
+                                 overlapSaveSeconds, totalSamples, firSeconds);
+            // Sanity check against the FIR filter, which also means none of the results can be optimised out.
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                if (std::abs(data[i] - firResult[i]) > 1e-2f * (1.0f + std::abs(firResult[i]))) {
+                    std::cout << "  Overlap-save output doesn't match the FIR filter!" << std::endl;
+                    break;
+                }
+            }
+
+            if (!crossover.has_value() && overlapSaveSeconds < firSeconds) {
+                crossover = numTaps;
+            }
+        }
+
+        if (crossover.has_value()) {
+            std::cout << " Overlap-save is faster from " << crossover.value() << " taps";
+        }
+        else {
+            std::cout << " Overlap-save is never faster";
+        }
+        std::cout << " for " << numBlocks << " samples" << std::endl << std::endl;
+    }
+}
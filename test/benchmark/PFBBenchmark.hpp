@@ -0,0 +1,6 @@
+#pragma once
+
+
+// Benchmark of the inverse PFB filter engines (ChannelFIRFilter and OverlapSaveFilter) over a range of filter
+// lengths and signal lengths, to find where overlap-save is faster (and so whether to use --overlap-save).
+void pfbBenchmark();
@@ -0,0 +1,77 @@
+#include "SampleConversionBenchmark.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkHelper.hpp"
+#include "SampleConversion.hpp"
+
+
+// Samples per antenna input in one data block of a signal file.
+static constexpr std::size_t NUM_SAMPLES = 64000;
+// Number of times a block is converted per timed run, to get run times well above the clock resolution.
+static constexpr unsigned REPEATS = 1000;
+
+
+void sampleConversionBenchmark() {
+    std::default_random_engine randomEngine{1};
+    std::uniform_int_distribution<int> distribution{-128, 127};
+    std::vector<std::int8_t> datablock(NUM_SAMPLES * 2);
+    for (auto& value : datablock) {
+        value = static_cast<std::int8_t>(distribution(randomEngine));
+    }
+    double const totalSamples = static_cast<double>(NUM_SAMPLES) * REPEATS;
+
+    std::cout << "Sample conversion (" << NUM_SAMPLES << " samples x " << REPEATS << ")" << std::endl;
+
+    // The original conversion loop from readInputDataFile().
+    std::vector<std::complex<float>> datavalues;
+    datavalues.reserve(NUM_SAMPLES);
+    double const baselineSeconds = timeFastestRun([&]() {
+        for (unsigned repeat = 0; repeat < REPEATS; ++repeat) {
+            datavalues.clear();
+            for (std::size_t j = 0; j < datablock.size();) {
+                float real = static_cast<float>(datablock.at(j));
+                j++;
+                float imag = static_cast<float>(datablock.at(j));
+                j++;
+                datavalues.push_back({real, imag});
+            }
+        }
+    });
+    printBenchmarkResult("Original loop", baselineSeconds, totalSamples, baselineSeconds);
+
+    std::vector<std::pair<std::string, SampleConversionISA>> const isas{
+        {"Scalar", SampleConversionISA::SCALAR},
+        {"AVX2", SampleConversionISA::AVX2},
+        {"AVX-512", SampleConversionISA::AVX512}
+    };
+    // Contiguous output as used when reading signal files, and strided output for interleaving antenna inputs.
+    for (std::size_t stride : {1, 4}) {
+        std::vector<std::complex<float>> output(NUM_SAMPLES * stride);
+        for (auto const& [name, isa] : isas) {
+            std::string const variant = name + (stride == 1 ? "" : " (stride " + std::to_string(stride) + ")");
+            if (!isSampleConversionISASupported(isa)) {
+                std::cout << "  " << variant << " not supported" << std::endl;
+                continue;
+            }
+            double const seconds = timeFastestRun([&]() {
+                for (unsigned repeat = 0; repeat < REPEATS; ++repeat) {
+                    convertSamples(datablock.data(), NUM_SAMPLES, output.data(), stride, isa);
+                }
+            });
+            printBenchmarkResult(variant, seconds, totalSamples, baselineSeconds);
+            // Sanity check against the original loop, which also means none of the results can be optimised out.
+            if (stride == 1 && output != datavalues) {
+                std::cout << "  " << variant << " output doesn't match the original loop!" << std::endl;
+            }
+        }
+    }
+    std::cout << std::endl;
+}
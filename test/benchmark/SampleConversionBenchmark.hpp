@@ -0,0 +1,6 @@
+#pragma once
+
+
+// Benchmark of the raw signal sample conversion module (SampleConversion.hpp and SampleConversion.cpp) against the
+// original byte-at-a-time conversion loop.
+void sampleConversionBenchmark();
@@ -0,0 +1,328 @@
+#include "AntennaInputReaderTest.hpp"
+
+#include "ReadInputFileTest.hpp"
+#include "../../src/AntennaInputReader.hpp"
+#include "../../src/ReadInputFile.hpp"
+#include "../../src/SubfileIndex.hpp"
+#include "../TestHelper.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+static std::string const TEST_INPUT_DIRECTORY = "/tmp/antenna_input_reader/";
+
+
+// Signal files exist for channels 109, 110, 112 and 113, but not 111 or 114.
+static AppConfig testAppConfig(bool ignoreErrors) {
+    return {TEST_INPUT_DIRECTORY, 1294797712, 1294797712, "", "", ignoreErrors};
+}
+
+static AntennaConfig testAntennaConfig(std::set<unsigned> frequencyChannels) {
+    return {
+        {{11, 'X', true}, {11, 'Y', false}, {12, 'X', false}, {12, 'Y', true},
+         {13, 'X', false}, {13, 'Y', false}, {14, 'X', false}, {14, 'Y', true}},
+        frequencyChannels
+    };
+}
+
+// Checks that a batch has the raw signals of each antenna input in the range, from each of the channels.
+static void checkBatchSignals(AntennaInputBatch const& batch, AntennaInputRange const& range,
+                              std::vector<unsigned> const& channels) {
+    for (std::size_t c = 0; c < channels.size(); ++c) {
+        auto const expected = readRawInputDataFile(
+            getSignalFilePath(testAppConfig(false), channels[c]), range, 8);
+        for (unsigned i = range.begin; i <= range.end; ++i) {
+            auto const& signals = batch.signals.at(i - batch.antennaInputs.begin);
+            testAssert(signals.getNumChannels() == channels.size());
+            auto const actual = signals.getChannel(c);
+            auto const& expectedChannel = expected.at(i - range.begin);
+            testAssert(actual.size() == expectedChannel.size());
+            for (std::size_t j = 0; j < actual.size(); ++j) {
+                testAssert(actual[j] == expectedChannel[j]);
+            }
+        }
+    }
+}
+
+
+class AntennaInputReaderTest : public StatelessTestModuleImpl {
+public:
+    AntennaInputReaderTest();
+    ~AntennaInputReaderTest();
+};
+
+
+AntennaInputReaderTest::AntennaInputReaderTest() : StatelessTestModuleImpl{{
+    {"getSignalFilePath()", []() {
+        auto const actual = getSignalFilePath(testAppConfig(false), 109);
+        testAssert(actual == std::filesystem::path{TEST_INPUT_DIRECTORY + "1294797712_1294797712_109.sub"});
+    }},
+    {"readAntennaInputBatch(): All channels", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        auto const actual = readAntennaInputBatch(testAppConfig(false), antennaConfig, {1, 2});
+        testAssert((actual.antennaInputs == AntennaInputRange{1, 2}));
+        testAssert(actual.signals.size() == 2);
+        testAssert((actual.usedChannels == std::set<unsigned>{109, 110}));
+        checkBatchSignals(actual, {1, 2}, {109, 110});
+    }},
+    {"readAntennaInputBatch(): Flagged antenna inputs at the ends aren't read", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        auto const actual = readAntennaInputBatch(testAppConfig(false), antennaConfig, {0, 3});
+        testAssert(actual.signals.size() == 4);
+        testAssert(actual.signals.at(0).empty());
+        testAssert(actual.signals.at(3).empty());
+        checkBatchSignals(actual, {1, 2}, {109, 110});
+    }},
+    {"readAntennaInputBatch(): Only flagged antenna inputs", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        auto const actual = readAntennaInputBatch(testAppConfig(false), antennaConfig, {7, 7});
+        testAssert(actual.signals.size() == 1);
+        testAssert(actual.signals.at(0).empty());
+        testAssert(actual.usedChannels.empty());
+    }},
+    {"readAntennaInputBatch(): Missing channel, ignoring errors", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110, 111});
+        auto const actual = readAntennaInputBatch(testAppConfig(true), antennaConfig, {4, 6});
+        testAssert((actual.usedChannels == std::set<unsigned>{109, 110}));
+        checkBatchSignals(actual, {4, 6}, {109, 110});
+    }},
+    {"readAntennaInputBatch(): Missing channel, not ignoring errors", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110, 111});
+        try {
+            readAntennaInputBatch(testAppConfig(false), antennaConfig, {4, 6});
+            failTest();
+        }
+        catch (ReadInputDataException const& e) {
+            testAssert(std::string{e.what()}.find("1294797712_1294797712_111.sub") != std::string::npos);
+        }
+    }},
+    {"readAntennaInputBatch(): Many channels, ignoring errors", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110, 111, 112, 113, 114});
+        auto const actual = readAntennaInputBatch(testAppConfig(true), antennaConfig, {1, 6});
+        testAssert((actual.usedChannels == std::set<unsigned>{109, 110, 112, 113}));
+        checkBatchSignals(actual, {1, 6}, {109, 110, 112, 113});
+    }},
+    {"readAntennaInputBatch(): Many channels, not ignoring errors", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110, 111, 112, 113, 114});
+        try {
+            readAntennaInputBatch(testAppConfig(false), antennaConfig, {1, 6});
+            failTest();
+        }
+        catch (ReadInputDataException const& e) {
+            // The first channel which couldn't be read is reported
+            testAssert(std::string{e.what()}.find("1294797712_1294797712_111.sub") != std::string::npos);
+        }
+    }},
+    {"getAntennaInputRawSize()", []() {
+        // 160 blocks of 30 samples of 2 bytes, for each channel
+        auto const actual = getAntennaInputRawSize(testAppConfig(true), testAntennaConfig({109, 110, 111}));
+        testAssert(actual == 3 * 160 * 30 * 2);
+        testAssert(getAntennaInputRawSize(testAppConfig(true), testAntennaConfig({111})) == 0);
+    }},
+    {"planReadAhead(): Budget fits full batches", []() {
+        auto const actual = planReadAhead(1000, 100, 2, 2);
+        testAssert(actual.batchSize == 2);
+        testAssert(actual.prefetchDepth == 2);
+    }},
+    {"planReadAhead(): Smaller batches before less prefetching", []() {
+        auto const actual = planReadAhead(300, 100, 2, 2);
+        testAssert(actual.batchSize == 1);
+        testAssert(actual.prefetchDepth == 2);
+    }},
+    {"planReadAhead(): Less prefetching", []() {
+        auto const actual = planReadAhead(250, 100, 4, 2);
+        testAssert(actual.batchSize == 1);
+        testAssert(actual.prefetchDepth == 1);
+    }},
+    {"planReadAhead(): Budget smaller than an antenna input", []() {
+        auto const actual = planReadAhead(50, 100, 1, 2);
+        testAssert(actual.batchSize == 1);
+        testAssert(actual.prefetchDepth == 0);
+    }},
+    {"planReadAhead(): Larger maximum batch size", []() {
+        auto const actual = planReadAhead(1000, 100, 1, 4);
+        testAssert(actual.batchSize == 4);
+        testAssert(actual.prefetchDepth == 1);
+        auto const unknownSize = planReadAhead(50, 0, 1, 4);
+        testAssert(unknownSize.batchSize == 4);
+    }},
+    {"planReadAhead(): Whole node range in one batch", []() {
+        // Only limited by the budget, so each signal file is read once for all of the node's antenna inputs
+        auto const actual = planReadAhead(10000, 100, 1, 40);
+        testAssert(actual.batchSize == 40);
+        testAssert(actual.prefetchDepth == 1);
+        testAssert(planReadAhead(10000, 100, 0, 40).batchSize == 40);
+    }},
+    {"planReadAhead(): Minimum batch size", []() {
+        // Less prefetching rather than batches smaller than the minimum
+        auto const actual = planReadAhead(500, 100, 2, 40, 4);
+        testAssert(actual.batchSize == 5);
+        testAssert(actual.prefetchDepth == 0);
+        // Kept even if it doesn't fit, but never larger than the maximum
+        testAssert(planReadAhead(50, 100, 1, 40, 4).batchSize == 4);
+        testAssert(planReadAhead(50, 100, 1, 3, 4).batchSize == 3);
+    }},
+    {"planReadAhead(): Unknown antenna input size", []() {
+        auto const actual = planReadAhead(50, 0, 3, 2);
+        testAssert(actual.batchSize == 2);
+        testAssert(actual.prefetchDepth == 3);
+    }},
+    {"splitAntennaInputRange()", []() {
+        auto const actual = splitAntennaInputRange({3, 9}, 3);
+        std::vector<AntennaInputRange> const expected{{3, 5}, {6, 8}, {9, 9}};
+        testAssert(actual == expected);
+        testAssert((splitAntennaInputRange({4, 4}, 2) == std::vector<AntennaInputRange>{{4, 4}}));
+    }},
+    {"splitAntennaInputChunks()", []() {
+        std::vector<AntennaInputRange> const chunks{{6, 9}, {0, 1}, {12, 12}};
+        unsigned chunkCalls = 0;
+        auto nextBatch = splitAntennaInputChunks([&chunks, &chunkCalls]() -> std::optional<AntennaInputRange> {
+            if (chunkCalls < chunks.size()) {
+                return chunks.at(chunkCalls++);
+            }
+            return std::nullopt;
+        }, 3);
+        std::vector<AntennaInputRange> actual;
+        std::vector<unsigned> actualChunkCalls;
+        while (auto const batch = nextBatch()) {
+            actual.push_back(batch.value());
+            actualChunkCalls.push_back(chunkCalls);
+        }
+        std::vector<AntennaInputRange> const expected{{6, 8}, {9, 9}, {0, 1}, {12, 12}};
+        testAssert(actual == expected);
+        // The next chunk is only asked for once the batches of the last one are used up
+        testAssert((actualChunkCalls == std::vector<unsigned>{1, 1, 2, 3}));
+    }},
+    {"takeAntennaInputBatch()", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        auto batch = readAntennaInputBatch(testAppConfig(false), antennaConfig, {1, 6});
+        batch.readSeconds = 6.0;
+        auto const actual = takeAntennaInputBatch(batch, {4, 5});
+        testAssert((actual.antennaInputs == AntennaInputRange{4, 5}));
+        testAssert(actual.signals.size() == 2);
+        testAssert((actual.usedChannels == std::set<unsigned>{109, 110}));
+        checkBatchSignals(actual, {4, 5}, {109, 110});
+        // 2 of the 6 antenna inputs read (flagged ones in the middle of the batch are read too)
+        testAssert(actual.readSeconds == 2.0);
+        testAssert(batch.signals.at(3).empty());
+        testAssert(batch.signals.at(4).empty());
+        testAssert(!batch.signals.at(0).empty());
+    }},
+    {"takeAntennaInputBatch(): Range outside of the batch", []() {
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        auto batch = readAntennaInputBatch(testAppConfig(false), antennaConfig, {1, 6});
+        try {
+            takeAntennaInputBatch(batch, {5, 7});
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+    }},
+    {"AntennaInputPrefetcher: Batches in order", []() {
+        auto const appConfig = testAppConfig(false);
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        for (unsigned prefetchDepth = 0; prefetchDepth <= 3; ++prefetchDepth) {
+            AntennaInputPrefetcher prefetcher{appConfig, antennaConfig, splitAntennaInputRange({0, 7}, 2),
+                                              prefetchDepth};
+            for (unsigned begin = 0; begin < 8; begin += 2) {
+                auto const batch = prefetcher.next();
+                testAssert(batch.has_value());
+                testAssert((batch->antennaInputs == AntennaInputRange{begin, begin + 1}));
+            }
+            testAssert(!prefetcher.next().has_value());
+            testAssert(!prefetcher.next().has_value());
+        }
+    }},
+    {"AntennaInputPrefetcher: Batch contents", []() {
+        auto const appConfig = testAppConfig(false);
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        AntennaInputPrefetcher prefetcher{appConfig, antennaConfig, std::vector<AntennaInputRange>{{4, 6}}, 1};
+        auto const actual = prefetcher.next();
+        testAssert(actual.has_value());
+        testAssert((actual->usedChannels == std::set<unsigned>{109, 110}));
+        checkBatchSignals(actual.value(), {4, 6}, {109, 110});
+    }},
+    {"AntennaInputPrefetcher: Batch reader", []() {
+        std::vector<AntennaInputRange> readBatches;
+        AntennaInputPrefetcher prefetcher{
+            splitAntennaInputChunks([range = std::optional<AntennaInputRange>{{2, 6}}]() mutable {
+                return std::exchange(range, std::nullopt);
+            }, 2),
+            [&readBatches](AntennaInputRange const& batch) {
+                readBatches.push_back(batch);
+                return AntennaInputBatch{batch, std::vector<AntennaInputSamples>(batch.end - batch.begin + 1), {}};
+            },
+            1};
+        for (unsigned begin = 2; begin <= 6; begin += 2) {
+            auto const batch = prefetcher.next();
+            testAssert(batch.has_value());
+            testAssert((batch->antennaInputs == AntennaInputRange{begin, std::min(begin + 1, 6u)}));
+        }
+        testAssert(!prefetcher.next().has_value());
+        testAssert((readBatches == std::vector<AntennaInputRange>{{2, 3}, {4, 5}, {6, 6}}));
+    }},
+    {"AntennaInputPrefetcher: Read error", []() {
+        auto const appConfig = testAppConfig(false);
+        auto const antennaConfig = testAntennaConfig({109, 111});
+        AntennaInputPrefetcher prefetcher{appConfig, antennaConfig, splitAntennaInputRange({0, 7}, 2), 2};
+        try {
+            prefetcher.next();
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+        // Nothing is read after an error
+        testAssert(!prefetcher.next().has_value());
+    }},
+    {"AntennaInputPrefetcher: Error from the batch source", []() {
+        auto const appConfig = testAppConfig(false);
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        unsigned calls = 0;
+        AntennaInputPrefetcher prefetcher{appConfig, antennaConfig,
+            [&calls]() -> std::optional<AntennaInputRange> {
+                if (calls++ == 0) {
+                    return AntennaInputRange{0, 1};
+                }
+                throw std::runtime_error{"No more batches"};
+            },
+            1};
+        testAssert(prefetcher.next().has_value());
+        try {
+            prefetcher.next();
+            failTest();
+        }
+        catch (std::runtime_error const&) {}
+    }},
+    {"AntennaInputPrefetcher: Destroyed before all batches are read", []() {
+        auto const appConfig = testAppConfig(false);
+        auto const antennaConfig = testAntennaConfig({109, 110});
+        AntennaInputPrefetcher prefetcher{appConfig, antennaConfig, splitAntennaInputRange({0, 7}, 1), 2};
+        testAssert(prefetcher.next().has_value());
+    }}
+}} {
+    std::filesystem::create_directory(TEST_INPUT_DIRECTORY);
+    writeSmallInputDataFile(TEST_INPUT_DIRECTORY + "1294797712_1294797712_109.sub", 4, 30);
+    writeSmallInputDataFile(TEST_INPUT_DIRECTORY + "1294797712_1294797712_110.sub", 4, 30);
+    writeSmallInputDataFile(TEST_INPUT_DIRECTORY + "1294797712_1294797712_112.sub", 4, 30);
+    writeSmallInputDataFile(TEST_INPUT_DIRECTORY + "1294797712_1294797712_113.sub", 4, 30);
+}
+
+AntennaInputReaderTest::~AntennaInputReaderTest() {
+    std::filesystem::remove_all(TEST_INPUT_DIRECTORY);
+    clearSubfileIndexCache();
+}
+
+
+TestModule antennaInputReaderTest() {
+    return {
+        "Antenna input reader unit test",
+        []() { return std::make_unique<AntennaInputReaderTest>(); }
+    };
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "../TestHelper.hpp"
+
+// Unit test for reading antenna input batches ahead of processing (AntennaInputReader.hpp and AntennaInputReader.cpp).
+TestModule antennaInputReaderTest();
@@ -0,0 +1,100 @@
+#include "AntennaInputSamplesTest.hpp"
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "AntennaInputSamples.hpp"
+#include "TestHelper.hpp"
+
+
+class AntennaInputSamplesTest : public StatelessTestModuleImpl {
+public:
+    AntennaInputSamplesTest();
+};
+
+
+AntennaInputSamplesTest::AntennaInputSamplesTest() : StatelessTestModuleImpl{{
+    {"Empty", []() {
+        AntennaInputSamples const samples;
+        testAssert(samples.empty());
+        testAssert(samples.getNumChannels() == 0);
+        testAssert(samples.getNumSamples() == 0);
+    }},
+    {"Add channels", []() {
+        AntennaInputSamples samples;
+        samples.addChannel({1, 2, 3, 4, 5, 6});
+        samples.addChannel({-1, -2, -3, -4, -5, -6});
+        testAssert(!samples.empty());
+        testAssert(samples.getNumChannels() == 2);
+        testAssert(samples.getNumSamples() == 3);
+        auto const channel = samples.getChannel(1);
+        testAssert(channel.size() == 6);
+        testAssert(channel[0] == -1);
+        testAssert(channel[5] == -6);
+    }},
+    {"Add channel with odd number of values", []() {
+        AntennaInputSamples samples;
+        try {
+            samples.addChannel({1, 2, 3});
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"Add channel with different number of samples", []() {
+        AntennaInputSamples samples;
+        samples.addChannel({1, 2, 3, 4});
+        try {
+            samples.addChannel({1, 2});
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        testAssert(samples.getNumChannels() == 1);
+    }},
+    {"Convert", []() {
+        AntennaInputSamples samples;
+        samples.addChannel({0, 0, 0, 0, 0, 0});
+        samples.addChannel({10, -10, 20, -20, 30, -30});
+        std::vector<std::complex<float>> output(4, {-1.0f, -1.0f});
+        samples.convert(1, 1, 2, output.data(), 2);
+        std::vector<std::complex<float>> const expected{
+            {20.0f, -20.0f}, {-1.0f, -1.0f}, {30.0f, -30.0f}, {-1.0f, -1.0f}
+        };
+        testAssert(output == expected);
+    }},
+    {"Convert with scaling and conjugation", []() {
+        AntennaInputSamples samples;
+        samples.addChannel({10, -10, 20, -20, 30, -30});
+        std::vector<std::complex<float>> output(3, {-1.0f, -1.0f});
+        samples.convert(0, 0, 3, output.data(), 1, 2.0f, true);
+        std::vector<std::complex<float>> const expected{
+            {20.0f, 20.0f}, {40.0f, 40.0f}, {60.0f, 60.0f}
+        };
+        testAssert(output == expected);
+    }},
+    {"Convert out of range", []() {
+        AntennaInputSamples samples;
+        samples.addChannel({1, 2, 3, 4});
+        std::vector<std::complex<float>> output(4);
+        try {
+            samples.convert(1, 0, 1, output.data());
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+        try {
+            samples.convert(0, 1, 2, output.data());
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+    }}
+}} {}
+
+
+TestModule antennaInputSamplesTest() {
+    return {
+        "Raw antenna input sample store unit test",
+        []() { return std::make_unique<AntennaInputSamplesTest>(); }
+    };
+}
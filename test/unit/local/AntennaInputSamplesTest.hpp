@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the raw antenna input sample store (AntennaInputSamples.hpp and AntennaInputSamples.cpp).
+TestModule antennaInputSamplesTest();
@@ -0,0 +1,221 @@
+#include "ChannelDecompositionTest.hpp"
+
+#include "ReadInputFileTest.hpp"
+#include "../../src/ChannelDecomposition.hpp"
+#include "../../src/ReadInputFile.hpp"
+#include "../../src/SubfileIndex.hpp"
+#include "../../src/SubfileView.hpp"
+#include "../TestHelper.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+static std::string const TEST_INPUT_DIRECTORY = "/tmp/channel_decomposition/";
+
+// 8 antenna inputs, 30 samples per block.
+static std::string getTestFileName(unsigned channel) {
+    return TEST_INPUT_DIRECTORY + std::to_string(channel) + ".sub";
+}
+
+// Simulates the exchange of every channel between nodes, in chunks of blocksPerChunk blocks, and checks each node ends
+// up with every channel of its own antenna inputs. The antenna inputs in skipped aren't kept.
+static void checkExchange(std::set<unsigned> const& channels,
+                          std::vector<std::optional<AntennaInputRange>> const& nodeAntennaInputs,
+                          unsigned blocksPerChunk, std::set<unsigned> const& skipped = {}) {
+    auto const numNodes = static_cast<unsigned>(nodeAntennaInputs.size());
+    auto const nodeChannels = assignNodeChannels(numNodes, channels);
+    std::vector<std::vector<SubfileView>> nodeViews(numNodes);
+    for (unsigned node = 0; node < numNodes; ++node) {
+        for (auto const channel : nodeChannels.at(node)) {
+            nodeViews.at(node).emplace_back(getTestFileName(channel), 8);
+        }
+    }
+
+    std::vector<std::vector<std::vector<std::vector<std::int8_t>>>> nodeSignals(numNodes);
+    for (unsigned node = 0; node < numNodes; ++node) {
+        if (nodeAntennaInputs.at(node).has_value()) {
+            for (unsigned i = nodeAntennaInputs.at(node)->begin; i <= nodeAntennaInputs.at(node)->end; ++i) {
+                nodeSignals.at(node).emplace_back();
+                if (skipped.count(i) == 0) {
+                    nodeSignals.at(node).back().assign(channels.size(), std::vector<std::int8_t>(160 * 60));
+                }
+            }
+        }
+    }
+
+    for (unsigned beginBlock = 0; beginBlock < 160; beginBlock += blocksPerChunk) {
+        auto const endBlock = std::min(beginBlock + blocksPerChunk, 160u);
+        std::vector<ChannelExchangeChunk> chunks;
+        for (unsigned node = 0; node < numNodes; ++node) {
+            std::vector<SubfileView const*> views;
+            for (auto const& view : nodeViews.at(node)) {
+                views.push_back(&view);
+            }
+            chunks.push_back(packChannelChunk(views, beginBlock, endBlock, nodeAntennaInputs));
+            testAssert(chunks.back().nodeSizes.size() == numNodes);
+        }
+        // Each node receives its part of every node's chunk, in node order
+        for (unsigned destination = 0; destination < numNodes; ++destination) {
+            std::vector<std::int8_t> received;
+            for (auto const& chunk : chunks) {
+                std::size_t offset = 0;
+                for (unsigned node = 0; node < destination; ++node) {
+                    offset += chunk.nodeSizes.at(node);
+                }
+                received.insert(received.end(), chunk.data.begin() + offset,
+                                chunk.data.begin() + offset + chunk.nodeSizes.at(destination));
+            }
+            unpackChannelChunk(received, beginBlock, endBlock, 60, channels.size(), nodeSignals.at(destination));
+        }
+    }
+
+    for (unsigned node = 0; node < numNodes; ++node) {
+        if (!nodeAntennaInputs.at(node).has_value()) {
+            testAssert(nodeSignals.at(node).empty());
+            continue;
+        }
+        auto const range = nodeAntennaInputs.at(node).value();
+        std::size_t c = 0;
+        for (auto const channel : channels) {
+            auto const expected = readRawInputDataFile(getTestFileName(channel), range, 8);
+            for (unsigned i = range.begin; i <= range.end; ++i) {
+                auto const& signals = nodeSignals.at(node).at(i - range.begin);
+                if (skipped.count(i) > 0) {
+                    testAssert(signals.empty());
+                }
+                else {
+                    testAssert(signals.at(c) == expected.at(i - range.begin));
+                }
+            }
+            ++c;
+        }
+    }
+}
+
+
+class ChannelDecompositionTest : public StatelessTestModuleImpl {
+public:
+    ChannelDecompositionTest();
+    ~ChannelDecompositionTest();
+};
+
+
+ChannelDecompositionTest::ChannelDecompositionTest() : StatelessTestModuleImpl{{
+    {"assignNodeChannels()", []() {
+        auto const actual = assignNodeChannels(3, {109, 110, 111, 112, 113});
+        std::vector<std::set<unsigned>> const expected{{109, 110}, {111, 112}, {113}};
+        testAssert(actual == expected);
+    }},
+    {"assignNodeChannels(): More nodes than channels", []() {
+        auto const actual = assignNodeChannels(3, {57, 131});
+        std::vector<std::set<unsigned>> const expected{{57}, {131}, {}};
+        testAssert(actual == expected);
+    }},
+    {"assignNodeChannels(): No channels", []() {
+        testAssert((assignNodeChannels(2, {}) == std::vector<std::set<unsigned>>(2)));
+    }},
+    {"assignNodeChannels(): Invalid number of nodes", []() {
+        try {
+            assignNodeChannels(0, {109});
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"packChannelChunk()", []() {
+        SubfileView const view109{getTestFileName(109), 8};
+        SubfileView const view110{getTestFileName(110), 8};
+        auto const actual = packChannelChunk({&view109, &view110}, 2, 5, {{{0, 2}}, std::nullopt, {{3, 7}}});
+        testAssert((actual.nodeSizes == std::vector<std::size_t>{2 * 3 * 3 * 60, 0, 2 * 3 * 5 * 60}));
+        testAssert(actual.data.size() == 2 * 3 * 8 * 60);
+        // Channel 110, block 3, antenna inputs 3 to 7 for node 2
+        auto const expected = view110.getSamples(3, AntennaInputRange{3, 7});
+        std::size_t const offset = 2 * 3 * 3 * 60 + (1 * 3 + 1) * 5 * 60;
+        testAssert((std::vector<std::int8_t>(actual.data.begin() + offset, actual.data.begin() + offset + 5 * 60) ==
+                    std::vector<std::int8_t>(expected.begin(), expected.end())));
+    }},
+    {"packChannelChunk(): No signal files", []() {
+        auto const actual = packChannelChunk({}, 0, 160, {{{0, 7}}, std::nullopt});
+        testAssert(actual.data.empty());
+        testAssert((actual.nodeSizes == std::vector<std::size_t>{0, 0}));
+    }},
+    {"packChannelChunk(): Blocks outside of the file", []() {
+        SubfileView const view{getTestFileName(109), 8};
+        try {
+            packChannelChunk({&view}, 150, 161, {{{0, 7}}});
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+    }},
+    {"unpackChannelChunk(): Wrong data size", []() {
+        std::vector<std::vector<std::vector<std::int8_t>>> signals(2, {std::vector<std::int8_t>(160 * 60)});
+        try {
+            unpackChannelChunk(std::vector<std::int8_t>(2 * 2 * 60 + 1), 0, 2, 60, 1, signals);
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"splitChannelExchangeGroups()", []() {
+        auto const actual = splitChannelExchangeGroups({{{0, 5}}, std::nullopt, {{6, 7}}}, 4);
+        std::vector<std::vector<std::optional<AntennaInputRange>>> const expected{
+            {{{0, 3}}, std::nullopt, {{6, 7}}},
+            {{{4, 5}}, std::nullopt, std::nullopt}
+        };
+        testAssert(actual == expected);
+    }},
+    {"splitChannelExchangeGroups(): Group larger than the antenna inputs", []() {
+        auto const actual = splitChannelExchangeGroups({{{4, 7}}, {{8, 9}}}, 4294967295u);
+        std::vector<std::vector<std::optional<AntennaInputRange>>> const expected{{{{4, 7}}, {{8, 9}}}};
+        testAssert(actual == expected);
+    }},
+    {"splitChannelExchangeGroups(): No antenna inputs", []() {
+        auto const actual = splitChannelExchangeGroups({std::nullopt, std::nullopt}, 2);
+        std::vector<std::vector<std::optional<AntennaInputRange>>> const expected{{std::nullopt, std::nullopt}};
+        testAssert(actual == expected);
+    }},
+    {"splitChannelExchangeGroups(): Invalid group size", []() {
+        try {
+            splitChannelExchangeGroups({{{0, 1}}}, 0);
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"Exchange: Single node", []() {
+        checkExchange({109, 110, 111, 112}, {{{0, 7}}}, 160);
+    }},
+    {"Exchange: Several nodes", []() {
+        checkExchange({109, 110, 111, 112}, {{{0, 3}}, {{4, 5}}, {{6, 7}}}, 64);
+    }},
+    {"Exchange: Nodes without antenna inputs or channels", []() {
+        checkExchange({110, 112}, {{{0, 5}}, std::nullopt, {{6, 7}}, std::nullopt}, 1);
+    }},
+    {"Exchange: Skipped antenna inputs", []() {
+        checkExchange({109, 111}, {{{0, 1}}, {{2, 7}}}, 100, {1, 4, 5});
+    }}
+}} {
+    std::filesystem::create_directory(TEST_INPUT_DIRECTORY);
+    for (unsigned channel = 109; channel <= 112; ++channel) {
+        writeSmallInputDataFile(getTestFileName(channel), 4, 30);
+    }
+}
+
+ChannelDecompositionTest::~ChannelDecompositionTest() {
+    std::filesystem::remove_all(TEST_INPUT_DIRECTORY);
+    clearSubfileIndexCache();
+}
+
+
+TestModule channelDecompositionTest() {
+    return {
+        "Channel decomposition unit test",
+        []() { return std::make_unique<ChannelDecompositionTest>(); }
+    };
+}
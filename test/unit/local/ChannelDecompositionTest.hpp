@@ -0,0 +1,6 @@
+#pragma once
+
+#include "../TestHelper.hpp"
+
+// Unit test for reading antenna inputs by channel (ChannelDecomposition.hpp and ChannelDecomposition.cpp).
+TestModule channelDecompositionTest();
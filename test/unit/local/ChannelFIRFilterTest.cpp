@@ -0,0 +1,119 @@
+#include "ChannelFIRFilterTest.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "ChannelFIRFilter.hpp"
+#include "TestHelper.hpp"
+
+
+static std::vector<std::complex<float>> generateSignal(std::size_t numValues) {
+    // Small integers so every sum is exact, and the results can be compared exactly
+    std::uniform_int_distribution<int> distribution{-8, 8};
+    std::vector<std::complex<float>> signal(numValues);
+    for (auto& value : signal) {
+        value = {static_cast<float>(distribution(testRandomEngine)), static_cast<float>(distribution(testRandomEngine))};
+    }
+    return signal;
+}
+
+static std::vector<float> generateTaps(std::size_t numValues) {
+    std::uniform_int_distribution<int> distribution{-4, 4};
+    std::vector<float> taps(numValues);
+    for (auto& tap : taps) {
+        tap = static_cast<float>(distribution(testRandomEngine));
+    }
+    return taps;
+}
+
+// Straightforward implementation of the filter, for comparison.
+static std::vector<std::complex<float>> referenceFilter(std::vector<std::complex<float>> const& signal,
+                                                        std::vector<float> const& taps, unsigned numChannels) {
+    long const numBlocks = signal.size() / numChannels;
+    long const numTaps = taps.size() / numChannels;
+    std::vector<std::complex<float>> result(signal.size());
+    for (long block = 0; block < numBlocks; ++block) {
+        for (unsigned channel = 0; channel < numChannels; ++channel) {
+            std::complex<float> sum{};
+            for (long tap = 0; tap < numTaps; ++tap) {
+                auto const inputBlock = block + numTaps / 2 - tap;
+                if (inputBlock >= 0 && inputBlock < numBlocks) {
+                    sum += taps[tap * numChannels + channel] * signal[inputBlock * numChannels + channel];
+                }
+            }
+            result[block * numChannels + channel] = sum;
+        }
+    }
+    return result;
+}
+
+static void testFilter(std::size_t numBlocks, unsigned numTaps, unsigned numChannels) {
+    auto signal = generateSignal(numBlocks * numChannels);
+    auto const taps = generateTaps(std::size_t{numTaps} * numChannels);
+    auto const expected = referenceFilter(signal, taps, numChannels);
+
+    ChannelFIRFilter const filter{taps, numChannels};
+    testAssert(filter.getNumTaps() == numTaps);
+    testAssert(filter.getNumChannels() == numChannels);
+    filter.apply(signal.data(), numBlocks);
+    testAssert(signal == expected);
+}
+
+
+class ChannelFIRFilterTest : public StatelessTestModuleImpl {
+public:
+    ChannelFIRFilterTest();
+};
+
+
+ChannelFIRFilterTest::ChannelFIRFilterTest() : StatelessTestModuleImpl{{
+    {"Single tap", []() {
+        testFilter(20, 1, 3);
+    }},
+    {"Odd number of taps", []() {
+        testFilter(50, 5, 8);
+    }},
+    {"Even number of taps", []() {
+        testFilter(50, 12, 7);
+    }},
+    {"Fewer blocks than taps", []() {
+        testFilter(3, 8, 2);
+    }},
+    {"Many blocks (multiple chunks)", []() {
+        // Not a multiple of the chunk size, with halos crossing several chunk boundaries
+        testFilter(10001, 12, 5);
+    }},
+    {"Zero blocks", []() {
+        ChannelFIRFilter const filter{{1.0f, 2.0f}, 2};
+        filter.apply(nullptr, 0);
+    }},
+    {"Invalid taps", []() {
+        try {
+            ChannelFIRFilter{{}, 2};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            ChannelFIRFilter{{1.0f, 2.0f, 3.0f}, 2};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            ChannelFIRFilter{{1.0f, 2.0f}, 0};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }}
+}} {}
+
+
+TestModule channelFIRFilterTest() {
+    return {
+        "Channel FIR filter unit test",
+        []() { return std::make_unique<ChannelFIRFilterTest>(); }
+    };
+}
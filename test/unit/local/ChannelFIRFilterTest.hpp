@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the channel FIR filter module (ChannelFIRFilter.hpp and ChannelFIRFilter.cpp).
+TestModule channelFIRFilterTest();
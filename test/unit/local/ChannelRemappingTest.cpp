@@ -138,6 +138,53 @@ ChannelRemappingTest::ChannelRemappingTest() : StatelessTestModuleImpl{{
         };
         testAssert(actual == expected);
     }},
+    {"FFT friendly mode avoids large prime factors", []() {
+        std::set<unsigned> channels;
+        for (unsigned channel = 120; channel < 152; ++channel) {
+            channels.insert(channel);
+        }
+        // Smallest valid length is 76 = 2*2*19
+        auto const minimal = computeChannelRemapping(512, channels);
+        testAssert(minimal.newSamplingFreq == 76);
+
+        auto const actual = computeChannelRemapping(512, channels, RemappingMode::fftFriendly);
+        testAssert(actual.newSamplingFreq == 80);
+        testAssert(actual.channelMap.size() == channels.size());
+        std::set<unsigned> newChannels;
+        for (auto const [oldChannel, remappedChannel] : actual.channelMap) {
+            testAssert(channels.count(oldChannel) > 0);
+            testAssert(remappedChannel.newChannel <= 40);
+            testAssert(newChannels.insert(remappedChannel.newChannel).second);
+        }
+    }},
+    {"FFT friendly mode keeps a cheap minimal length", []() {
+        // Smallest valid length is 14 = 2*7
+        std::set<unsigned> const channels{0, 1, 2, 3, 4, 5, 6, 7};
+        auto const expected = computeChannelRemapping(512, channels);
+        auto const actual = computeChannelRemapping(512, channels, RemappingMode::fftFriendly);
+        testAssert(actual == expected);
+    }},
+    {"FFT friendly mode with single channel", []() {
+        auto const actual = computeChannelRemapping(512, {37}, RemappingMode::fftFriendly);
+        ChannelRemapping const expected{
+            37,
+            {{37, {0, false}}}
+        };
+        testAssert(actual == expected);
+    }},
+    {"estimateRemappingCost()", []() {
+        // Lengths with large prime factors
+        testAssert(estimateRemappingCost(80) < estimateRemappingCost(74));
+        testAssert(estimateRemappingCost(112) < estimateRemappingCost(106));
+        // Only small prime factors, the shorter length is cheaper
+        testAssert(estimateRemappingCost(64) < estimateRemappingCost(72));
+        testAssert(estimateRemappingCost(72) < estimateRemappingCost(80));
+        try {
+            estimateRemappingCost(0);
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
     {"Invalid sampling freq", []() {
         try {
             computeChannelRemapping(0, {1, 2, 76, 3});
@@ -200,6 +247,43 @@ ChannelRemappingTest::ChannelRemappingTest() : StatelessTestModuleImpl{{
                 newChannels.insert(newChannel);
             }
         }
+    }},
+    {"Bulk random test (FFT friendly mode)", []() {
+        for (unsigned i = 0; i < 250; ++i) {
+            // Generate a random valid sampling frequency and random valid channels.
+            std::uniform_int_distribution<unsigned> samplingFreqDist{1, 600};
+            unsigned const samplingFreq = samplingFreqDist(testRandomEngine);
+            std::uniform_int_distribution<unsigned> channelCountDist{0, 1 + samplingFreq / 2};
+            unsigned const channelCount = channelCountDist(testRandomEngine);
+            auto const channels = [samplingFreq, channelCount]() -> std::set<unsigned> {
+                std::vector<unsigned> allChannels(1 + samplingFreq / 2);
+                std::iota(allChannels.begin(), allChannels.end(), 0);
+                std::shuffle(allChannels.begin(), allChannels.end(), testRandomEngine);
+                return {allChannels.cbegin(), allChannels.cbegin() + channelCount};
+            }();
+
+            auto const minimal = computeChannelRemapping(samplingFreq, channels);
+            auto const remapping = computeChannelRemapping(samplingFreq, channels, RemappingMode::fftFriendly);
+            auto const newSamplingFreq = remapping.newSamplingFreq;
+
+            // Can't be smaller than the minimal remapping or worse than original sampling frequency.
+            testAssert(newSamplingFreq >= minimal.newSamplingFreq && newSamplingFreq <= samplingFreq);
+            // Must be no more expensive than the minimal remapping.
+            testAssert(estimateRemappingCost(newSamplingFreq) <= estimateRemappingCost(minimal.newSamplingFreq));
+            // Must have remapped all channels.
+            testAssert(remapping.channelMap.size() == channels.size());
+            std::set<unsigned> newChannels;
+            for (auto const [oldChannel, remappedChannel] : remapping.channelMap) {
+                auto const newChannel = remappedChannel.newChannel;
+                // Must remap each channel.
+                testAssert(channels.count(oldChannel) > 0);
+                // New channel must be <= new Nyquist frequency.
+                testAssert(newChannel <= newSamplingFreq / 2);
+                // New channel must not overlap any other channels.
+                testAssert(newChannels.count(newChannel) == 0);
+                newChannels.insert(newChannel);
+            }
+        }
     }}
 }} {}
 
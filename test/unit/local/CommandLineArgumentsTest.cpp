@@ -243,8 +243,11 @@ CommandLineArgumentsTest::CommandLineArgumentsTest() : StatelessTestModuleImpl{{
         catch (std::invalid_argument const&) {}
     }},
     {"createAppConfig(): Invalid number of arguments (more)", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "true", "extra"};
         try {
-            createAppConfig(8, nullptr);
+            createAppConfig(8, arguments);
             failTest();
         }
         catch (std::invalid_argument const&) {}
@@ -258,6 +261,354 @@ CommandLineArgumentsTest::CommandLineArgumentsTest() : StatelessTestModuleImpl{{
                                     "/mnt/test_input/inverse_polyphase_filter.bin",
                                     "/mnt/test_output", true};
         testAssert(actual == expected);
+    }},
+    {"createAppConfig(): Valid with optional arguments", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "false", "--prefetch-depth=2", "--memory-budget=512"};
+        auto const actual = createAppConfig(9, arguments);
+        AppConfig const expected = {"/mnt/test_input/", 1000000000, 1000000008,
+                                    "/mnt/test_input/inverse_polyphase_filter.bin",
+                                    "/mnt/test_output", false, 512, 2};
+        testAssert(actual == expected);
+    }},
+    {"createAppConfig(): Default optional arguments", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "true"};
+        auto const actual = createAppConfig(7, arguments);
+        testAssert(actual.memoryBudget == 2048);
+        testAssert(actual.prefetchDepth == 1);
+        testAssert(actual.remappingMode == RemappingMode::minimal);
+        testAssert(actual.concurrentInputs == 1);
+        testAssert(actual.inputBatchSize == 1);
+        testAssert(actual.schedulingMode == SchedulingMode::staticAssignment);
+        testAssert(actual.decompositionMode == DecompositionMode::antennaInput);
+        testAssert(!actual.sharedMemory);
+        testAssert(actual.outputFormat == OutputFormat::perInput);
+        testAssert(!actual.collectiveWrites);
+        testAssert(actual.writeBehindDepth == 0);
+        testAssert(actual.outputBackend == OutputBackend::stream);
+        testAssert(!actual.overlapSave);
+    }},
+    {"applyOptionalArgument(): Remapping mode", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--remapping-mode=fft-friendly");
+        testAssert(appConfig.remappingMode == RemappingMode::fftFriendly);
+        applyOptionalArgument(appConfig, "--remapping-mode=minimal");
+        testAssert(appConfig.remappingMode == RemappingMode::minimal);
+    }},
+    {"applyOptionalArgument(): Unknown argument", []() {
+        AppConfig appConfig{};
+        try {
+            applyOptionalArgument(appConfig, "--read-ahead=2");
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("Unknown") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"applyOptionalArgument(): Not of the form --name=value", []() {
+        AppConfig appConfig{};
+        try {
+            applyOptionalArgument(appConfig, "--prefetch-depth");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            applyOptionalArgument(appConfig, "prefetch-depth=2");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validateMemoryBudget(): Invalid (non-number input)", []() {
+        try {
+            validateMemoryBudget("2G");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validateMemoryBudget(): Invalid (zero)", []() {
+        try {
+            validateMemoryBudget("0");
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("must be positive") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"validateMemoryBudget(): Valid", []() {
+        testAssert(validateMemoryBudget("4096") == 4096);
+    }},
+    {"validatePrefetchDepth(): Invalid (negative value)", []() {
+        try {
+            validatePrefetchDepth("-1");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validatePrefetchDepth(): Invalid (too large)", []() {
+        try {
+            validatePrefetchDepth("9");
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("at most") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"validatePrefetchDepth(): Valid", []() {
+        testAssert(validatePrefetchDepth("0") == 0);
+        testAssert(validatePrefetchDepth("8") == 8);
+    }},
+    {"validateRemappingMode(): Invalid", []() {
+        try {
+            validateRemappingMode("fft");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            validateRemappingMode("");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validateRemappingMode(): Valid", []() {
+        testAssert(validateRemappingMode("minimal") == RemappingMode::minimal);
+        testAssert(validateRemappingMode("fft-friendly") == RemappingMode::fftFriendly);
+    }},
+    {"applyOptionalArgument(): Concurrent inputs", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--concurrent-inputs=4");
+        testAssert(appConfig.concurrentInputs == 4);
+    }},
+    {"validateConcurrentInputs(): Invalid", []() {
+        try {
+            validateConcurrentInputs("-1");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            validateConcurrentInputs("65");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validateConcurrentInputs(): Valid", []() {
+        testAssert(validateConcurrentInputs("0") == 0);
+        testAssert(validateConcurrentInputs("1") == 1);
+        testAssert(validateConcurrentInputs("64") == 64);
+    }},
+    {"applyOptionalArgument(): Input batch size", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--input-batch-size=2");
+        testAssert(appConfig.inputBatchSize == 2);
+    }},
+    {"validateInputBatchSize(): Invalid", []() {
+        try {
+            validateInputBatchSize("0");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            validateInputBatchSize("9");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            validateInputBatchSize("two");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validateInputBatchSize(): Valid", []() {
+        testAssert(validateInputBatchSize("1") == 1);
+        testAssert(validateInputBatchSize("8") == 8);
+    }},
+    {"validateSchedulingMode(): Valid", []() {
+        testAssert(validateSchedulingMode("static") == SchedulingMode::staticAssignment);
+        testAssert(validateSchedulingMode("dynamic") == SchedulingMode::dynamic);
+    }},
+    {"validateSchedulingMode(): Invalid", []() {
+        try {
+            validateSchedulingMode("work-stealing");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"applyOptionalArgument(): Scheduling", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--scheduling=dynamic");
+        testAssert(appConfig.schedulingMode == SchedulingMode::dynamic);
+    }},
+    {"validateDecompositionMode(): Valid", []() {
+        testAssert(validateDecompositionMode("antenna-input") == DecompositionMode::antennaInput);
+        testAssert(validateDecompositionMode("channel") == DecompositionMode::channel);
+    }},
+    {"validateDecompositionMode(): Invalid", []() {
+        try {
+            validateDecompositionMode("time");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"createAppConfig(): Channel decomposition with dynamic scheduling", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "false", "--decomposition=channel", "--scheduling=dynamic"};
+        try {
+            createAppConfig(9, arguments);
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("decomposition") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"validateSharedMemory(): Valid", []() {
+        testAssert(validateSharedMemory("true"));
+        testAssert(!validateSharedMemory("false"));
+    }},
+    {"validateSharedMemory(): Invalid", []() {
+        try {
+            validateSharedMemory("yes");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"applyOptionalArgument(): Shared memory", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--shared-memory=true");
+        testAssert(appConfig.sharedMemory);
+    }},
+    {"validateOutputFormat(): Valid", []() {
+        testAssert(validateOutputFormat("per-input") == OutputFormat::perInput);
+        testAssert(validateOutputFormat("container") == OutputFormat::container);
+    }},
+    {"validateOutputFormat(): Invalid", []() {
+        try {
+            validateOutputFormat("tar");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"applyOptionalArgument(): Output format", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--output-format=container");
+        testAssert(appConfig.outputFormat == OutputFormat::container);
+    }},
+    {"validateCollectiveWrites(): Valid", []() {
+        testAssert(validateCollectiveWrites("true"));
+        testAssert(!validateCollectiveWrites("false"));
+    }},
+    {"validateCollectiveWrites(): Invalid", []() {
+        try {
+            validateCollectiveWrites("1");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"createAppConfig(): Collective writes", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "false", "--output-format=container", "--collective-writes=true"};
+        auto const actual = createAppConfig(9, arguments);
+        testAssert(actual.outputFormat == OutputFormat::container);
+        testAssert(actual.collectiveWrites);
+    }},
+    {"createAppConfig(): Collective writes without output container", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "false", "--collective-writes=true"};
+        try {
+            createAppConfig(8, arguments);
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("Collective writes") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"createAppConfig(): Collective writes with dynamic scheduling", []() {
+        char* arguments[] = {"main", "/mnt/test_input", "1000000000", "1000000008",
+                             "/mnt/test_input/inverse_polyphase_filter.bin",
+                             "/mnt/test_output", "false", "--output-format=container", "--collective-writes=true",
+                             "--scheduling=dynamic"};
+        try {
+            createAppConfig(10, arguments);
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("dynamic scheduling") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"validateWriteBehindDepth(): Invalid (not a number)", []() {
+        try {
+            validateWriteBehindDepth("two");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"validateWriteBehindDepth(): Invalid (too large)", []() {
+        try {
+            validateWriteBehindDepth("9");
+            failTest();
+        }
+        catch (std::invalid_argument const& e) {
+            if ((int) ((std::string) e.what()).find("at most") == -1) {
+                failTest();
+            }
+        }
+    }},
+    {"validateWriteBehindDepth(): Valid", []() {
+        testAssert(validateWriteBehindDepth("0") == 0);
+        testAssert(validateWriteBehindDepth("8") == 8);
+    }},
+    {"applyOptionalArgument(): Write-behind depth", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--write-behind-depth=3");
+        testAssert(appConfig.writeBehindDepth == 3);
+    }},
+    {"validateOutputBackend(): Valid", []() {
+        testAssert(validateOutputBackend("stream") == OutputBackend::stream);
+        testAssert(validateOutputBackend("direct") == OutputBackend::direct);
+    }},
+    {"validateOutputBackend(): Invalid", []() {
+        try {
+            validateOutputBackend("O_DIRECT");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"applyOptionalArgument(): Output backend", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--output-backend=direct");
+        testAssert(appConfig.outputBackend == OutputBackend::direct);
+    }},
+    {"validateOverlapSave(): Valid", []() {
+        testAssert(validateOverlapSave("true"));
+        testAssert(!validateOverlapSave("false"));
+    }},
+    {"validateOverlapSave(): Invalid", []() {
+        try {
+            validateOverlapSave("auto");
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+    {"applyOptionalArgument(): Overlap-save", []() {
+        AppConfig appConfig{};
+        applyOptionalArgument(appConfig, "--overlap-save=true");
+        testAssert(appConfig.overlapSave);
     }}
 }} {}
 
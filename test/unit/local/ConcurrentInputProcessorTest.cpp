@@ -0,0 +1,131 @@
+#include "ConcurrentInputProcessorTest.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentInputProcessor.hpp"
+#include "TestHelper.hpp"
+
+
+// Runs numTasks tasks, checking no two tasks use the same slot at once and no more than concurrentInputs run at once.
+static void testRunTasks(unsigned concurrentInputs, unsigned numThreads, unsigned numTasks) {
+    ConcurrentInputProcessor processor{{concurrentInputs, 1}, numThreads};
+    std::vector<std::atomic<bool>> slotsInUse(concurrentInputs);
+    std::atomic<unsigned> running{0};
+    std::atomic<unsigned> maxRunning{0};
+    std::atomic<unsigned> completed{0};
+    std::atomic<bool> failed{false};
+
+    for (unsigned i = 0; i < numTasks; ++i) {
+        processor.run([&](unsigned slot) {
+            if (slot >= concurrentInputs || slotsInUse[slot].exchange(true)) {
+                failed = true;
+                return;
+            }
+            auto const nowRunning = ++running;
+            auto previousMax = maxRunning.load();
+            while (nowRunning > previousMax && !maxRunning.compare_exchange_weak(previousMax, nowRunning)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+            --running;
+            slotsInUse[slot] = false;
+            ++completed;
+        });
+    }
+    processor.wait();
+
+    testAssert(!failed);
+    testAssert(completed == numTasks);
+    testAssert(maxRunning <= concurrentInputs);
+}
+
+
+class ConcurrentInputProcessorTest : public StatelessTestModuleImpl {
+public:
+    ConcurrentInputProcessorTest();
+};
+
+
+ConcurrentInputProcessorTest::ConcurrentInputProcessorTest() : StatelessTestModuleImpl{{
+    {"planConcurrency(): Limited by threads", []() {
+        auto const plan = planConcurrency(1000, 10, 4, 0);
+        testAssert(plan.concurrentInputs == 4);
+        testAssert(plan.threadsPerInput == 1);
+    }},
+    {"planConcurrency(): Limited by memory budget", []() {
+        auto const plan = planConcurrency(1000, 300, 16, 0);
+        testAssert(plan.concurrentInputs == 3);
+        testAssert(plan.threadsPerInput == 5);
+    }},
+    {"planConcurrency(): Limited by maximum", []() {
+        auto const plan = planConcurrency(1000, 10, 16, 2);
+        testAssert(plan.concurrentInputs == 2);
+        testAssert(plan.threadsPerInput == 8);
+    }},
+    {"planConcurrency(): One antenna input at a time", []() {
+        auto const plan = planConcurrency(1000, 10, 16, 1);
+        testAssert(plan.concurrentInputs == 1);
+        testAssert(plan.threadsPerInput == 16);
+    }},
+    {"planConcurrency(): Antenna input larger than budget", []() {
+        auto const plan = planConcurrency(1000, 2000, 16, 0);
+        testAssert(plan.concurrentInputs == 1);
+        testAssert(plan.threadsPerInput == 16);
+    }},
+    {"planConcurrency(): Unknown antenna input size", []() {
+        auto const plan = planConcurrency(1000, 0, 6, 0);
+        testAssert(plan.concurrentInputs == 6);
+        testAssert(plan.threadsPerInput == 1);
+    }},
+    {"planConcurrency(): No threads", []() {
+        auto const plan = planConcurrency(1000, 10, 0, 0);
+        testAssert(plan.concurrentInputs == 1);
+        testAssert(plan.threadsPerInput == 1);
+    }},
+    {"run(): One at a time", []() {
+        testRunTasks(1, 4, 10);
+    }},
+    {"run(): Several at a time", []() {
+        testRunTasks(3, 4, 20);
+    }},
+    {"run(): More antenna inputs than threads", []() {
+        testRunTasks(4, 2, 12);
+    }},
+    {"wait(): No tasks", []() {
+        ConcurrentInputProcessor processor{{2, 1}, 2};
+        processor.wait();
+    }},
+    {"wait(): Task throws", []() {
+        ConcurrentInputProcessor processor{{2, 1}, 2};
+        processor.run([](unsigned) {});
+        processor.run([](unsigned) { throw std::runtime_error{"Task failed"}; });
+        try {
+            processor.wait();
+            failTest();
+        }
+        catch (std::runtime_error const&) {}
+    }},
+    {"run(): Earlier task threw", []() {
+        ConcurrentInputProcessor processor{{1, 1}, 2};
+        processor.run([](unsigned) { throw std::runtime_error{"Task failed"}; });
+        bool ran = false;
+        try {
+            // Only 1 slot, so waits for the first task to finish
+            processor.run([&ran](unsigned) { ran = true; });
+            failTest();
+        }
+        catch (std::runtime_error const&) {}
+        testAssert(!ran);
+    }}
+}} {}
+
+
+TestModule concurrentInputProcessorTest() {
+    return {
+        "Concurrent input processor unit test",
+        []() { return std::make_unique<ConcurrentInputProcessorTest>(); }
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the concurrent input processor module (ConcurrentInputProcessor.hpp and ConcurrentInputProcessor.cpp).
+TestModule concurrentInputProcessorTest();
@@ -1,15 +1,27 @@
 #include <iostream>
 
 #include "TestHelper.hpp"
+#include "AntennaInputReaderTest.hpp"
+#include "AntennaInputSamplesTest.hpp"
+#include "ChannelDecompositionTest.hpp"
+#include "ChannelFIRFilterTest.hpp"
 #include "ChannelRemappingTest.hpp"
+#include "ConcurrentInputProcessorTest.hpp"
 #include "CommandLineArgumentsTest.hpp"
 #include "MetadataFileReaderTest.hpp"
 #include "NodeAntennaInputAssignerTest.hpp"
+#include "OutputContainerTest.hpp"
 #include "OutputLogFileWriterTest.hpp"
+#include "OverlapSaveFilterTest.hpp"
 #include "OutSignalWriterTest.hpp"
 #include "ReadCoeDataTest.hpp"
 #include "ReadInputFileTest.hpp"
+#include "SampleConversionTest.hpp"
 #include "SignalProcessingTest.hpp"
+#include "SignalWriteBehindTest.hpp"
+#include "StageTimingTest.hpp"
+#include "SubfileIndexTest.hpp"
+#include "SubfileViewTest.hpp"
 
 #include <iostream>
 
@@ -25,6 +37,18 @@ int main(){
         readCoeDataTest(),
         outSignalWriterTest(),
         metadataFileReaderTest(),
-        readInputFileTest()
+        readInputFileTest(),
+        sampleConversionTest(),
+        antennaInputSamplesTest(),
+        antennaInputReaderTest(),
+        subfileIndexTest(),
+        subfileViewTest(),
+        channelFIRFilterTest(),
+        overlapSaveFilterTest(),
+        concurrentInputProcessorTest(),
+        stageTimingTest(),
+        channelDecompositionTest(),
+        outputContainerTest(),
+        signalWriteBehindTest()
     });
 }
@@ -3,7 +3,9 @@
 #include "NodeAntennaInputAssigner.hpp"
 #include "TestHelper.hpp"
 
+#include <cmath>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <vector>
@@ -73,6 +75,169 @@ NodeAntennaInputAssignerTest::NodeAntennaInputAssignerTest() : StatelessTestModu
 			failTest();
 		}
 		catch (std::invalid_argument const&) {}
+	}},
+    {"Costs: Equal costs", []() {
+		auto const actual = assignNodeAntennaInputs(3, std::vector<double>(9, 1.0), false);
+		testAssert(actual == assignNodeAntennaInputs(3, 9));
+	}},
+    {"Costs: Flagged antenna inputs", []() {
+		auto const actual = assignNodeAntennaInputs(2, {0, 0, 0, 0, 1, 1, 1, 1}, false);
+		std::vector<std::optional<AntennaInputRange>> const expected{{{0, 5}}, {{6, 7}}};
+		testAssert(actual == expected);
+	}},
+    {"Costs: Tiles kept together", []() {
+		std::vector<double> const costs(6, 1.0);
+		std::vector<std::optional<AntennaInputRange>> const expectedSplit{{{0, 2}}, {{3, 5}}};
+		testAssert(assignNodeAntennaInputs(2, costs, false) == expectedSplit);
+		std::vector<std::optional<AntennaInputRange>> const expectedTogether{{{0, 3}}, {{4, 5}}};
+		testAssert(assignNodeAntennaInputs(2, costs, true) == expectedTogether);
+	}},
+    {"Costs: Odd number of antenna inputs with tiles kept together", []() {
+		auto const actual = assignNodeAntennaInputs(2, {1, 1, 1, 1, 1}, true);
+		std::vector<std::optional<AntennaInputRange>> const expected{{{0, 1}}, {{2, 4}}};
+		testAssert(actual == expected);
+	}},
+    {"Costs: One expensive antenna input", []() {
+		auto const actual = assignNodeAntennaInputs(2, {10, 1, 1, 1}, false);
+		std::vector<std::optional<AntennaInputRange>> const expected{{{0, 0}}, {{1, 3}}};
+		testAssert(actual == expected);
+	}},
+    {"Costs: More nodes than antenna inputs", []() {
+		auto const actual = assignNodeAntennaInputs(3, {1, 1}, false);
+		std::vector<std::optional<AntennaInputRange>> const expected{{{0, 0}}, {}, {{1, 1}}};
+		testAssert(actual == expected);
+	}},
+    {"Costs: All flagged", []() {
+		auto const actual = assignNodeAntennaInputs(4, std::vector<double>(8, 0.0), true);
+		std::vector<std::optional<AntennaInputRange>> const expected{{{0, 1}}, {{2, 3}}, {{4, 5}}, {{6, 7}}};
+		testAssert(actual == expected);
+	}},
+    {"Costs: Balanced ranges cover every antenna input", []() {
+		// Every third tile flagged
+		std::vector<double> costs;
+		for (unsigned i = 0; i < 256; i++) {
+			costs.push_back((i / 2) % 3 == 0 ? 0.0 : 24.0);
+		}
+		auto const ranges = assignNodeAntennaInputs(7, costs, true);
+		testAssert(ranges.size() == 7);
+		unsigned nextInput = 0;
+		double const averageCost = std::accumulate(costs.begin(), costs.end(), 0.0) / 7;
+		for (auto const& range : ranges) {
+			testAssert(range.has_value());
+			testAssert(range->begin == nextInput);
+			testAssert(range->begin % 2 == 0);
+			auto const cost = std::accumulate(costs.begin() + range->begin, costs.begin() + range->end + 1, 0.0);
+			// Within one tile of the average
+			testAssert(std::abs(cost - averageCost) <= 48.0);
+			nextInput = range->end + 1;
+		}
+		testAssert(nextInput == 256);
+	}},
+    {"Costs: Invalid arguments", []() {
+		try {
+			assignNodeAntennaInputs(0, {1.0}, false);
+			failTest();
+		}
+		catch (std::invalid_argument const&) {}
+		try {
+			assignNodeAntennaInputs(2, std::vector<double>{}, false);
+			failTest();
+		}
+		catch (std::invalid_argument const&) {}
+		try {
+			assignNodeAntennaInputs(2, {1.0, -1.0}, false);
+			failTest();
+		}
+		catch (std::invalid_argument const&) {}
+	}},
+    {"getAntennaInputCosts()", []() {
+		AntennaConfig const antennaConfig{{{11, 'X', false}, {11, 'Y', false}, {12, 'X', true}, {12, 'Y', true}},
+		                                  {109, 110, 112}};
+		testAssert((getAntennaInputCosts(antennaConfig) == std::vector<double>{3.0, 3.0, 0.0, 0.0}));
+	}},
+    {"AntennaInputScheduler: Each node's own chunks handed out in order", []() {
+		AntennaInputScheduler scheduler{2, 8, 2};
+		testAssert((scheduler.next(1) == AntennaInputRange{4, 5}));
+		testAssert((scheduler.next(0) == AntennaInputRange{0, 1}));
+		testAssert((scheduler.next(0) == AntennaInputRange{2, 3}));
+		testAssert((scheduler.next(1) == AntennaInputRange{6, 7}));
+		testAssert(!scheduler.next(0).has_value());
+		testAssert(!scheduler.next(1).has_value());
+	}},
+    {"AntennaInputScheduler: Chunks are whole tiles", []() {
+		AntennaInputScheduler scheduler{1, 6, 3};
+		testAssert((scheduler.next(0) == AntennaInputRange{0, 3}));
+		testAssert((scheduler.next(0) == AntennaInputRange{4, 5}));
+		testAssert(!scheduler.next(0).has_value());
+	}},
+    {"AntennaInputScheduler: Odd number of antenna inputs", []() {
+		AntennaInputScheduler scheduler{2, 5, 2};
+		testAssert((scheduler.next(1) == AntennaInputRange{4, 4}));
+		testAssert((scheduler.next(0) == AntennaInputRange{0, 1}));
+		testAssert((scheduler.next(0) == AntennaInputRange{2, 3}));
+		testAssert(!scheduler.next(0).has_value());
+	}},
+    {"AntennaInputScheduler: Node which runs out takes later chunks from the busiest node", []() {
+		AntennaInputScheduler scheduler{3, 24, 2};
+		testAssert((scheduler.next(0) == AntennaInputRange{0, 1}));
+		testAssert((scheduler.next(1) == AntennaInputRange{8, 9}));
+		for (unsigned begin = 16; begin < 24; begin += 2) {
+			testAssert((scheduler.next(2) == AntennaInputRange{begin, begin + 1}));
+		}
+		// Node 0 has 3 chunks left and node 1 has 3, node 2 takes the last 2 of node 0's
+		testAssert((scheduler.next(2) == AntennaInputRange{4, 5}));
+		testAssert((scheduler.next(2) == AntennaInputRange{6, 7}));
+		testAssert((scheduler.next(0) == AntennaInputRange{2, 3}));
+		// Now only node 1 has chunks left
+		testAssert((scheduler.next(0) == AntennaInputRange{12, 13}));
+		testAssert((scheduler.next(1) == AntennaInputRange{10, 11}));
+		testAssert((scheduler.next(0) == AntennaInputRange{14, 15}));
+		testAssert(!scheduler.next(1).has_value());
+		testAssert(!scheduler.next(2).has_value());
+	}},
+    {"AntennaInputScheduler: More nodes than tiles", []() {
+		AntennaInputScheduler scheduler{4, 4, 2};
+		testAssert((scheduler.next(3) == AntennaInputRange{0, 1}));
+		testAssert((scheduler.next(2) == AntennaInputRange{2, 3}));
+		testAssert(!scheduler.next(0).has_value());
+		testAssert(!scheduler.next(1).has_value());
+	}},
+    {"AntennaInputScheduler: Every antenna input handed out once", []() {
+		unsigned const numAntennaInputs = 256;
+		AntennaInputScheduler scheduler{5, numAntennaInputs, 4};
+		std::vector<unsigned> timesHandedOut(numAntennaInputs, 0);
+		// Node n asks n + 1 times as often as node 0, as if it were that much faster
+		bool finished = false;
+		while (!finished) {
+			finished = true;
+			for (unsigned node = 0; node < scheduler.getNumNodes(); node++) {
+				for (unsigned i = 0; i <= node; i++) {
+					if (auto const chunk = scheduler.next(node)) {
+						testAssert(chunk->begin % ANTENNA_INPUTS_PER_TILE == 0);
+						for (unsigned input = chunk->begin; input <= chunk->end; input++) {
+							timesHandedOut.at(input)++;
+						}
+						finished = false;
+					}
+				}
+			}
+		}
+		testAssert(timesHandedOut == std::vector<unsigned>(numAntennaInputs, 1));
+	}},
+    {"AntennaInputScheduler: cancel()", []() {
+		AntennaInputScheduler scheduler{2, 8, 2};
+		testAssert(scheduler.next(0).has_value());
+		scheduler.cancel();
+		testAssert(!scheduler.next(0).has_value());
+		testAssert(!scheduler.next(1).has_value());
+	}},
+    {"AntennaInputScheduler: Invalid node", []() {
+		AntennaInputScheduler scheduler{2, 8, 2};
+		try {
+			scheduler.next(2);
+			failTest();
+		}
+		catch (std::out_of_range const&) {}
 	}}
 }} {}
 
@@ -20,6 +20,25 @@ AntennaInputPhysID testAntenaPhysID = {1,'x'};
 
 std::filesystem::path filename = validTestConfig.outputDirectoryPath + std::to_string(validTestConfig.observationID) + "_" + std::to_string(validTestConfig.signalStartTime) + "_" + std::to_string(testAntenaPhysID.tile) +"_"+ std::string(1,testAntenaPhysID.signalChain)+".bin";
 
+static std::filesystem::path const alignedTestPath{"/tmp/mwatdr_aligned_signal_test.bin"};
+
+// Reads a whole signal file back.
+static std::vector<std::int16_t> readSignalFile(std::filesystem::path const& path) {
+    std::vector<std::int16_t> signal(std::filesystem::file_size(path) / sizeof(std::int16_t));
+    std::ifstream file{path, std::ios::binary};
+    file.read(reinterpret_cast<char*>(signal.data()), signal.size() * sizeof(std::int16_t));
+    return signal;
+}
+
+// Signal with a different value in every sample of each aligned block.
+static std::vector<std::int16_t> createTestSignal(std::size_t numSamples) {
+    std::vector<std::int16_t> signal(numSamples);
+    for (std::size_t i = 0; i < numSamples; i++) {
+        signal[i] = static_cast<std::int16_t>((i * 7919) % 65536 - 32768);
+    }
+    return signal;
+}
+
 
 class OutSignalWriterTest : public StatelessTestModuleImpl {
 public:
@@ -99,6 +118,56 @@ OutSignalWriterTest::OutSignalWriterTest() : StatelessTestModuleImpl{{
         std::filesystem::remove("/tmp/123456789_123456789_1_x.bin");    
 	
     }},                
+    {"Direct output backend", []() {
+        std::filesystem::remove(filename);
+        auto directTestConfig = validTestConfig;
+        directTestConfig.outputBackend = OutputBackend::direct;
+        std::vector<std::int16_t> const testData = {1,2,3,4,5,6,7,8,9};
+        outSignalWriter(testData,directTestConfig,testAntenaPhysID);
+        testAssert(readSignalFile(filename) == testData);
+        // The file already exists
+        try {
+            outSignalWriter(testData,directTestConfig,testAntenaPhysID);
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        std::filesystem::remove(filename);
+    }},
+    {"writeAlignedSignalFile(): Size not a multiple of the alignment", []() {
+        std::filesystem::remove(alignedTestPath);
+        auto const signal = createTestSignal(3001);
+        writeAlignedSignalFile(alignedTestPath, signal);
+        testAssert(std::filesystem::file_size(alignedTestPath) == 6002);
+        testAssert(readSignalFile(alignedTestPath) == signal);
+        std::filesystem::remove(alignedTestPath);
+    }},
+    {"writeAlignedSignalFile(): Several chunks", []() {
+        std::filesystem::remove(alignedTestPath);
+        // Just over 20 MiB
+        auto const signal = createTestSignal(10 * 1024 * 1024 + 123);
+        writeAlignedSignalFile(alignedTestPath, signal);
+        testAssert(readSignalFile(alignedTestPath) == signal);
+        std::filesystem::remove(alignedTestPath);
+    }},
+    {"writeAlignedSignalFile(): Empty signal", []() {
+        std::filesystem::remove(alignedTestPath);
+        writeAlignedSignalFile(alignedTestPath, {});
+        testAssert(std::filesystem::file_size(alignedTestPath) == 0);
+        std::filesystem::remove(alignedTestPath);
+    }},
+    {"writeAlignedSignalFile(): File already exists", []() {
+        std::filesystem::remove(alignedTestPath);
+        auto const signal = createTestSignal(100);
+        writeAlignedSignalFile(alignedTestPath, signal);
+        try {
+            writeAlignedSignalFile(alignedTestPath, createTestSignal(200));
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        // The existing file is left alone
+        testAssert(readSignalFile(alignedTestPath) == signal);
+        std::filesystem::remove(alignedTestPath);
+    }},
 
 }} {}
 
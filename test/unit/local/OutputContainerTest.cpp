@@ -0,0 +1,193 @@
+#include "OutputContainerTest.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common.hpp"
+#include "OutputContainer.hpp"
+#include "OutSignalWriter.hpp"
+#include "TestHelper.hpp"
+
+
+static AppConfig const testAppConfig{"", 1234567890, 1234567898, "", "/tmp/", false};
+static std::filesystem::path const testPath{"/tmp/1234567890_1234567898.tdr"};
+
+// Tile 11 X and Y, tile 12 X (flagged) and Y.
+static AntennaConfig const testAntennaConfig{
+    {{11, 'X', false}, {11, 'Y', false}, {12, 'X', true}, {12, 'Y', false}},
+    {100, 101}
+};
+
+// Reads the bytes of a file from offset.
+static std::vector<char> readFileBytes(std::filesystem::path const& path, std::size_t offset, std::size_t size) {
+    std::ifstream file{path, std::ios::binary};
+    file.seekg(offset);
+    std::vector<char> bytes(size);
+    file.read(bytes.data(), size);
+    return bytes;
+}
+
+
+class OutputContainerTest : public StatelessTestModuleImpl {
+public:
+    OutputContainerTest();
+};
+
+
+OutputContainerTest::OutputContainerTest() : StatelessTestModuleImpl{{
+    {"getOutputContainerPath()", []() {
+        testAssert(getOutputContainerPath(testAppConfig) == testPath);
+    }},
+    {"getOutputContainerPath(): Empty output directory", []() {
+        try {
+            getOutputContainerPath({"", 1, 2, "", "", false});
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+    }},
+    {"planOutputContainer()", []() {
+        auto const layout = planOutputContainer(testAppConfig, testAntennaConfig, 230, 3000);
+        testAssert(layout.samplingFreq == 230);
+        testAssert(layout.observationID == testAppConfig.observationID);
+        testAssert(layout.signalStartTime == testAppConfig.signalStartTime);
+        testAssert(layout.numSamples == 3000);
+        testAssert(layout.dataOffset == OUTPUT_CONTAINER_ALIGNMENT);
+        testAssert(layout.antennaInputs.size() == 4);
+        // Each 6000 byte signal gets a 8192 byte slot, and the flagged antenna input gets none
+        testAssert(layout.antennaInputs[0].offset == 4096);
+        testAssert(layout.antennaInputs[1].offset == 4096 + 8192);
+        testAssert(layout.antennaInputs[2].flagged);
+        testAssert(layout.antennaInputs[2].offset == 0);
+        testAssert(layout.antennaInputs[3].offset == 4096 + 2 * 8192);
+        testAssert(layout.antennaInputs[3].tile == 12);
+        testAssert(layout.antennaInputs[3].signalChain == 'Y');
+        testAssert(!layout.antennaInputs[3].written);
+        testAssert(layout.getFileSize() == 4096 + 3 * 8192);
+    }},
+    {"createOutputContainer(): Header and table read back", []() {
+        std::filesystem::remove(testPath);
+        auto const expected = planOutputContainer(testAppConfig, testAntennaConfig, 230, 3000);
+        createOutputContainer(testPath, expected);
+        testAssert(std::filesystem::file_size(testPath) == expected.getFileSize());
+        auto const actual = readOutputContainerLayout(testPath);
+        testAssert(actual.samplingFreq == expected.samplingFreq);
+        testAssert(actual.observationID == expected.observationID);
+        testAssert(actual.signalStartTime == expected.signalStartTime);
+        testAssert(actual.numSamples == expected.numSamples);
+        testAssert(actual.dataOffset == expected.dataOffset);
+        testAssert(actual.antennaInputs.size() == expected.antennaInputs.size());
+        for (std::size_t i = 0; i < actual.antennaInputs.size(); i++) {
+            testAssert(actual.antennaInputs[i].tile == expected.antennaInputs[i].tile);
+            testAssert(actual.antennaInputs[i].signalChain == expected.antennaInputs[i].signalChain);
+            testAssert(actual.antennaInputs[i].flagged == expected.antennaInputs[i].flagged);
+            testAssert(actual.antennaInputs[i].offset == expected.antennaInputs[i].offset);
+        }
+        // The header starts with the magic, then the version and sampling frequency, little-endian
+        auto const header = readFileBytes(testPath, 0, 16);
+        testAssert((header == std::vector<char>{'M', 'W', 'A', 'T', 'D', 'R', 'C', '\0', 1, 0, 0, 0, -26, 0, 0, 0}));
+        std::filesystem::remove(testPath);
+    }},
+    {"createOutputContainer(): File already exists", []() {
+        std::filesystem::remove(testPath);
+        auto const layout = planOutputContainer(testAppConfig, testAntennaConfig, 230, 3000);
+        createOutputContainer(testPath, layout);
+        try {
+            createOutputContainer(testPath, layout);
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        std::filesystem::remove(testPath);
+    }},
+    {"OutputContainerWriter: Signals written to their slots", []() {
+        std::filesystem::remove(testPath);
+        createOutputContainer(testPath, planOutputContainer(testAppConfig, testAntennaConfig, 230, 4));
+        {
+            OutputContainerWriter const writer{testPath};
+            writer.write(3, {1, -2, 3, -4});
+            writer.write(0, {256, 0, 0, 1});
+        }
+        auto const layout = readOutputContainerLayout(testPath);
+        testAssert((readFileBytes(testPath, layout.antennaInputs[3].offset, 8) ==
+                    std::vector<char>{1, 0, -2, -1, 3, 0, -4, -1}));
+        testAssert((readFileBytes(testPath, layout.antennaInputs[0].offset, 8) ==
+                    std::vector<char>{0, 1, 0, 0, 0, 0, 1, 0}));
+        // Slot which wasn't written is still empty
+        testAssert((readFileBytes(testPath, layout.antennaInputs[1].offset, 8) == std::vector<char>(8, 0)));
+        std::filesystem::remove(testPath);
+    }},
+    {"OutputContainerWriter: Invalid writes", []() {
+        std::filesystem::remove(testPath);
+        createOutputContainer(testPath, planOutputContainer(testAppConfig, testAntennaConfig, 230, 4));
+        OutputContainerWriter const writer{testPath};
+        // Flagged antenna input
+        try {
+            writer.write(2, {1, 2, 3, 4});
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        // Antenna input out of range
+        try {
+            writer.write(4, {1, 2, 3, 4});
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        // Wrong number of samples
+        try {
+            writer.write(0, {1, 2, 3});
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        std::filesystem::remove(testPath);
+    }},
+    {"OutputContainerWriter: Not an output container", []() {
+        std::filesystem::remove(testPath);
+        {
+            std::ofstream file{testPath, std::ios::binary};
+            file << std::string(100, 'x');
+        }
+        try {
+            OutputContainerWriter const writer{testPath};
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+        std::filesystem::remove(testPath);
+    }},
+    {"OutputContainerWriter: Nonexistent file", []() {
+        std::filesystem::remove(testPath);
+        try {
+            OutputContainerWriter const writer{testPath};
+            failTest();
+        }
+        catch (OutSignalException const&) {}
+    }},
+    {"markOutputContainerWritten()", []() {
+        std::filesystem::remove(testPath);
+        createOutputContainer(testPath, planOutputContainer(testAppConfig, testAntennaConfig, 230, 4));
+        ObservationProcessingResults const results{{
+            {0, {true, {100, 101}}},
+            {1, {false, {100, 101}}},
+            {2, {false, {}}},
+            {3, {true, {100, 101}}}
+        }};
+        markOutputContainerWritten(testPath, results);
+        auto const layout = readOutputContainerLayout(testPath);
+        testAssert(layout.antennaInputs[0].written);
+        testAssert(!layout.antennaInputs[1].written);
+        testAssert(!layout.antennaInputs[2].written);
+        testAssert(layout.antennaInputs[3].written);
+        std::filesystem::remove(testPath);
+    }}
+}} {}
+
+
+TestModule outputContainerTest() {
+    return {
+        "Output container unit test",
+        []() { return std::make_unique<OutputContainerTest>(); }
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the output container module (OutputContainer.hpp and OutputContainer.cpp).
+TestModule outputContainerTest();
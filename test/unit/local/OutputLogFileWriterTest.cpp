@@ -3,10 +3,14 @@
 #include "../../src/ChannelRemapping.hpp"
 #include "../../src/Common.hpp"
 #include "../../src/OutputLogFileWriter.hpp"
+#include "../../src/StageTiming.hpp"
 #include "../TestHelper.hpp"
 
+#include <fstream>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 
 class OutputLogFileWriterTest : public StatelessTestModuleImpl {
 public:
@@ -21,7 +25,7 @@ OutputLogFileWriterTest::OutputLogFileWriterTest() : StatelessTestModuleImpl {{
 		    ChannelRemapping const channelRemapping = { 10, {{5, {5, false}}, {6, {4, true}},
                                                                 {7, {3, true}}, {8, {2, true}},
 													            {9, {1, true}} }};
-		    ObservationProcessingResults const results = {{ {0, {true, {5, 6, 7, 8, 9}}},
+		    ObservationProcessingResults results = {{ {0, {true, {5, 6, 7, 8, 9}}},
 		                                                    {1, {false, {7, 8}}},
 													        {2, {true, {5, 6, 9}}},
 													        {3, {true, {5, 6, 8, 9}}},
@@ -31,7 +35,45 @@ OutputLogFileWriterTest::OutputLogFileWriterTest() : StatelessTestModuleImpl {{
                                                    {71, 'X', false}, {71, 'Y', false}, {93, 'X', false}, {93, 'Y', false}},
 		                                         {98, 100, 101, 103, 104, 106,
                                                   107, 108, 109, 110, 111, 112}};
-		    writeLogFile(appConfig, channelRemapping, results, antennaConfig);
+		    // Stage timings from the primary node and a secondary node
+		    results.results.at(4).node = 1;
+		    results.results.at(5).node = 1;
+		    for (auto const index : {0u, 1u, 4u, 5u}) {
+		        auto& measurements = results.results.at(index).stageMeasurements;
+		        addStageMeasurement(measurements, ProcessingStage::read, 0.5 + index, 2000000, 1000000);
+		        addStageMeasurement(measurements, ProcessingStage::dft, 0.25 * index, 8000000, 2000000);
+		    }
+		    writeLogFile(appConfig, channelRemapping, channelRemapping.newSamplingFreq, results, antennaConfig);
+
+		    // Each stage is summarised over all nodes and then for each node, with N/A for stages not measured
+		    std::ifstream logFile{"/mnt/test_output/1000000000_1000000008_outputlog.txt"};
+		    std::stringstream log;
+		    log << logFile.rdbuf();
+		    auto const contains = [contents = log.str()](std::string const& text) {
+		        return contents.find(text) != std::string::npos;
+		    };
+		    testAssert(contains("PROCESSING STAGE TIMINGS\n"));
+		    testAssert(contains(
+		        "All nodes:\n"
+		        "-Read: 4 antenna input(s), 12 s total, 0.5 / 3 / 5.5 s, 0.667 MB/s, 0.333 Msamples/s\n"
+		        "-Remap: N/A\n"
+		        "-Inverse PFB: N/A\n"
+		        "-Inverse DFT: 4 antenna input(s), 2.5 s total, 0 / 0.625 / 1.25 s, 12.8 MB/s, 3.2 Msamples/s\n"
+		        "-Post-processing: N/A\n"
+		        "-Write: N/A\n"));
+		    testAssert(contains(
+		        "Node 0:\n"
+		        "-Read: 2 antenna input(s), 2 s total, 0.5 / 1 / 1.5 s, 2 MB/s, 1 Msamples/s\n"
+		        "-Remap: N/A\n"
+		        "-Inverse PFB: N/A\n"
+		        "-Inverse DFT: 2 antenna input(s), 0.25 s total, 0 / 0.125 / 0.25 s, 64 MB/s, 16 Msamples/s\n"));
+		    testAssert(contains(
+		        "Node 1:\n"
+		        "-Read: 2 antenna input(s), 10 s total, 4.5 / 5 / 5.5 s, 0.4 MB/s, 0.2 Msamples/s\n"
+		        "-Remap: N/A\n"
+		        "-Inverse PFB: N/A\n"
+		        "-Inverse DFT: 2 antenna input(s), 2.25 s total, 1 / 1.125 / 1.25 s, 7.111 MB/s, 1.778 Msamples/s\n"));
+		    testAssert(!contains("Node 2:"));
 		}
 		catch (LogWriterException const&) {
 			failTest();
@@ -43,7 +85,7 @@ OutputLogFileWriterTest::OutputLogFileWriterTest() : StatelessTestModuleImpl {{
 			ChannelRemapping channelRemapping;
 			ObservationProcessingResults results;
 			AntennaConfig antennaConfig;
-			writeLogFile(appConfig, channelRemapping, results, antennaConfig);
+			writeLogFile(appConfig, channelRemapping, 0, results, antennaConfig);
 			failTest();
 		}
 		catch (LogWriterException const&) {}
@@ -0,0 +1,145 @@
+#include "OverlapSaveFilterTest.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "OverlapSaveFilter.hpp"
+#include "TestHelper.hpp"
+
+
+static std::vector<std::complex<float>> generateValues(std::size_t numValues, float maxValue) {
+    std::uniform_real_distribution<float> distribution{-maxValue, maxValue};
+    std::vector<std::complex<float>> values(numValues);
+    for (auto& value : values) {
+        value = {distribution(testRandomEngine), distribution(testRandomEngine)};
+    }
+    return values;
+}
+
+// Straightforward implementation of the filter, for comparison.
+static std::vector<std::complex<float>> referenceFilter(std::vector<std::complex<float>> const& signal,
+                                                        std::vector<std::complex<float>> const& taps,
+                                                        unsigned numChannels) {
+    long const numBlocks = signal.size() / numChannels;
+    long const numTaps = taps.size() / numChannels;
+    std::vector<std::complex<float>> result(signal.size());
+    for (long block = 0; block < numBlocks; ++block) {
+        for (unsigned channel = 0; channel < numChannels; ++channel) {
+            std::complex<float> sum{};
+            for (long tap = 0; tap < numTaps; ++tap) {
+                auto const inputBlock = block + numTaps / 2 - tap;
+                if (inputBlock >= 0 && inputBlock < numBlocks) {
+                    sum += taps[tap * numChannels + channel] * signal[inputBlock * numChannels + channel];
+                }
+            }
+            result[block * numChannels + channel] = sum;
+        }
+    }
+    return result;
+}
+
+static void testFilter(std::size_t numBlocks, unsigned numTaps, unsigned numChannels, unsigned segmentLength) {
+    auto signal = generateValues(numBlocks * numChannels, 100.0f);
+    auto const taps = generateValues(std::size_t{numTaps} * numChannels, 1.0f);
+    auto const expected = referenceFilter(signal, taps, numChannels);
+
+    OverlapSaveFilter filter{taps, numChannels, segmentLength};
+    testAssert(filter.getNumTaps() == numTaps);
+    testAssert(filter.getNumChannels() == numChannels);
+    testAssert(filter.getSegmentLength() == segmentLength);
+    filter.apply(signal.data(), numBlocks);
+    // FFT convolution isn't exact, so allow for rounding error relative to the size of the sum
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        testAssert(std::abs(signal[i] - expected[i]) <= 1e-3f * (1.0f + std::abs(expected[i])) * numTaps);
+    }
+}
+
+
+class OverlapSaveFilterTest : public StatelessTestModuleImpl {
+public:
+    OverlapSaveFilterTest();
+};
+
+
+OverlapSaveFilterTest::OverlapSaveFilterTest() : StatelessTestModuleImpl{{
+    {"Single tap", []() {
+        testFilter(20, 1, 3, 8);
+    }},
+    {"Odd number of taps", []() {
+        testFilter(50, 5, 4, 16);
+    }},
+    {"Even number of taps", []() {
+        testFilter(50, 12, 3, 32);
+    }},
+    {"Many segments", []() {
+        // Not a multiple of the segment step, so the last segment is only partly output
+        testFilter(1001, 7, 5, 16);
+    }},
+    {"Segment length equal to number of taps", []() {
+        testFilter(40, 8, 2, 8);
+    }},
+    {"Fewer blocks than taps", []() {
+        testFilter(3, 8, 2, 16);
+    }},
+    {"Successive signals", []() {
+        // Nothing is carried over from one signal to the next
+        auto const taps = generateValues(6 * 3, 1.0f);
+        OverlapSaveFilter filter{taps, 3, 16};
+        for (unsigned i = 0; i < 3; ++i) {
+            auto signal = generateValues(70 * 3, 100.0f);
+            auto const expected = referenceFilter(signal, taps, 3);
+            filter.apply(signal.data(), 70);
+            for (std::size_t j = 0; j < expected.size(); ++j) {
+                testAssert(std::abs(signal[j] - expected[j]) <= 1e-2f * (1.0f + std::abs(expected[j])));
+            }
+        }
+    }},
+    {"Default segment length", []() {
+        OverlapSaveFilter const filter{std::vector<std::complex<float>>(40 * 2, 1.0f), 2};
+        testAssert(filter.getSegmentLength() == chooseOverlapSaveSegmentLength(40));
+    }},
+    {"chooseOverlapSaveSegmentLength()", []() {
+        testAssert(chooseOverlapSaveSegmentLength(1) == 256);
+        testAssert(chooseOverlapSaveSegmentLength(32) == 256);
+        testAssert(chooseOverlapSaveSegmentLength(33) == 512);
+        testAssert(chooseOverlapSaveSegmentLength(128) == 1024);
+    }},
+    {"Zero blocks", []() {
+        OverlapSaveFilter filter{{1.0f, 2.0f}, 2, 4};
+        filter.apply(nullptr, 0);
+    }},
+    {"Invalid arguments", []() {
+        try {
+            OverlapSaveFilter{{}, 2};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            OverlapSaveFilter{{1.0f, 2.0f, 3.0f}, 2};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            OverlapSaveFilter{{1.0f, 2.0f}, 0};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+        try {
+            OverlapSaveFilter{std::vector<std::complex<float>>(8 * 2, 1.0f), 2, 7};
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }}
+}} {}
+
+
+TestModule overlapSaveFilterTest() {
+    return {
+        "Overlap-save filter unit test",
+        []() { return std::make_unique<OverlapSaveFilterTest>(); }
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the overlap-save filter module (OverlapSaveFilter.hpp and OverlapSaveFilter.cpp).
+TestModule overlapSaveFilterTest();
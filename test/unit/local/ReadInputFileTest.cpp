@@ -8,6 +8,7 @@
 #include <fstream>
 #include <filesystem>
 #include <random>
+#include <vector>
 
 class ReadInputFileTest : public TestModule::Impl {
 public:
@@ -27,6 +28,27 @@ bool cmpf(float x, float y, float epsilon = 0.00000005f)
         return false; //they are not same
     }
 }
+void writeSmallInputDataFile(std::string fileName, unsigned int nFineChan, unsigned int nSamples){
+    std::string header = "HDR_SIZE 4096\nPOPULATED 1\nNPOL 2\nNTIMESAMPLES " + std::to_string(nSamples) +
+                         "\nNINPUTS " + std::to_string(nFineChan * 2) + "\nNFINE_CHAN " + std::to_string(nFineChan) + "\n";
+    header.resize(4096, '\0');
+    std::ofstream file(fileName, std::ios::out | std::ios::binary);
+    file << header;
+    //delay block
+    std::vector<std::int8_t> blockValues(nFineChan * 2 * nSamples * 2, 0);
+    file.write(reinterpret_cast<char const*>(blockValues.data()), blockValues.size());
+    for (std::size_t block = 0; block < 160; ++block) {
+        blockValues.clear();
+        for (std::size_t antennaInput = 0; antennaInput < nFineChan * 2; ++antennaInput) {
+            for (std::size_t sample = 0; sample < nSamples; ++sample) {
+                blockValues.push_back(7 * block * antennaInput * sample - 8 * block);
+                blockValues.push_back(block - antennaInput + 3 * sample);
+            }
+        }
+        file.write(reinterpret_cast<char const*>(blockValues.data()), blockValues.size());
+    }
+}
+
 ReadInputFileTest::ReadInputFileTest(){ 
     std::string str = "HDR_SIZE 4096\nPOPULATED 1\nOBS_ID 1294797712\nSUBOBS_ID 1294797712\nMODE VOLTAGE_START\nUTC_START 2021-01-16-02:01:34\nOBS_OFFSET 0\nNBIT 8\nNPOL 2\nNTIMESAMPLES 64000\nNINPUTS 256\nNINPUTS_XGPU 256\nAPPLY_PATH_WEIGHTS 0\nAPPLY_PATH_DELAYS 0\nINT_TIME_MSEC 500\nFSCRUNCH_FACTOR 50\nAPPLY_VIS_WEIGHTS 0\nTRANSFER_SIZE 5275648000\nPROJ_ID G0034\nEXPOSURE_SECS 304\nCOARSE_CHANNEL 118\nCORR_COARSE_CHANNEL 10\nSECS_PER_SUBOBS 8\nUNIXTIME 1610762494\nUNIXTIME_MSEC 0\nFINE_CHAN_WIDTH_HZ 10000\nNFINE_CHAN 128\nBANDWIDTH_HZ 1280000\nSAMPLE_RATE 1280000\nMC_IP 0.0.0.0\nMC_PORT 0\nMC_SRC_IP 0.0.0.0\n";
     std::string invalidstr = "HDR_SIZE 4096\nPOPULATED 1\nOBS_ID 1294797712\nSUBOBS_ID 1294797712\nMODE VOLTAGE_START\nUTC_START 2021-01-16-02:01:34\nOBS_OFFSET 0\nNBIT 8\nNPOL 3\nNTIMESAMPLES 64000\nNINPUTS 256\nNINPUTS_XGPU 256\nAPPLY_PATH_WEIGHTS 0\nAPPLY_PATH_DELAYS 0\nINT_TIME_MSEC 500\nFSCRUNCH_FACTOR 50\nAPPLY_VIS_WEIGHTS 0\nTRANSFER_SIZE 5275648000\nPROJ_ID G0034\nEXPOSURE_SECS 304\nCOARSE_CHANNEL 118\nCORR_COARSE_CHANNEL 10\nSECS_PER_SUBOBS 8\nUNIXTIME 1610762494\nUNIXTIME_MSEC 0\nFINE_CHAN_WIDTH_HZ 10000\nNFINE_CHAN 128\nBANDWIDTH_HZ 1280000\nSAMPLE_RATE 1280000\nMC_IP 0.0.0.0\nMC_PORT 0\nMC_SRC_IP 0.0.0.0\n";
@@ -177,6 +199,55 @@ std::vector<TestCase> ReadInputFileTest::getTestCases(){
             testAssert(validateInputData("/tmp/1294797712_1294797717_118.sub",220) == false);
             std::filesystem::remove("/tmp/1294797712_1294797717_118.sub");                                                            
         }},                                                                                                            
+        {"Antenna input range read in one pass", []() {
+            std::string const fileName = "/tmp/1294797712_1294797720_118.sub";
+            writeSmallInputDataFile(fileName, 4, 50);
+            auto const actualSignalData = readInputDataFile(fileName, AntennaInputRange{2, 5}, 8);
+            testAssert(actualSignalData.size() == 4);
+            for (std::size_t i = 0; i < actualSignalData.size(); ++i) {
+                std::uint8_t const antennaInput = 2 + i;
+                testAssert(actualSignalData.at(i).size() == 160 * 50);
+                std::size_t index = 0;
+                for (std::size_t block = 0; block < 160; ++block) {
+                    for (std::size_t sample = 0; sample < 50; ++sample) {
+                        std::int8_t expectedReal = 7 * block * antennaInput * sample - 8 * block;
+                        std::int8_t expectedImaj = block - antennaInput + 3 * sample;
+                        std::complex<float> actualValue = actualSignalData.at(i).at(index);
+                        testAssert(cmpf(actualValue.real(), static_cast<float>(expectedReal)) == true);
+                        testAssert(cmpf(actualValue.imag(), static_cast<float>(expectedImaj)) == true);
+                        ++index;
+                    }
+                }
+                //a single input read has to give the same result
+                testAssert(readInputDataFile(fileName, antennaInput, 8) == actualSignalData.at(i));
+            }
+            std::filesystem::remove(fileName);
+        }},
+        {"Raw antenna input range read", []() {
+            std::string const fileName = "/tmp/1294797712_1294797720_118.sub";
+            writeSmallInputDataFile(fileName, 4, 50);
+            auto const rawSignalData = readRawInputDataFile(fileName, AntennaInputRange{1, 6}, 8);
+            auto const actualSignalData = readInputDataFile(fileName, AntennaInputRange{1, 6}, 8);
+            testAssert(rawSignalData.size() == 6);
+            for (std::size_t i = 0; i < rawSignalData.size(); ++i) {
+                testAssert(rawSignalData.at(i).size() == 160 * 50 * 2);
+                for (std::size_t j = 0; j < actualSignalData.at(i).size(); ++j) {
+                    testAssert(static_cast<float>(rawSignalData.at(i).at(2 * j)) == actualSignalData.at(i).at(j).real());
+                    testAssert(static_cast<float>(rawSignalData.at(i).at(2 * j + 1)) == actualSignalData.at(i).at(j).imag());
+                }
+            }
+            std::filesystem::remove(fileName);
+        }},
+        {"Antenna input range outside of the data file", []() {
+            std::string const fileName = "/tmp/1294797712_1294797720_118.sub";
+            writeSmallInputDataFile(fileName, 4, 50);
+            try{
+                readInputDataFile(fileName, AntennaInputRange{6, 8}, 8);
+                failTest();
+            }
+            catch(ReadInputDataException const& e){}
+            std::filesystem::remove(fileName);
+        }},
     };
 }
 
@@ -2,5 +2,11 @@
 
 #include "../TestHelper.hpp"
 
+#include <string>
+
 //unit test for the input file reader
-TestModule readInputFileTest();
\ No newline at end of file
+TestModule readInputFileTest();
+
+//writes a small signal file with the same layout as a real one, with nFineChan*2 antenna inputs and nSamples per block
+//sample values are made with the same formula as the large test file
+void writeSmallInputDataFile(std::string fileName, unsigned int nFineChan, unsigned int nSamples);
@@ -0,0 +1,177 @@
+#include "SampleConversionTest.hpp"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "SampleConversion.hpp"
+#include "TestHelper.hpp"
+
+
+static std::vector<std::int8_t> generateRawSamples(std::size_t numSamples) {
+    std::uniform_int_distribution<int> distribution{std::numeric_limits<std::int8_t>::min(),
+                                                    std::numeric_limits<std::int8_t>::max()};
+    std::vector<std::int8_t> samples(numSamples * 2);
+    for (auto& sample : samples) {
+        sample = static_cast<std::int8_t>(distribution(testRandomEngine));
+    }
+    return samples;
+}
+
+// Checks that converting with an instruction set gives exactly the expected values, and doesn't write anywhere other
+// than the strided output positions.
+static void testConversion(SampleConversionISA isa, float scale, bool conjugate) {
+    float const imagFactor = conjugate ? -scale : scale;
+    // Covers the vectorised loops, their remainders, and the scalar tail.
+    for (std::size_t numSamples : {0, 1, 3, 4, 7, 8, 15, 16, 31, 32, 33, 100, 64000}) {
+        for (std::size_t stride : {1, 2, 5}) {
+            auto const input = generateRawSamples(numSamples);
+            std::complex<float> const unwritten{12345.0f, -12345.0f};
+            std::vector<std::complex<float>> output(numSamples * stride + 1, unwritten);
+            if (scale == 1.0f && !conjugate) {
+                convertSamples(input.data(), numSamples, output.data(), stride, isa);
+            }
+            else {
+                convertSamples(input.data(), numSamples, output.data(), stride, scale, conjugate, isa);
+            }
+            for (std::size_t i = 0; i < output.size(); ++i) {
+                if (i % stride == 0 && i / stride < numSamples) {
+                    std::size_t const sample = i / stride;
+                    testAssert(output[i].real() == static_cast<float>(input[2 * sample]) * scale);
+                    testAssert(output[i].imag() == static_cast<float>(input[2 * sample + 1]) * imagFactor);
+                }
+                else {
+                    testAssert(output[i] == unwritten);
+                }
+            }
+        }
+    }
+}
+
+static void testConversion(SampleConversionISA isa) {
+    testConversion(isa, 1.0f, false);
+}
+
+// Conversion with each combination of scaling and conjugation.
+static void testScaledConversion(SampleConversionISA isa) {
+    testConversion(isa, 1.0f, true);
+    testConversion(isa, 2.0f, false);
+    testConversion(isa, 2.0f, true);
+}
+
+// Checks that converting to 16-bit integers with an instruction set clamps and truncates exactly as expected, and
+// doesn't write past the end of the output.
+static void testInt16Conversion(SampleConversionISA isa) {
+    std::uniform_real_distribution<float> distribution{-40000.0f, 40000.0f};
+    for (std::size_t numSamples : {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 100, 64000}) {
+        std::vector<float> input(numSamples);
+        for (auto& sample : input) {
+            sample = distribution(testRandomEngine);
+        }
+        std::int16_t const unwritten = 12345;
+        std::vector<std::int16_t> output(numSamples + 1, unwritten);
+        convertToInt16(input.data(), numSamples, output.data(), isa);
+        for (std::size_t i = 0; i < numSamples; ++i) {
+            std::int16_t expected;
+            if (input[i] > 32767.0f) {
+                expected = 32767;
+            }
+            else if (input[i] < -32768.0f) {
+                expected = -32768;
+            }
+            else {
+                expected = static_cast<std::int16_t>(input[i]);
+            }
+            testAssert(output[i] == expected);
+        }
+        testAssert(output[numSamples] == unwritten);
+    }
+
+    // Values on and either side of the limits, and fractions which must be truncated rather than rounded
+    std::vector<float> const input{32767.0f, 32767.9f, 32768.0f, 1e10f, -32768.0f, -32768.5f, -32769.0f, -1e10f,
+                                   0.0f, 0.9f, -0.9f, 1.5f, -1.5f, 2.5f, -2.5f, 100.99f};
+    std::vector<std::int16_t> const expected{32767, 32767, 32767, 32767, -32768, -32768, -32768, -32768,
+                                             0, 0, 0, 1, -1, 2, -2, 100};
+    std::vector<std::int16_t> output(input.size());
+    convertToInt16(input.data(), input.size(), output.data(), isa);
+    testAssert(output == expected);
+}
+
+
+class SampleConversionTest : public StatelessTestModuleImpl {
+public:
+    SampleConversionTest();
+};
+
+
+SampleConversionTest::SampleConversionTest() : StatelessTestModuleImpl{{
+    {"Scalar conversion", []() {
+        testConversion(SampleConversionISA::SCALAR);
+    }},
+    {"AVX2 conversion", []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX2)) {
+            testConversion(SampleConversionISA::AVX2);
+        }
+    }},
+    {"AVX-512 conversion", []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX512)) {
+            testConversion(SampleConversionISA::AVX512);
+        }
+    }},
+    {"Scalar conversion with scaling and conjugation", []() {
+        testScaledConversion(SampleConversionISA::SCALAR);
+    }},
+    {"AVX2 conversion with scaling and conjugation", []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX2)) {
+            testScaledConversion(SampleConversionISA::AVX2);
+        }
+    }},
+    {"AVX-512 conversion with scaling and conjugation", []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX512)) {
+            testScaledConversion(SampleConversionISA::AVX512);
+        }
+    }},
+    {"Scalar conversion to 16-bit integers", []() {
+        testInt16Conversion(SampleConversionISA::SCALAR);
+    }},
+    {"AVX2 conversion to 16-bit integers", []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX2)) {
+            testInt16Conversion(SampleConversionISA::AVX2);
+        }
+    }},
+    {"AVX-512 conversion to 16-bit integers", []() {
+        if (isSampleConversionISASupported(SampleConversionISA::AVX512)) {
+            testInt16Conversion(SampleConversionISA::AVX512);
+        }
+    }},
+    {"Default instruction set is supported", []() {
+        testAssert(isSampleConversionISASupported(getSampleConversionISA()));
+        testAssert(isSampleConversionISASupported(SampleConversionISA::SCALAR));
+    }},
+    {"Extreme values", []() {
+        std::vector<std::int8_t> const input{-128, 127, 0, -1};
+        std::vector<std::complex<float>> output(2);
+        convertSamples(input.data(), 2, output.data());
+        testAssert(output[0] == std::complex<float>(-128.0f, 127.0f));
+        testAssert(output[1] == std::complex<float>(0.0f, -1.0f));
+    }},
+    {"Extreme values with scaling and conjugation", []() {
+        std::vector<std::int8_t> const input{-128, 127, 0, -128};
+        std::vector<std::complex<float>> output(2);
+        convertSamples(input.data(), 2, output.data(), 1, 2.0f, true);
+        testAssert(output[0] == std::complex<float>(-256.0f, -254.0f));
+        testAssert(output[1] == std::complex<float>(0.0f, 256.0f));
+    }}
+}} {}
+
+
+TestModule sampleConversionTest() {
+    return {
+        "Raw signal sample conversion unit test",
+        []() { return std::make_unique<SampleConversionTest>(); }
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the raw signal sample conversion module (SampleConversion.hpp and SampleConversion.cpp).
+TestModule sampleConversionTest();
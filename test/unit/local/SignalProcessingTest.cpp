@@ -2,6 +2,8 @@
 
 #include<map>
 #include<vector>
+#include<utility>
+#include<random>
 #include<cstdint>
 #include<iostream>
 #include<limits>
@@ -10,6 +12,7 @@
 #include<mkl.h>
 #include<math.h>
 
+#include "../../src/AntennaInputSamples.hpp"
 #include "../../src/SignalProcessing.hpp"
 #include "../TestHelper.hpp"
 #include "../../src/ChannelRemapping.hpp"
@@ -27,12 +30,25 @@ void remapChannels(std::vector<std::vector<std::complex<float>>> const& signalDa
                    std::map<unsigned, ChannelRemapping::RemappedChannel> const& channelRemapping,
                    unsigned const outNumChannels);
 
+void remapChannels(AntennaInputSamples const& signalDataIn,
+                   std::vector<unsigned> const& signalDataInMapping,
+                   std::vector<std::complex<float>>& signalDataOut,
+                   std::map<unsigned, ChannelRemapping::RemappedChannel> const& channelRemapping,
+                   unsigned const outNumChannels);
+
 void performPFB(std::vector<std::complex<float>>& signalData,
                        std::vector<std::complex<float>> const& coefficantPFB,
                        std::map<unsigned, ChannelRemapping::RemappedChannel> const& mapping,
                        unsigned const numOfBlocks,
                        unsigned const numOfChannels);
 
+void performPFB(std::vector<std::complex<float>>& signalData,
+                std::vector<std::complex<float>> const& coefficantPFB,
+                std::map<unsigned, ChannelRemapping::RemappedChannel> const& mapping,
+                unsigned const numOfBlocks,
+                unsigned const numOfChannels,
+                PFBEngine const engine);
+
 void performDFT(std::vector<std::complex<float>>& signalData,
                 std::vector<float>& outData,
                 unsigned const samplingFreq,
@@ -69,6 +85,26 @@ std::vector<std::complex<float>> makeCoeArr(std::vector<std::vector<std::complex
 }
 
 
+// Helper function to generate random raw samples for a number of channels, as both raw samples and the equivalent
+// complex samples
+static void makeRawSignal(unsigned const numChannels, unsigned const numSamples, AntennaInputSamples& rawSignal,
+                          std::vector<std::vector<std::complex<float>>>& complexSignal) {
+    std::uniform_int_distribution<int> distribution{-128, 127};
+    for (unsigned channel = 0; channel < numChannels; ++channel) {
+        std::vector<std::int8_t> rawSamples(numSamples * 2);
+        for (auto& value : rawSamples) {
+            value = static_cast<std::int8_t>(distribution(testRandomEngine));
+        }
+        std::vector<std::complex<float>> complexSamples;
+        for (unsigned sample = 0; sample < numSamples; ++sample) {
+            complexSamples.emplace_back(rawSamples[2 * sample], rawSamples[2 * sample + 1]);
+        }
+        rawSignal.addChannel(std::move(rawSamples));
+        complexSignal.push_back(std::move(complexSamples));
+    }
+}
+
+
 // Function that checks if a floating point value is within a certain degree of freedom provided by our SRS
 // Will return true if the signal is accurate enough
 static constexpr bool CheckFloatingPointAccuracy(float known, float unknown) {
@@ -376,6 +412,346 @@ SignalProcessingTest::SignalProcessingTest() : StatelessTestModuleImpl{{
 
         testAssert(expected == signalOut);
     }},
+    {"processSignals() Raw samples give the same result as complex samples", []() {
+        unsigned const NUM_OF_BLOCKS = 64;
+        AntennaInputSamples rawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(4, NUM_OF_BLOCKS, rawSignal, complexSignal);
+        std::vector<unsigned> const signalDataMap{ 3, 4, 5, 6 };
+        ChannelRemapping const remappingData{12, {
+            {3, {3, false}},
+            {4, {2, true}},
+            {5, {1, false}},
+            {6, {0, true}}
+        }};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS * 4, { 0.5f, 0.0f });
+
+        std::vector<std::int16_t> expected{};
+        processSignal(complexSignal, signalDataMap, expected, coefficantArray, remappingData);
+        std::vector<std::int16_t> actual{};
+        processSignal(rawSignal, signalDataMap, actual, coefficantArray, remappingData);
+
+        testAssert(actual == expected);
+    }},
+    {"processSignals() Raw samples with different number of channels to mapping", []() {
+        AntennaInputSamples rawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(2, 8, rawSignal, complexSignal);
+        std::vector<unsigned> const signalDataMap{ 0, 1, 2 };
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}, {2, {2, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.0f });
+        std::vector<std::int16_t> signalDataOut{};
+
+        try {
+            processSignal(rawSignal, signalDataMap, signalDataOut, coefficantArray, remappingData);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"processSignals() Plan reused over several signals gives the same results as without a plan", []() {
+        unsigned const NUM_OF_BLOCKS = 64;
+        std::vector<unsigned> const signalDataMap{ 3, 4, 5, 6 };
+        ChannelRemapping const remappingData{12, {
+            {3, {3, false}},
+            {4, {2, true}},
+            {5, {1, false}},
+            {6, {0, true}}
+        }};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS * 4, { 0.5f, 0.0f });
+        ProcessingPlan plan{remappingData, coefficantArray, NUM_OF_BLOCKS};
+
+        for (unsigned ii = 0; ii < 3; ++ii) {
+            AntennaInputSamples rawSignal;
+            std::vector<std::vector<std::complex<float>>> complexSignal;
+            makeRawSignal(4, NUM_OF_BLOCKS, rawSignal, complexSignal);
+
+            std::vector<std::int16_t> expected{};
+            processSignal(complexSignal, signalDataMap, expected, coefficantArray, remappingData);
+            std::vector<std::int16_t> actualRaw{};
+            processSignal(rawSignal, signalDataMap, actualRaw, plan);
+            std::vector<std::int16_t> actualComplex{};
+            processSignal(complexSignal, signalDataMap, actualComplex, plan);
+
+            testAssert(actualRaw == expected);
+            testAssert(actualComplex == expected);
+        }
+    }},
+    {"processSignals() Plan with different number of blocks to the signal", []() {
+        AntennaInputSamples rawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(2, 8, rawSignal, complexSignal);
+        std::vector<unsigned> const signalDataMap{ 0, 1 };
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.0f });
+        ProcessingPlan plan{remappingData, coefficantArray, 16};
+        std::vector<std::int16_t> signalDataOut{};
+
+        try {
+            processSignal(rawSignal, signalDataMap, signalDataOut, plan);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+        try {
+            processSignal(complexSignal, signalDataMap, signalDataOut, plan);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"processSignalBatch() Gives the same results as processing each signal alone", []() {
+        unsigned const NUM_OF_BLOCKS = 64;
+        std::vector<unsigned> const signalDataMap{ 3, 4, 5, 6 };
+        ChannelRemapping const remappingData{12, {
+            {3, {3, false}},
+            {4, {2, true}},
+            {5, {1, false}},
+            {6, {0, true}}
+        }};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS * 4, { 0.5f, 0.0f });
+        ProcessingPlan batchPlan{remappingData, coefficantArray, NUM_OF_BLOCKS, 3};
+        ProcessingPlan plan{remappingData, coefficantArray, NUM_OF_BLOCKS};
+        testAssert(batchPlan.getBatchSize() == 3);
+        testAssert(plan.getBatchSize() == 1);
+
+        // Full batches and a smaller one, and single signals with the batch plan
+        for (unsigned batchSize : {3, 2, 3, 1}) {
+            std::vector<AntennaInputSamples> rawSignals(batchSize);
+            std::vector<AntennaInputSamples const*> batch;
+            for (auto& rawSignal : rawSignals) {
+                std::vector<std::vector<std::complex<float>>> complexSignal;
+                makeRawSignal(4, NUM_OF_BLOCKS, rawSignal, complexSignal);
+                batch.push_back(&rawSignal);
+            }
+
+            std::vector<std::vector<std::int16_t>> actual;
+            processSignalBatch(batch, signalDataMap, actual, batchPlan);
+
+            testAssert(actual.size() == batchSize);
+            for (unsigned ii = 0; ii < batchSize; ++ii) {
+                std::vector<std::int16_t> expected{};
+                processSignal(rawSignals[ii], signalDataMap, expected, plan);
+                testAssert(actual[ii] == expected);
+            }
+        }
+
+        // The batch plan can still process signals one at a time
+        AntennaInputSamples rawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(4, NUM_OF_BLOCKS, rawSignal, complexSignal);
+        std::vector<std::int16_t> expected{};
+        processSignal(rawSignal, signalDataMap, expected, plan);
+        std::vector<std::int16_t> actual{};
+        processSignal(rawSignal, signalDataMap, actual, batchPlan);
+        testAssert(actual == expected);
+    }},
+    {"processSignalBatch() Gives the same results as processing each signal alone with each PFB engine", []() {
+        unsigned const NUM_OF_BLOCKS = 512;
+        std::vector<unsigned> const signalDataMap{ 3, 4, 5, 6 };
+        ChannelRemapping const remappingData{12, {
+            {3, {3, false}},
+            {4, {2, true}},
+            {5, {1, false}},
+            {6, {0, true}}
+        }};
+        // Complex coefficients use the convolution engine, and real ones overlap-save once it's enabled
+        std::vector<std::complex<float>> const complexCoefficants(MWA_NUM_CHANNELS * 4, { 0.5f, 0.25f });
+        std::vector<std::complex<float>> const realCoefficants(MWA_NUM_CHANNELS * 4, { 0.5f, 0.0f });
+        for (auto const& [coefficantArray, engine] : {std::pair{complexCoefficants, PFBEngine::convolution},
+                                                      std::pair{realCoefficants, PFBEngine::overlapSave}}) {
+            bool const overlapSave = engine == PFBEngine::overlapSave;
+            ProcessingPlan batchPlan{remappingData, coefficantArray, NUM_OF_BLOCKS, 3, overlapSave};
+            ProcessingPlan plan{remappingData, coefficantArray, NUM_OF_BLOCKS, 1, overlapSave};
+            testAssert(batchPlan.getPFBEngine() == engine);
+
+            // A full batch and a smaller one
+            for (unsigned batchSize : {3, 2}) {
+                std::vector<AntennaInputSamples> rawSignals(batchSize);
+                std::vector<AntennaInputSamples const*> batch;
+                for (auto& rawSignal : rawSignals) {
+                    std::vector<std::vector<std::complex<float>>> complexSignal;
+                    makeRawSignal(4, NUM_OF_BLOCKS, rawSignal, complexSignal);
+                    batch.push_back(&rawSignal);
+                }
+
+                std::vector<std::vector<std::int16_t>> actual;
+                processSignalBatch(batch, signalDataMap, actual, batchPlan);
+
+                testAssert(actual.size() == batchSize);
+                for (unsigned ii = 0; ii < batchSize; ++ii) {
+                    std::vector<std::int16_t> expected{};
+                    processSignal(rawSignals[ii], signalDataMap, expected, plan);
+                    testAssert(actual[ii].size() == expected.size());
+                    // Transforming more channels at once may round differently
+                    for (std::size_t jj = 0; jj < expected.size(); ++jj) {
+                        testAssert(std::abs(actual[ii][jj] - expected[jj]) <= 1);
+                    }
+                }
+            }
+        }
+    }},
+    {"processSignalBatch() Inverse DFT over several tiles gives the same results as a single DFT", []() {
+        // 2048 floats per block of each of the 2 signals gives tiles of 16 blocks, so the batch is 6 full tiles and a
+        // shorter last one
+        unsigned const NUM_OF_BLOCKS = 100;
+        unsigned const SAMPLING_FREQ = 2048;
+        unsigned const NYQUIST_CHANNEL = (SAMPLING_FREQ / 2) + 1;
+        std::vector<unsigned> const signalDataMap{ 3, 4, 5, 6 };
+        ChannelRemapping const remappingData{SAMPLING_FREQ, {
+            {3, {300, false}},
+            {4, {401, true}},
+            {5, {502, false}},
+            {6, {603, true}}
+        }};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS * 4, { 0.5f, 0.0f });
+        ProcessingPlan plan{remappingData, coefficantArray, NUM_OF_BLOCKS, 2};
+        testAssert(plan.getTileBlocks() == 16);
+
+        std::vector<AntennaInputSamples> rawSignals(2);
+        std::vector<AntennaInputSamples const*> batch;
+        std::vector<std::vector<std::int16_t>> expected;
+        for (auto& rawSignal : rawSignals) {
+            std::vector<std::vector<std::complex<float>>> complexSignal;
+            makeRawSignal(4, NUM_OF_BLOCKS, rawSignal, complexSignal);
+            batch.push_back(&rawSignal);
+
+            std::vector<std::complex<float>> remappedData;
+            remapChannels(complexSignal, signalDataMap, remappedData, remappingData.channelMap, NYQUIST_CHANNEL);
+            performPFB(remappedData, coefficantArray, remappingData.channelMap, NUM_OF_BLOCKS, NYQUIST_CHANNEL);
+            std::vector<float> timeDomain;
+            performDFT(remappedData, timeDomain, SAMPLING_FREQ, NUM_OF_BLOCKS, NYQUIST_CHANNEL);
+            expected.emplace_back();
+            doPostProcessing(timeDomain, expected.back());
+        }
+
+        std::vector<std::vector<std::int16_t>> actual;
+        processSignalBatch(batch, signalDataMap, actual, plan);
+        testAssert(actual == expected);
+
+        // Each stage's output is measured for each signal
+        for (unsigned ii = 0; ii < 2; ++ii) {
+            auto const& measurements = plan.getStageMeasurements(ii);
+            auto const& remap = measurements.at(static_cast<std::size_t>(ProcessingStage::remap));
+            auto const& pfb = measurements.at(static_cast<std::size_t>(ProcessingStage::pfb));
+            auto const& dft = measurements.at(static_cast<std::size_t>(ProcessingStage::dft));
+            auto const& postProcessing = measurements.at(static_cast<std::size_t>(ProcessingStage::postProcessing));
+            testAssert(remap.samples == NYQUIST_CHANNEL * NUM_OF_BLOCKS);
+            testAssert(remap.bytes == NYQUIST_CHANNEL * NUM_OF_BLOCKS * 8);
+            testAssert(pfb.samples == NYQUIST_CHANNEL * NUM_OF_BLOCKS);
+            testAssert(dft.samples == SAMPLING_FREQ * NUM_OF_BLOCKS);
+            testAssert(dft.bytes == SAMPLING_FREQ * NUM_OF_BLOCKS * 4);
+            testAssert(postProcessing.samples == SAMPLING_FREQ * NUM_OF_BLOCKS);
+            testAssert(postProcessing.bytes == SAMPLING_FREQ * NUM_OF_BLOCKS * 2);
+            testAssert(dft.seconds > 0.0);
+            testAssert(measurements.at(static_cast<std::size_t>(ProcessingStage::read)) == StageMeasurement{});
+        }
+    }},
+    {"processSignalBatch() Invalid number of signals", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.0f });
+        std::vector<unsigned> const signalDataMap{ 0, 1 };
+        ProcessingPlan plan{remappingData, coefficantArray, 8, 2};
+        std::vector<AntennaInputSamples> rawSignals(3);
+        for (auto& rawSignal : rawSignals) {
+            std::vector<std::vector<std::complex<float>>> complexSignal;
+            makeRawSignal(2, 8, rawSignal, complexSignal);
+        }
+        std::vector<std::vector<std::int16_t>> signalDataOut;
+
+        try {
+            processSignalBatch({}, signalDataMap, signalDataOut, plan);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+        try {
+            processSignalBatch({&rawSignals[0], &rawSignals[1], &rawSignals[2]}, signalDataMap, signalDataOut, plan);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"processSignalBatch() Signal with different number of blocks to the plan", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.0f });
+        std::vector<unsigned> const signalDataMap{ 0, 1 };
+        ProcessingPlan plan{remappingData, coefficantArray, 8, 2};
+        AntennaInputSamples rawSignal;
+        AntennaInputSamples shortRawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(2, 8, rawSignal, complexSignal);
+        makeRawSignal(2, 4, shortRawSignal, complexSignal);
+        std::vector<std::vector<std::int16_t>> signalDataOut;
+
+        try {
+            processSignalBatch({&rawSignal, &shortRawSignal}, signalDataMap, signalDataOut, plan);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"ProcessingPlan() Batch size of 0", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.0f });
+
+        try {
+            ProcessingPlan plan{remappingData, coefficantArray, 8, 0};
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"ProcessingPlan() Invalid coefficant data, (More blocks than signal data)", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS * 4, { 1.0f, 0.0f });
+
+        try {
+            ProcessingPlan plan{remappingData, coefficantArray, 2};
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"ProcessingPlan() Flattened channel remapping", []() {
+        ChannelRemapping const remappingData{6, {{1, {0, false}}, {2, {3, true}}, {3, {1, true}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.0f });
+        ProcessingPlan const plan{remappingData, coefficantArray, 8};
+
+        testAssert(plan.getNumBlocks() == 8);
+        testAssert(plan.getSamplingFreq() == 6);
+        testAssert(plan.getNyquistChannel() == 4);
+        auto const& channels = plan.getChannels();
+        testAssert(channels.size() == 3);
+        // Remapped to channel 0, so scaled
+        testAssert(channels[0].oldChannel == 1 && channels[0].newChannel == 0 && !channels[0].flipped);
+        testAssert(channels[0].scale == 2.0f);
+        // Nyquist channel, so scaled
+        testAssert(channels[1].oldChannel == 2 && channels[1].newChannel == 3 && channels[1].flipped);
+        testAssert(channels[1].scale == 2.0f);
+        testAssert(channels[2].oldChannel == 3 && channels[2].newChannel == 1 && channels[2].flipped);
+        testAssert(channels[2].scale == 1.0f);
+    }},
+    {"remapChannels() Raw samples give the same result as complex samples (multiple tiles)", []() {
+        // Not a multiple of the vectorised conversion width, so includes the scalar remainder
+        unsigned const NUM_OF_BLOCKS = 10001;
+        AntennaInputSamples rawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(3, NUM_OF_BLOCKS, rawSignal, complexSignal);
+        std::vector<unsigned> const signalDataMap{ 1, 2, 3 };
+        std::map<unsigned, ChannelRemapping::RemappedChannel> const channelRemapping{
+            {1, {0, false}},
+            {2, {3, true}},
+            {3, {1, true}}
+        };
+
+        std::vector<std::complex<float>> expected{};
+        remapChannels(complexSignal, signalDataMap, expected, channelRemapping, 4);
+        std::vector<std::complex<float>> actual{};
+        remapChannels(rawSignal, signalDataMap, actual, channelRemapping, 4);
+
+        testAssert(actual == expected);
+    }},
     {"remapChannels() Channel remapping with mapping to value greater than nyquist channel", []() {
         std::vector<std::vector<std::complex<float>>> const signalDataIn(4, std::vector<std::complex<float>>(8, { 0.0f, 0.0f }));
         std::vector<unsigned> signalDataMap { 0, 1, 2, 3, 4 };
@@ -1006,6 +1382,162 @@ SignalProcessingTest::SignalProcessingTest() : StatelessTestModuleImpl{{
 
         testAssert( signalDataIn == expected );
     }},
+    {"performPFB() Channel FIR engine gives the same result as the convolution engine", []() {
+        unsigned const numOfBlocks = 5000;
+        unsigned const numOfChannels = 6;
+        unsigned const numOfTaps = 12;
+        std::uniform_real_distribution<float> distribution{-100.0f, 100.0f};
+        std::vector<std::complex<float>> signalData(numOfBlocks * numOfChannels);
+        for (auto& sample : signalData) {
+            sample = {distribution(testRandomEngine), distribution(testRandomEngine)};
+        }
+        std::vector<std::complex<float>> coefficantArray(MWA_NUM_CHANNELS * numOfTaps);
+        for (auto& coefficiant : coefficantArray) {
+            coefficiant = {distribution(testRandomEngine) / 100.0f, 0.0f};
+        }
+        // Channel 5 isn't remapped, so should be left as it is by both engines
+        std::map<unsigned, ChannelRemapping::RemappedChannel> const channelRemapping{
+            {10, {0, false}},
+            {11, {4, true}},
+            {40, {2, false}},
+            {100, {1, true}},
+            {255, {3, false}}
+        };
+
+        auto expected = signalData;
+        performPFB(expected, coefficantArray, channelRemapping, numOfBlocks, numOfChannels, PFBEngine::convolution);
+        auto actual = signalData;
+        performPFB(actual, coefficantArray, channelRemapping, numOfBlocks, numOfChannels, PFBEngine::channelFIR);
+
+        for (std::size_t ii = 0; ii < expected.size(); ++ii) {
+            testAssert(std::abs(actual[ii] - expected[ii]) <= 1e-3f * (1.0f + std::abs(expected[ii])));
+        }
+        for (unsigned block = 0; block < numOfBlocks; ++block) {
+            testAssert(actual[block * numOfChannels + 5] == signalData[block * numOfChannels + 5]);
+        }
+    }},
+    {"performPFB() Overlap-save engine gives the same result as the convolution engine", []() {
+        unsigned const numOfBlocks = 600;
+        unsigned const numOfChannels = 6;
+        unsigned const numOfTaps = 40;
+        std::uniform_real_distribution<float> distribution{-100.0f, 100.0f};
+        std::vector<std::complex<float>> signalData(numOfBlocks * numOfChannels);
+        for (auto& sample : signalData) {
+            sample = {distribution(testRandomEngine), distribution(testRandomEngine)};
+        }
+        // Complex coefficiants, which overlap-save handles as well
+        std::vector<std::complex<float>> coefficantArray(MWA_NUM_CHANNELS * numOfTaps);
+        for (auto& coefficiant : coefficantArray) {
+            coefficiant = {distribution(testRandomEngine) / 100.0f, distribution(testRandomEngine) / 100.0f};
+        }
+        // Channel 5 isn't remapped, so should be left as it is by both engines
+        std::map<unsigned, ChannelRemapping::RemappedChannel> const channelRemapping{
+            {10, {0, false}},
+            {11, {4, true}},
+            {40, {2, false}},
+            {100, {1, true}},
+            {255, {3, false}}
+        };
+
+        auto expected = signalData;
+        performPFB(expected, coefficantArray, channelRemapping, numOfBlocks, numOfChannels, PFBEngine::convolution);
+        auto actual = signalData;
+        performPFB(actual, coefficantArray, channelRemapping, numOfBlocks, numOfChannels, PFBEngine::overlapSave);
+
+        for (std::size_t ii = 0; ii < expected.size(); ++ii) {
+            testAssert(std::abs(actual[ii] - expected[ii]) <= 1e-2f * (1.0f + std::abs(expected[ii])));
+        }
+        for (unsigned block = 0; block < numOfBlocks; ++block) {
+            testAssert(std::abs(actual[block * numOfChannels + 5] - signalData[block * numOfChannels + 5]) <= 1e-2f);
+        }
+    }},
+    {"choosePFBEngine() Overlap-save when enabled", []() {
+        unsigned const segmentLength = chooseOverlapSaveSegmentLength(32);
+        testAssert(choosePFBEngine(32, segmentLength, true, true) == PFBEngine::overlapSave);
+        testAssert(choosePFBEngine(32, segmentLength, false, true) == PFBEngine::overlapSave);
+        testAssert(choosePFBEngine(8, 10240000, true, true) == PFBEngine::overlapSave);
+        // Signals shorter than a segment
+        testAssert(choosePFBEngine(32, segmentLength - 1, true, true) == PFBEngine::channelFIR);
+        testAssert(choosePFBEngine(32, segmentLength - 1, false, true) == PFBEngine::convolution);
+    }},
+    {"choosePFBEngine() Overlap-save only when enabled", []() {
+        testAssert(choosePFBEngine(128, 10240000, true, false) == PFBEngine::channelFIR);
+        testAssert(choosePFBEngine(128, 10240000, false, false) == PFBEngine::convolution);
+    }},
+    {"ProcessingPlan() Overlap-save when enabled", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS * 32, { 1.0f, 0.0f });
+        unsigned const numBlocks = chooseOverlapSaveSegmentLength(32);
+        testAssert((ProcessingPlan{remappingData, coefficantArray, numBlocks, 1, true}.getPFBEngine()
+                    == PFBEngine::overlapSave));
+        testAssert((ProcessingPlan{remappingData, coefficantArray, numBlocks - 2, 1, true}.getPFBEngine()
+                    == PFBEngine::channelFIR));
+        testAssert((ProcessingPlan{remappingData, coefficantArray, numBlocks}.getPFBEngine() == PFBEngine::channelFIR));
+    }},
+    {"estimateProcessingMemory()", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        // 4 remapped channels of complex floats and 6 16 bit output samples for each block
+        testAssert(estimateProcessingMemory(remappingData, 100) == 100 * (4 * 8 + 6 * 2));
+        testAssert(estimateProcessingMemory(remappingData, 0) == 0);
+    }},
+    {"performPFB() Channel FIR engine with complex coefficants", []() {
+        std::vector<std::complex<float>> signalData(8 * 4, { 1.0f, 0.0f });
+        std::vector<std::complex<float>> const coefficantArray(MWA_NUM_CHANNELS, { 1.0f, 0.5f });
+        std::map<unsigned, ChannelRemapping::RemappedChannel> const channelRemapping{{1, {1, false}}};
+
+        try {
+            performPFB(signalData, coefficantArray, channelRemapping, 8, 4, PFBEngine::channelFIR);
+            failTest();
+        } catch (std::invalid_argument& e) {
+            // Test passed
+        }
+    }},
+    {"ProcessingPlan() PFB engine depends on coefficants", []() {
+        ChannelRemapping const remappingData{6, {{0, {0, false}}, {1, {1, false}}}};
+        std::vector<std::complex<float>> coefficantArray(MWA_NUM_CHANNELS * 2, { 1.0f, 0.0f });
+        testAssert((ProcessingPlan{remappingData, coefficantArray, 8}.getPFBEngine() == PFBEngine::channelFIR));
+
+        // A complex coefficiant in a channel which isn't remapped makes no difference
+        coefficantArray[MWA_NUM_CHANNELS + 7] = { 1.0f, 1.0f };
+        testAssert((ProcessingPlan{remappingData, coefficantArray, 8}.getPFBEngine() == PFBEngine::channelFIR));
+
+        coefficantArray[MWA_NUM_CHANNELS + 1] = { 1.0f, 1.0f };
+        testAssert((ProcessingPlan{remappingData, coefficantArray, 8}.getPFBEngine() == PFBEngine::convolution));
+    }},
+    {"processSignals() Convolution engine plan gives the same results as channel FIR engine", []() {
+        unsigned const NUM_OF_BLOCKS = 64;
+        AntennaInputSamples rawSignal;
+        std::vector<std::vector<std::complex<float>>> complexSignal;
+        makeRawSignal(3, NUM_OF_BLOCKS, rawSignal, complexSignal);
+        std::vector<unsigned> const signalDataMap{ 3, 4, 5 };
+        ChannelRemapping const remappingData{8, {{3, {3, false}}, {4, {2, true}}, {5, {1, false}}}};
+        std::vector<std::complex<float>> realCoefficants(MWA_NUM_CHANNELS * 4, { 0.5f, 0.0f });
+        // Complex coefficiant for channel 0, which is silent so doesn't change the result
+        auto complexCoefficants = realCoefficants;
+        complexCoefficants[0] = { 0.5f, 0.5f };
+        ChannelRemapping const complexRemappingData{8, {
+            {0, {0, false}}, {3, {3, false}}, {4, {2, true}}, {5, {1, false}}
+        }};
+        std::vector<unsigned> const complexSignalDataMap{ 3, 4, 5, 0 };
+        // Silent channel 0
+        auto complexSignalWithZero = complexSignal;
+        complexSignalWithZero.emplace_back(NUM_OF_BLOCKS, std::complex<float>{ 0.0f, 0.0f });
+
+        ProcessingPlan realPlan{remappingData, realCoefficants, NUM_OF_BLOCKS};
+        ProcessingPlan complexPlan{complexRemappingData, complexCoefficants, NUM_OF_BLOCKS};
+        testAssert(realPlan.getPFBEngine() == PFBEngine::channelFIR);
+        testAssert(complexPlan.getPFBEngine() == PFBEngine::convolution);
+
+        std::vector<std::int16_t> expected{};
+        processSignal(complexSignalWithZero, complexSignalDataMap, expected, complexPlan);
+        std::vector<std::int16_t> actual{};
+        processSignal(complexSignal, signalDataMap, actual, realPlan);
+
+        testAssert(actual.size() == expected.size());
+        for (std::size_t ii = 0; ii < expected.size(); ++ii) {
+            testAssert(std::abs(actual[ii] - expected[ii]) <= 1);
+        }
+    }},
     {"performDFT() Three blocks of cosine waves", []() {
         unsigned const NUM_CHANNELS = 2;
         unsigned const NUM_BLOCKS = 3;
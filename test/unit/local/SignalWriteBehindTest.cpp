@@ -0,0 +1,176 @@
+#include "SignalWriteBehindTest.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Common.hpp"
+#include "SignalWriteBehind.hpp"
+#include "TestHelper.hpp"
+
+
+class SignalWriteBehindTest : public StatelessTestModuleImpl {
+public:
+    SignalWriteBehindTest();
+};
+
+
+SignalWriteBehindTest::SignalWriteBehindTest() : StatelessTestModuleImpl{{
+    {"Signals written in order", []() {
+        std::vector<unsigned> writtenIndices;
+        std::vector<std::int16_t> writtenSamples;
+        SignalWriteBehind writeBehind{[&](unsigned index, std::vector<std::int16_t> const& signal) {
+            writtenIndices.push_back(index);
+            writtenSamples.insert(writtenSamples.end(), signal.begin(), signal.end());
+            return true;
+        }, 2, 2};
+        for (unsigned index = 0; index < 10; index++) {
+            writeBehind.write({index, {static_cast<std::int16_t>(index), -1}, {100, 101}, {}});
+        }
+        auto const results = writeBehind.finish();
+
+        testAssert((writtenIndices == std::vector<unsigned>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+        testAssert(writtenSamples.size() == 20);
+        testAssert(writtenSamples[6] == 3 && writtenSamples[7] == -1);
+        testAssert(results.results.size() == 10);
+        for (auto const& [index, result] : results.results) {
+            testAssert(result.success);
+            testAssert((result.usedChannels == std::set<unsigned>{100, 101}));
+            auto const& write = result.stageMeasurements[static_cast<unsigned>(ProcessingStage::write)];
+            testAssert(write.bytes == 4);
+            testAssert(write.samples == 2);
+        }
+    }},
+    {"Failed writes", []() {
+        SignalWriteBehind writeBehind{[](unsigned index, std::vector<std::int16_t> const&) {
+            if (index == 2) {
+                throw std::runtime_error{"Write error"};
+            }
+            return index != 1;
+        }, 1, 1};
+        StageMeasurements measurements{};
+        measurements[static_cast<unsigned>(ProcessingStage::dft)] = {1.0, 8, 4};
+        for (unsigned index = 0; index < 3; index++) {
+            writeBehind.write({index, {1, 2}, {100}, measurements});
+        }
+        auto const results = writeBehind.finish();
+
+        testAssert(results.results.size() == 3);
+        testAssert(results.results.at(0).success);
+        testAssert(!results.results.at(1).success);
+        testAssert(!results.results.at(2).success);
+        // Stages before the failed write are still recorded, but not the write
+        auto const& failed = results.results.at(1).stageMeasurements;
+        testAssert(failed[static_cast<unsigned>(ProcessingStage::dft)].bytes == 8);
+        testAssert(failed[static_cast<unsigned>(ProcessingStage::write)].bytes == 0);
+    }},
+    {"Results only returned once", []() {
+        SignalWriteBehind writeBehind{[](unsigned, std::vector<std::int16_t> const&) { return true; }, 2, 2};
+        writeBehind.write({0, {1}, {}, {}});
+        testAssert(writeBehind.finish().results.size() == 1);
+        writeBehind.write({1, {1}, {}, {}});
+        writeBehind.write({2, {1}, {}, {}});
+        auto const results = writeBehind.finish();
+        testAssert(results.results.size() == 2);
+        testAssert(results.results.count(0) == 0);
+        testAssert(writeBehind.finish().results.empty());
+    }},
+    {"Queue depth limited", []() {
+        unsigned const queueDepth = 2;
+        std::atomic<unsigned> handedOff{0};
+        std::atomic<unsigned> written{0};
+        std::atomic<bool> failed{false};
+        SignalWriteBehind writeBehind{[&](unsigned, std::vector<std::int16_t> const&) {
+            // The signal being written and at most queueDepth waiting, so the next write() can't have returned yet
+            if (handedOff > written + queueDepth + 1) {
+                failed = true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+            ++written;
+            return true;
+        }, queueDepth, queueDepth};
+        for (unsigned index = 0; index < 20; index++) {
+            writeBehind.write({index, {1}, {}, {}});
+            ++handedOff;
+        }
+        writeBehind.finish();
+        testAssert(!failed);
+        testAssert(written == 20);
+    }},
+    {"Buffers reused", []() {
+        SignalWriteBehind* writeBehindPtr = nullptr;
+        std::vector<std::int16_t> buffer;
+        SignalWriteBehind writeBehind{[&](unsigned index, std::vector<std::int16_t> const&) {
+            // The buffer of the first signal is kept once it has been written, before the next is written
+            if (index == 1) {
+                buffer = writeBehindPtr->takeBuffer();
+            }
+            return true;
+        }, 2, 1};
+        writeBehindPtr = &writeBehind;
+        // No signals written yet
+        testAssert(writeBehind.takeBuffer().capacity() == 0);
+
+        std::vector<std::int16_t> signal(1000, 5);
+        auto const data = signal.data();
+        writeBehind.write({0, std::move(signal), {}, {}});
+        writeBehind.write({1, {1}, {}, {}});
+        writeBehind.finish();
+        testAssert(buffer.data() == data);
+        testAssert(buffer.capacity() >= 1000);
+        // The buffer of the second signal was released once all the signals were written
+        testAssert(writeBehind.takeBuffer().capacity() == 0);
+    }},
+    {"Kept buffers limited", []() {
+        SignalWriteBehind* writeBehindPtr = nullptr;
+        std::vector<std::size_t> capacities;
+        SignalWriteBehind writeBehind{[&](unsigned index, std::vector<std::int16_t> const&) {
+            // The buffers of all the earlier signals have been handed back by now
+            if (index == 3) {
+                for (unsigned i = 0; i < 3; i++) {
+                    capacities.push_back(writeBehindPtr->takeBuffer().capacity());
+                }
+            }
+            return true;
+        }, 4, 2};
+        writeBehindPtr = &writeBehind;
+        for (unsigned index = 0; index < 4; index++) {
+            writeBehind.write({index, std::vector<std::int16_t>(100, 1), {}, {}});
+        }
+        writeBehind.finish();
+
+        // Only two of the three buffers were kept, although more signals than that could wait to be written
+        testAssert(capacities.size() == 3);
+        testAssert(capacities[0] >= 100);
+        testAssert(capacities[1] >= 100);
+        testAssert(capacities[2] == 0);
+    }},
+    {"Destroyed with signals waiting", []() {
+        std::atomic<unsigned> written{0};
+        {
+            SignalWriteBehind writeBehind{[&](unsigned, std::vector<std::int16_t> const&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds{5});
+                ++written;
+                return true;
+            }, 4, 4};
+            for (unsigned index = 0; index < 4; index++) {
+                writeBehind.write({index, {1}, {}, {}});
+            }
+        }
+        // At most the signal being written when it was destroyed was written, the rest were discarded
+        testAssert(written < 4);
+    }}
+}} {}
+
+
+TestModule signalWriteBehindTest() {
+    return {
+        "Signal write-behind unit test",
+        []() { return std::make_unique<SignalWriteBehindTest>(); }
+    };
+}
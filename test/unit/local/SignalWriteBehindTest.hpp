@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the signal write-behind module (SignalWriteBehind.hpp and SignalWriteBehind.cpp).
+TestModule signalWriteBehindTest();
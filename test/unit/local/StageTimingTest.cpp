@@ -0,0 +1,119 @@
+#include "StageTimingTest.hpp"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "Common.hpp"
+#include "StageTiming.hpp"
+#include "TestHelper.hpp"
+
+
+// Makes processing results for an antenna input with only the given stage measured.
+static AntennaInputProcessingResults makeResults(unsigned node, ProcessingStage stage, double seconds,
+                                                 unsigned long long bytes, unsigned long long samples) {
+    AntennaInputProcessingResults results{true, {}, {}, node};
+    addStageMeasurement(results.stageMeasurements, stage, seconds, bytes, samples);
+    return results;
+}
+
+
+class StageTimingTest : public StatelessTestModuleImpl {
+public:
+    StageTimingTest();
+};
+
+
+StageTimingTest::StageTimingTest() : StatelessTestModuleImpl{{
+    {"StageTimer measures elapsed time", []() {
+        StageTimer const timer;
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        auto const first = timer.getElapsedSeconds();
+        testAssert(first >= 0.02);
+        testAssert(timer.getElapsedSeconds() >= first);
+    }},
+    {"addStageMeasurement() accumulates", []() {
+        StageMeasurements measurements{};
+        addStageMeasurement(measurements, ProcessingStage::pfb, 1.5, 100, 10);
+        addStageMeasurement(measurements, ProcessingStage::pfb, 0.5, 50, 5);
+        auto const& pfb = measurements.at(static_cast<std::size_t>(ProcessingStage::pfb));
+        testAssert(pfb.seconds == 2.0);
+        testAssert(pfb.bytes == 150);
+        testAssert(pfb.samples == 15);
+        testAssert(measurements.at(static_cast<std::size_t>(ProcessingStage::read)) == StageMeasurement{});
+    }},
+    {"summariseStage() Odd number of antenna inputs", []() {
+        ObservationProcessingResults const results{{
+            {0, makeResults(0, ProcessingStage::dft, 3.0, 300, 30)},
+            {1, makeResults(0, ProcessingStage::dft, 1.0, 100, 10)},
+            {2, makeResults(1, ProcessingStage::dft, 2.0, 200, 20)}
+        }};
+        auto const summary = summariseStage(results, ProcessingStage::dft);
+        testAssert(summary.numAntennaInputs == 3);
+        testAssert(summary.totalSeconds == 6.0);
+        testAssert(summary.minSeconds == 1.0);
+        testAssert(summary.medianSeconds == 2.0);
+        testAssert(summary.maxSeconds == 3.0);
+        testAssert(summary.totalBytes == 600);
+        testAssert(summary.totalSamples == 60);
+        testAssert(getBytesPerSecond(summary) == 100.0);
+        testAssert(getSamplesPerSecond(summary) == 10.0);
+    }},
+    {"summariseStage() Even number of antenna inputs", []() {
+        ObservationProcessingResults const results{{
+            {0, makeResults(0, ProcessingStage::write, 4.0, 1, 1)},
+            {1, makeResults(0, ProcessingStage::write, 1.0, 1, 1)},
+            {2, makeResults(0, ProcessingStage::write, 2.0, 1, 1)},
+            {3, makeResults(0, ProcessingStage::write, 8.0, 1, 1)}
+        }};
+        auto const summary = summariseStage(results, ProcessingStage::write);
+        testAssert(summary.numAntennaInputs == 4);
+        testAssert(summary.medianSeconds == 3.0);
+    }},
+    {"summariseStage() Single node", []() {
+        ObservationProcessingResults const results{{
+            {0, makeResults(0, ProcessingStage::read, 3.0, 300, 30)},
+            {1, makeResults(2, ProcessingStage::read, 1.0, 100, 10)},
+            {2, makeResults(2, ProcessingStage::read, 2.0, 200, 20)}
+        }};
+        auto const summary = summariseStage(results, ProcessingStage::read, 2);
+        testAssert(summary.numAntennaInputs == 2);
+        testAssert(summary.totalSeconds == 3.0);
+        testAssert(summary.medianSeconds == 1.5);
+        testAssert(summary.totalBytes == 300);
+        testAssert(summariseStage(results, ProcessingStage::read, 1).numAntennaInputs == 0);
+    }},
+    {"summariseStage() Antenna inputs not reaching the stage are left out", []() {
+        ObservationProcessingResults const results{{
+            {0, makeResults(0, ProcessingStage::remap, 3.0, 300, 30)},
+            {1, {false, {}}},
+            {2, makeResults(0, ProcessingStage::read, 1.0, 100, 10)}
+        }};
+        auto const summary = summariseStage(results, ProcessingStage::remap);
+        testAssert(summary.numAntennaInputs == 1);
+        testAssert(summary.minSeconds == 3.0);
+        testAssert(summary.maxSeconds == 3.0);
+
+        auto const empty = summariseStage(results, ProcessingStage::write);
+        testAssert(empty.numAntennaInputs == 0);
+        testAssert(empty.totalSeconds == 0.0);
+        testAssert(getBytesPerSecond(empty) == 0.0);
+        testAssert(getSamplesPerSecond(empty) == 0.0);
+    }},
+    {"getStageName() Every stage has a name", []() {
+        testAssert(getStageName(ProcessingStage::read) == "Read");
+        testAssert(getStageName(ProcessingStage::remap) == "Remap");
+        testAssert(getStageName(ProcessingStage::pfb) == "Inverse PFB");
+        testAssert(getStageName(ProcessingStage::dft) == "Inverse DFT");
+        testAssert(getStageName(ProcessingStage::postProcessing) == "Post-processing");
+        testAssert(getStageName(ProcessingStage::write) == "Write");
+    }}
+}} {}
+
+
+TestModule stageTimingTest() {
+    return {
+        "Processing stage timing unit test",
+        []() { return std::make_unique<StageTimingTest>(); }
+    };
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "TestHelper.hpp"
+
+
+// Unit test for the processing stage timing module (StageTiming.hpp and StageTiming.cpp).
+TestModule stageTimingTest();
@@ -0,0 +1,116 @@
+#include "SubfileIndexTest.hpp"
+
+#include "ReadInputFileTest.hpp"
+#include "../../src/ReadInputFile.hpp"
+#include "../../src/SubfileIndex.hpp"
+#include "../TestHelper.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+
+static std::string const TEST_FILE_NAME = "/tmp/1294797712_1294797729_118.sub";
+static std::string const TRUNCATED_TEST_FILE_NAME = "/tmp/1294797712_1294797730_118.sub";
+static std::string const MISSING_TEST_FILE_NAME = "/tmp/1294797712_1294797731_118.sub";
+
+
+class SubfileIndexTest : public StatelessTestModuleImpl {
+public:
+    SubfileIndexTest();
+    ~SubfileIndexTest();
+};
+
+
+SubfileIndexTest::SubfileIndexTest() : StatelessTestModuleImpl{{
+    {"Header fields", []() {
+        SubfileIndex const index{TEST_FILE_NAME};
+        testAssert(index.getHeaderSize() == 4096);
+        testAssert(index.getNumSamples() == 30);
+        testAssert(index.getNumInputs() == 4);
+        testAssert(index.getNumPolarisations() == 2);
+        testAssert(index.getNumAntennaInputs() == 8);
+        testAssert(index.getNumBlocks() == 160);
+        testAssert(index.getFileSize() == std::filesystem::file_size(TEST_FILE_NAME));
+    }},
+    {"Offsets", []() {
+        SubfileIndex const index{TEST_FILE_NAME};
+        // Header, then one delay block of 8 inputs * 60 bytes.
+        testAssert(index.getOffset(0, 0) == 4096 + 480);
+        testAssert(index.getOffset(0, 1) == 4096 + 480 + 60);
+        testAssert(index.getOffset(1, 0) == 4096 + 2 * 480);
+        testAssert(index.getOffset(159, 7) == 4096 + 160 * 480 + 7 * 60);
+    }},
+    {"Out of range offset", []() {
+        SubfileIndex const index{TEST_FILE_NAME};
+        try {
+            index.getOffset(160, 0);
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+        try {
+            index.getOffset(0, 8);
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+    }},
+    {"Validation", []() {
+        SubfileIndex const index{TEST_FILE_NAME};
+        testAssert(index.isValid(8));
+        testAssert(!index.isValid(6));
+        SubfileIndex const truncatedIndex{TRUNCATED_TEST_FILE_NAME};
+        testAssert(!truncatedIndex.isValid(8));
+    }},
+    {"File doesn't exist", []() {
+        try {
+            SubfileIndex const index{MISSING_TEST_FILE_NAME};
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+    }},
+    {"Cache shares one index per file", []() {
+        clearSubfileIndexCache();
+        auto const index = getSubfileIndex(TEST_FILE_NAME);
+        testAssert(getSubfileIndex(TEST_FILE_NAME) == index);
+        testAssert(getSubfileIndex(TRUNCATED_TEST_FILE_NAME) != index);
+        clearSubfileIndexCache();
+        testAssert(getSubfileIndex(TEST_FILE_NAME) != index);
+    }},
+    {"Cache remembers unreadable files", []() {
+        clearSubfileIndexCache();
+        try {
+            getSubfileIndex(MISSING_TEST_FILE_NAME);
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+        // Still fails even once the file exists, since the file isn't looked at again.
+        writeSmallInputDataFile(MISSING_TEST_FILE_NAME, 4, 30);
+        try {
+            getSubfileIndex(MISSING_TEST_FILE_NAME);
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+        clearSubfileIndexCache();
+        testAssert(getSubfileIndex(MISSING_TEST_FILE_NAME)->isValid(8));
+    }}
+}} {
+    writeSmallInputDataFile(TEST_FILE_NAME, 4, 30);
+    writeSmallInputDataFile(TRUNCATED_TEST_FILE_NAME, 4, 30);
+    std::filesystem::resize_file(TRUNCATED_TEST_FILE_NAME, std::filesystem::file_size(TRUNCATED_TEST_FILE_NAME) - 1);
+}
+
+SubfileIndexTest::~SubfileIndexTest() {
+    std::filesystem::remove(TEST_FILE_NAME);
+    std::filesystem::remove(TRUNCATED_TEST_FILE_NAME);
+    std::filesystem::remove(MISSING_TEST_FILE_NAME);
+    clearSubfileIndexCache();
+}
+
+
+TestModule subfileIndexTest() {
+    return {
+        "Signal file index unit test",
+        []() { return std::make_unique<SubfileIndexTest>(); }
+    };
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "../TestHelper.hpp"
+
+// Unit test for the signal file index and its cache (SubfileIndex.hpp and SubfileIndex.cpp).
+TestModule subfileIndexTest();
@@ -0,0 +1,124 @@
+#include "SubfileViewTest.hpp"
+
+#include "ReadInputFileTest.hpp"
+#include "../../src/ReadInputFile.hpp"
+#include "../../src/SubfileIndex.hpp"
+#include "../../src/SubfileView.hpp"
+#include "../TestHelper.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+
+static std::string const TEST_FILE_NAME = "/tmp/1294797712_1294797728_118.sub";
+static std::string const CHANGED_TEST_FILE_NAME = "/tmp/1294797712_1294797732_118.sub";
+
+
+class SubfileViewTest : public StatelessTestModuleImpl {
+public:
+    SubfileViewTest();
+    ~SubfileViewTest();
+};
+
+
+SubfileViewTest::SubfileViewTest() : StatelessTestModuleImpl{{
+    {"File dimensions", []() {
+        SubfileView const view{TEST_FILE_NAME, 8};
+        testAssert(view.getNumAntennaInputs() == 8);
+        testAssert(view.getNumSamples() == 30);
+        testAssert(view.getNumBlocks() == 160);
+    }},
+    {"Single antenna input samples", []() {
+        SubfileView const view{TEST_FILE_NAME, 8};
+        for (unsigned block = 0; block < 160; block += 53) {
+            for (unsigned antennaInput = 0; antennaInput < 8; ++antennaInput) {
+                auto const samples = view.getSamples(block, antennaInput);
+                testAssert(samples.size() == 60);
+                testAssert(samples.numSamples() == 30);
+                for (unsigned sample = 0; sample < 30; ++sample) {
+                    std::int8_t const expectedReal = 7 * block * antennaInput * sample - 8 * block;
+                    std::int8_t const expectedImag = block - antennaInput + 3 * sample;
+                    testAssert(samples[2 * sample] == expectedReal);
+                    testAssert(samples[2 * sample + 1] == expectedImag);
+                }
+            }
+        }
+    }},
+    {"Antenna input range samples are contiguous", []() {
+        SubfileView const view{TEST_FILE_NAME, 8};
+        auto const range = view.getSamples(17, AntennaInputRange{3, 6});
+        testAssert(range.size() == 4 * 60);
+        for (unsigned antennaInput = 3; antennaInput <= 6; ++antennaInput) {
+            auto const single = view.getSamples(17, antennaInput);
+            testAssert(single.data() == range.data() + (antennaInput - 3) * 60);
+        }
+        view.adviseWillNeed(18, AntennaInputRange{3, 6});
+        view.adviseDontNeed(17, AntennaInputRange{3, 6});
+        // Mapping is still readable after advising.
+        testAssert(range[0] == view.getSamples(17, 3)[0]);
+    }},
+    {"Out of range block or antenna input", []() {
+        SubfileView const view{TEST_FILE_NAME, 8};
+        try {
+            view.getSamples(160, 0);
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+        try {
+            view.getSamples(0, AntennaInputRange{7, 8});
+            failTest();
+        }
+        catch (std::out_of_range const&) {}
+    }},
+    {"Move keeps mapping", []() {
+        SubfileView view{TEST_FILE_NAME, 8};
+        auto const data = view.getSamples(5, 2).data();
+        SubfileView moved{std::move(view)};
+        testAssert(moved.getSamples(5, 2).data() == data);
+    }},
+    {"Mismatched number of antenna inputs", []() {
+        try {
+            SubfileView const view{TEST_FILE_NAME, 6};
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+    }},
+    {"File doesn't exist", []() {
+        try {
+            SubfileView const view{"/tmp/123456789", 8};
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+    }},
+    {"File rewritten after being indexed", []() {
+        SubfileView const view{CHANGED_TEST_FILE_NAME, 8};
+        // Same header, but longer than the cached index says.
+        writeSmallInputDataFile(CHANGED_TEST_FILE_NAME, 4, 31);
+        try {
+            SubfileView const changedView{CHANGED_TEST_FILE_NAME, 8};
+            failTest();
+        }
+        catch (ReadInputDataException const&) {}
+    }}
+}} {
+    writeSmallInputDataFile(TEST_FILE_NAME, 4, 30);
+    writeSmallInputDataFile(CHANGED_TEST_FILE_NAME, 4, 30);
+}
+
+SubfileViewTest::~SubfileViewTest() {
+    std::filesystem::remove(TEST_FILE_NAME);
+    std::filesystem::remove(CHANGED_TEST_FILE_NAME);
+    clearSubfileIndexCache();
+}
+
+
+TestModule subfileViewTest() {
+    return {
+        "Signal file view unit test",
+        []() { return std::make_unique<SubfileViewTest>(); }
+    };
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "../TestHelper.hpp"
+
+// Unit test for the memory mapped signal file view (SubfileView.hpp and SubfileView.cpp).
+TestModule subfileViewTest();
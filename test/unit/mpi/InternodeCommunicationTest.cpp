@@ -1,12 +1,21 @@
 #include "InternodeCommunicationTest.hpp"
 
 #include <chrono>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "ChannelRemapping.hpp"
 #include "Common.hpp"
@@ -70,11 +79,29 @@ InternodeCommunicationTest::InternodeCommunicationTest(PrimaryNodeCommunicator c
             1000000016,
             "/group/mwavcs/inversePolyphaseFilter.bin",
             "/group/mwavcs/myProcessedObservation",
+            true,
+            4096,
+            3,
+            RemappingMode::fftFriendly,
+            2,
+            2,
+            SchedulingMode::dynamic,
+            DecompositionMode::channel,
+            true,
+            OutputFormat::container,
+            true,
+            2,
+            OutputBackend::direct,
             true
         };
         communicator.sendAppConfig(appConfig);
     }},
 
+    {"sendFilterCoefficients()", [communicator]() {
+        std::vector<std::complex<float>> const coefficients{{1.5f, 0.0f}, {-2.25f, 0.0f}, {0.0f, 3.0f}, {4.0f, -1.0f}};
+        communicator.sendFilterCoefficients(coefficients);
+    }},
+
     {"sendAntennaInputAssignment()", [communicator]() {
         auto const nodeCount = communicator.getNodeCount();
         for (unsigned node = 1; node < nodeCount; ++node) {
@@ -108,6 +135,11 @@ InternodeCommunicationTest::InternodeCommunicationTest(PrimaryNodeCommunicator c
         communicator.sendChannelRemapping(channelRemapping);
     }},
 
+    {"sendOutputContainerStatus()", [communicator]() {
+        communicator.sendOutputContainerStatus(false);
+        communicator.sendOutputContainerStatus(true);
+    }},
+
     {"sendAntennaConfig()", [communicator]() {
         AntennaConfig const antennaConfig{
             {
@@ -132,7 +164,9 @@ InternodeCommunicationTest::InternodeCommunicationTest(PrimaryNodeCommunicator c
                 for (unsigned antennaInput = antennaInputBegin; antennaInput <= antennaInputEnd; ++antennaInput) {
                     AntennaInputProcessingResults antennaInputResults{
                         (node ^ antennaInput) % 3 == 2,
-                        {}
+                        {},
+                        {},
+                        node
                     };
                     if (node % 4 != 2) {
                         for (unsigned channel = 92; channel <= 120; ++channel) {
@@ -141,6 +175,13 @@ InternodeCommunicationTest::InternodeCommunicationTest(PrimaryNodeCommunicator c
                             }
                         }
                     }
+                    for (unsigned stage = 0; stage < NUM_PROCESSING_STAGES; ++stage) {
+                        antennaInputResults.stageMeasurements.at(stage) = {
+                            (node * 7 + antennaInput * 3 + stage) * 0.125,
+                            (node * antennaInput + stage) * 1000003ull,
+                            (node ^ antennaInput ^ stage) * 10007ull
+                        };
+                    }
                     nodeResults.results.emplace(antennaInput, std::move(antennaInputResults));
                 }
             }
@@ -149,6 +190,140 @@ InternodeCommunicationTest::InternodeCommunicationTest(PrimaryNodeCommunicator c
         testAssert(actual == expected);
     }},
 
+    {"exchangeData()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        auto const nodeCount = communicator.getNodeCount();
+        // Each node sends node + 1 bytes to each node, with a value identifying the sender and receiver
+        std::vector<std::int8_t> sendData;
+        std::vector<std::size_t> sendSizes;
+        std::vector<std::size_t> receiveSizes;
+        for (unsigned node = 0; node < nodeCount; ++node) {
+            sendData.insert(sendData.end(), node + 1, static_cast<std::int8_t>(nodeID * 8 + node));
+            sendSizes.push_back(node + 1);
+            receiveSizes.push_back(nodeID + 1);
+        }
+        auto const actual = communicator.exchangeData(sendData, sendSizes, receiveSizes);
+        std::vector<std::int8_t> expected;
+        for (unsigned node = 0; node < nodeCount; ++node) {
+            expected.insert(expected.end(), nodeID + 1, static_cast<std::int8_t>(node * 8 + nodeID));
+        }
+        testAssert(actual == expected);
+    }},
+
+    {"exchangeData() with wrong number of sizes", [communicator]() {
+        try {
+            communicator.exchangeData({}, {}, {});
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+
+    {"uniteChannels()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        auto const nodeCount = communicator.getNodeCount();
+        auto const actual = communicator.uniteChannels({100 + nodeID, 200});
+        std::set<unsigned> expected{200};
+        for (unsigned node = 0; node < nodeCount; ++node) {
+            expected.insert(100 + node);
+        }
+        testAssert(actual == expected);
+    }},
+    {"broadcastValues()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        auto const actual = communicator.broadcastValues({nodeID + 10ull, 7});
+        testAssert((actual == std::vector<unsigned long long>{10, 7}));
+    }},
+    {"getMinimum()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        testAssert(communicator.getMinimum(100 - nodeID) == 101 - communicator.getNodeCount());
+    }},
+    {"HostSharedCoefficients", [communicator]() {
+        std::vector<std::complex<float>> const coefficients{{1.5f, 0.0f}, {-2.25f, 0.0f}, {0.0f, 3.0f}};
+        HostSharedCoefficients const shared{communicator, coefficients};
+        testAssert(shared.getHostProcessCount() >= 1);
+        testAssert(std::vector<std::complex<float>>(shared.data(), shared.data() + shared.size()) == coefficients);
+    }},
+
+    {"CollectiveOutputFile", [communicator]() {
+        auto const nodeCount = communicator.getNodeCount();
+        std::string const path = "/tmp/mwatdr_collective_output_test.bin";
+        {
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        }
+        // Secondary nodes only open the file once they know it has been created
+        communicator.sendOutputContainerStatus(true);
+        {
+            CollectiveOutputFile const file{communicator, path};
+            // This node is the only one with a second piece of data
+            std::uint32_t const value = 0;
+            auto round = file.writeRound({{0, &value, sizeof(value)}}, false, false);
+            testAssert(!round.allFinished);
+            testAssert(!round.error);
+            testAssert(round.written == std::vector<bool>{true});
+            std::uint32_t const last = 0xFFFFFFFF;
+            round = file.writeRound({{4ull * nodeCount, &last, sizeof(last)}}, true, false);
+            testAssert(round.allFinished);
+            testAssert(round.written == std::vector<bool>{true});
+        }
+        // Each node wrote its ID at its own offset
+        std::ifstream file{path, std::ios::binary};
+        std::vector<std::uint32_t> actual(nodeCount + 1);
+        file.read(reinterpret_cast<char*>(actual.data()), actual.size() * sizeof(std::uint32_t));
+        testAssert(file.gcount() == static_cast<std::streamsize>(actual.size() * sizeof(std::uint32_t)));
+        for (unsigned node = 0; node < nodeCount; node++) {
+            testAssert(actual[node] == node);
+        }
+        testAssert(actual[nodeCount] == 0xFFFFFFFF);
+        std::remove(path.c_str());
+    }},
+    {"CollectiveOutputFile: Error on one node", [communicator]() {
+        std::string const path = "/tmp/mwatdr_collective_output_test.bin";
+        {
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        }
+        communicator.sendOutputContainerStatus(true);
+        {
+            CollectiveOutputFile const file{communicator, path};
+            std::uint32_t const value = 1;
+            auto const round = file.writeRound({{0, &value, sizeof(value)}}, true, true);
+            testAssert(round.error);
+            testAssert(round.written == std::vector<bool>{false});
+        }
+        // Nothing was written
+        testAssert(std::filesystem::file_size(path) == 0);
+        std::remove(path.c_str());
+    }},
+    {"CollectiveOutputFile: Nonexistent file", [communicator]() {
+        try {
+            CollectiveOutputFile const file{communicator, "/tmp/mwatdr_nonexistent/output.bin"};
+            failTest();
+        }
+        catch (std::runtime_error const&) {}
+    }},
+
+    {"AntennaInputDistributor: Every antenna input handed out once", [communicator]() {
+        auto const nodeCount = communicator.getNodeCount();
+        unsigned numAntennaInputs = 0;
+        {
+            AntennaInputDistributor distributor{communicator, AntennaInputScheduler{nodeCount, 16 * nodeCount, 2}};
+            while (auto const chunk = distributor.next()) {
+                testAssert(chunk->begin % 2 == 0);
+                testAssert(chunk->end == chunk->begin + 1);
+                numAntennaInputs += chunk->end - chunk->begin + 1;
+            }
+        }
+        // Each antenna input is only handed out once, so the total is right if none are missed
+        unsigned totalAntennaInputs = 0;
+        MPI_Reduce(&numAntennaInputs, &totalAntennaInputs, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_WORLD);
+        testAssert(totalAntennaInputs == 16 * nodeCount);
+    }},
+
+    {"AntennaInputDistributor: Stopping early", [communicator]() {
+        auto const nodeCount = communicator.getNodeCount();
+        AntennaInputDistributor distributor{communicator, AntennaInputScheduler{nodeCount, 16 * nodeCount, 2}};
+        testAssert((distributor.next() == AntennaInputRange{0, 1}));
+    }},
+
     {"Error communication - no error", [communicator]() {
         auto const nodeID = communicator.getNodeID();
         auto const iterations = 500000ul + (nodeID * 100000ul);
@@ -257,11 +432,30 @@ InternodeCommunicationTest::InternodeCommunicationTest(SecondaryNodeCommunicator
             1000000016,
             "/group/mwavcs/inversePolyphaseFilter.bin",
             "/group/mwavcs/myProcessedObservation",
+            true,
+            4096,
+            3,
+            RemappingMode::fftFriendly,
+            2,
+            2,
+            SchedulingMode::dynamic,
+            DecompositionMode::channel,
+            true,
+            OutputFormat::container,
+            true,
+            2,
+            OutputBackend::direct,
             true
         };
         testAssert(actual == expected);
     }},
 
+    {"receiveFilterCoefficients()", [communicator]() {
+        auto const actual = communicator.receiveFilterCoefficients();
+        std::vector<std::complex<float>> const expected{{1.5f, 0.0f}, {-2.25f, 0.0f}, {0.0f, 3.0f}, {4.0f, -1.0f}};
+        testAssert(actual == expected);
+    }},
+
     {"receiveAntennaInputAssignment()", [communicator]() {
         auto const nodeID = communicator.getNodeID();
         auto const actual = communicator.receiveAntennaInputAssignment();
@@ -287,6 +481,11 @@ InternodeCommunicationTest::InternodeCommunicationTest(SecondaryNodeCommunicator
         testAssert(actual == expected);
     }},
 
+    {"receiveOutputContainerStatus()", [communicator]() {
+        testAssert(!communicator.receiveOutputContainerStatus());
+        testAssert(communicator.receiveOutputContainerStatus());
+    }},
+
     {"receiveAntennaConfig()", [communicator]() {
         auto const actual = communicator.receiveAntennaConfig();
         AntennaConfig const expected{
@@ -318,12 +517,126 @@ InternodeCommunicationTest::InternodeCommunicationTest(SecondaryNodeCommunicator
                         }
                     }
                 }
+                for (unsigned stage = 0; stage < NUM_PROCESSING_STAGES; ++stage) {
+                    antennaInputResults.stageMeasurements.at(stage) = {
+                        (nodeID * 7 + antennaInput * 3 + stage) * 0.125,
+                        (nodeID * antennaInput + stage) * 1000003ull,
+                        (nodeID ^ antennaInput ^ stage) * 10007ull
+                    };
+                }
                 processingResults.results.emplace(antennaInput, std::move(antennaInputResults));
             }
         }
         communicator.sendProcessingResults(processingResults);
     }},
 
+    {"exchangeData()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        auto const nodeCount = communicator.getNodeCount();
+        // Each node sends node + 1 bytes to each node, with a value identifying the sender and receiver
+        std::vector<std::int8_t> sendData;
+        std::vector<std::size_t> sendSizes;
+        std::vector<std::size_t> receiveSizes;
+        for (unsigned node = 0; node < nodeCount; ++node) {
+            sendData.insert(sendData.end(), node + 1, static_cast<std::int8_t>(nodeID * 8 + node));
+            sendSizes.push_back(node + 1);
+            receiveSizes.push_back(nodeID + 1);
+        }
+        auto const actual = communicator.exchangeData(sendData, sendSizes, receiveSizes);
+        std::vector<std::int8_t> expected;
+        for (unsigned node = 0; node < nodeCount; ++node) {
+            expected.insert(expected.end(), nodeID + 1, static_cast<std::int8_t>(node * 8 + nodeID));
+        }
+        testAssert(actual == expected);
+    }},
+
+    {"exchangeData() with wrong number of sizes", [communicator]() {
+        try {
+            communicator.exchangeData({}, {}, {});
+            failTest();
+        }
+        catch (std::invalid_argument const&) {}
+    }},
+
+    {"uniteChannels()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        auto const nodeCount = communicator.getNodeCount();
+        auto const actual = communicator.uniteChannels({100 + nodeID, 200});
+        std::set<unsigned> expected{200};
+        for (unsigned node = 0; node < nodeCount; ++node) {
+            expected.insert(100 + node);
+        }
+        testAssert(actual == expected);
+    }},
+    {"broadcastValues()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        auto const actual = communicator.broadcastValues({nodeID + 10ull, 7});
+        testAssert((actual == std::vector<unsigned long long>{10, 7}));
+    }},
+    {"getMinimum()", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        testAssert(communicator.getMinimum(100 - nodeID) == 101 - communicator.getNodeCount());
+    }},
+    {"HostSharedCoefficients", [communicator]() {
+        // Only the primary node's coefficients are used
+        HostSharedCoefficients const shared{communicator, {{9.0f, 9.0f}}};
+        std::vector<std::complex<float>> const expected{{1.5f, 0.0f}, {-2.25f, 0.0f}, {0.0f, 3.0f}};
+        testAssert(shared.getHostProcessCount() >= 1);
+        testAssert(std::vector<std::complex<float>>(shared.data(), shared.data() + shared.size()) == expected);
+    }},
+
+    {"CollectiveOutputFile", [communicator]() {
+        auto const nodeID = communicator.getNodeID();
+        testAssert(communicator.receiveOutputContainerStatus());
+        CollectiveOutputFile const file{communicator, "/tmp/mwatdr_collective_output_test.bin"};
+        std::uint32_t const value = nodeID;
+        auto round = file.writeRound({{4ull * nodeID, &value, sizeof(value)}}, true, false);
+        testAssert(!round.allFinished);
+        testAssert(round.written == std::vector<bool>{true});
+        // Nothing left to write, but still takes part until every node has finished
+        round = file.writeRound({}, true, false);
+        testAssert(round.allFinished);
+        testAssert(round.written.empty());
+    }},
+    {"CollectiveOutputFile: Error on one node", [communicator]() {
+        testAssert(communicator.receiveOutputContainerStatus());
+        CollectiveOutputFile const file{communicator, "/tmp/mwatdr_collective_output_test.bin"};
+        std::uint32_t const value = 2;
+        auto const round = file.writeRound({{4, &value, sizeof(value)}}, true, false);
+        testAssert(round.error);
+        testAssert(round.written == std::vector<bool>{false});
+    }},
+    {"CollectiveOutputFile: Nonexistent file", [communicator]() {
+        try {
+            CollectiveOutputFile const file{communicator, "/tmp/mwatdr_nonexistent/output.bin"};
+            failTest();
+        }
+        catch (std::runtime_error const&) {}
+    }},
+
+    {"AntennaInputRequester: Every antenna input handed out once", [communicator]() {
+        unsigned numAntennaInputs = 0;
+        {
+            AntennaInputRequester requester{communicator};
+            while (auto const chunk = requester.next()) {
+                testAssert(chunk->begin % 2 == 0);
+                testAssert(chunk->end == chunk->begin + 1);
+                numAntennaInputs += chunk->end - chunk->begin + 1;
+            }
+            // Keeps returning nothing once the antenna inputs have run out
+            testAssert(!requester.next().has_value());
+        }
+        MPI_Reduce(&numAntennaInputs, nullptr, 1, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_WORLD);
+    }},
+
+    {"AntennaInputRequester: Stopping early", [communicator]() {
+        // Each node starts on its own antenna inputs, unless the primary node has already stopped handing them out
+        auto const nodeID = communicator.getNodeID();
+        AntennaInputRequester requester{communicator};
+        auto const chunk = requester.next();
+        testAssert(!chunk.has_value() || (chunk.value() == AntennaInputRange{16 * nodeID, 16 * nodeID + 1}));
+    }},
+
     {"Error communication - no error", [communicator]() {
         auto const nodeID = communicator.getNodeID();
         auto const iterations = 500000ul + (nodeID * 100000ul);